@@ -13,6 +13,28 @@ fn new_build() -> cc::Build {
 
 fn pixman() {
     let mut cfg = new_build();
+    cfg.include("pixman/pixman");
+    cfg.define("PIXMAN_NO_TLS", None);
+    cfg.define("PACKAGE", "pixman-1");
+
+    let target_arch = std::env::var("CARGO_CFG_TARGET_ARCH").unwrap();
+    if target_arch == "x86" || target_arch == "x86_64" {
+        // pixman-x86.c probes the CPU at runtime and only layers these
+        // implementations on top of the generic ones when supported.
+        // They provide the vectorized combiners (including the
+        // component-alpha ones used for subpixel text) and LCD filter.
+        cfg.define("USE_SSE2", None);
+        cfg.define("USE_SSSE3", None);
+        for (f, flag) in [("pixman-sse2.c", "-msse2"), ("pixman-ssse3.c", "-mssse3")] {
+            let mut simd = cfg.clone();
+            simd.file(&format!("pixman/pixman/{f}"));
+            simd.flag_if_supported(flag);
+            for obj in simd.compile_intermediates() {
+                cfg.object(obj);
+            }
+        }
+    }
+
     for f in [
         "pixman.c",
         "pixman-access.c",
@@ -21,6 +43,7 @@ fn pixman() {
         "pixman-combine32.c",
         "pixman-combine-float.c",
         "pixman-conical-gradient.c",
+        "pixman-blur.c",
         "pixman-filter.c",
         "pixman-x86.c",
         "pixman-mips.c",
@@ -48,10 +71,6 @@ fn pixman() {
         cfg.file(&format!("pixman/pixman/{f}"));
     }
 
-    cfg.include("pixman/pixman");
-    cfg.define("PIXMAN_NO_TLS", None);
-    cfg.define("PACKAGE", "pixman-1");
-
     cfg.compile("pixman");
 }
 
@@ -66,6 +85,7 @@ fn cairo() {
         //        --prefix=$PWD/i b
         // and then examining the ninja file:
         // grep ': c_COMPILER' b/build.ninja | awk '{print $4}' | sort
+        "src/cairo-aet-scan-converter.c",
         "src/cairo-analysis-surface.c",
         "src/cairo-arc.c",
         "src/cairo-array.c",
@@ -79,6 +99,7 @@ fn cairo() {
         "src/cairo-boxes-intersect.c",
         "src/cairo-boxes.c",
         "src/cairo-cache.c",
+        "src/cairo-cache-budget.c",
         "src/cairo-cff-subset.c",
         "src/cairo-clip-boxes.c",
         "src/cairo-clip-polygon.c",
@@ -104,6 +125,7 @@ fn cairo() {
         "src/cairo-font-options.c",
         "src/cairo-freed-pool.c",
         "src/cairo-freelist.c",
+        "src/cairo-glyph-run.c",
         "src/cairo-gstate.c",
         "src/cairo-hash.c",
         "src/cairo-hull.c",
@@ -166,6 +188,7 @@ fn cairo() {
         "src/cairo-surface.c",
         "src/cairo-tag-attributes.c",
         "src/cairo-tag-stack.c",
+        "src/cairo-tiled-surface.c",
         // "src/cairo-tee-surface.c", // doesn't compile in 1.17.8: https://gitlab.freedesktop.org/cairo/cairo/-/issues/646
         "src/cairo-time.c",
         "src/cairo-tor-scan-converter.c",
@@ -206,6 +229,34 @@ fn cairo() {
     cfg.define("HAVE_STDINT_H", Some("1"));
     cfg.define("HAVE_UINT64_T", Some("1"));
 
+    // Without an atomics backend cairo-atomic.c emulates every atomic
+    // operation with out of line calls around a global mutex.  GCC and
+    // clang provide the C11 __atomic builtins; MSVC builds use the
+    // Interlocked* backend that cairo selects for _WIN32 by itself.
+    if !cfg.get_compiler().is_like_msvc() {
+        let long_bytes = if std::env::var("CARGO_CFG_TARGET_OS").unwrap() == "windows" {
+            "4"
+        } else {
+            ptr_width_bytes.as_str()
+        };
+        cfg.define("HAVE_CXX11_ATOMIC_PRIMITIVES", Some("1"));
+        cfg.define("SIZEOF_VOID_P", Some(ptr_width_bytes.as_str()));
+        cfg.define("SIZEOF_INT", Some("4"));
+        cfg.define("SIZEOF_LONG", Some(long_bytes));
+        cfg.define("SIZEOF_LONG_LONG", Some("8"));
+    }
+
+    // PNG support uses the libpng and zlib that are built, and linked,
+    // by our freetype crate
+    if std::env::var("CARGO_FEATURE_PNG").is_ok() {
+        cfg.file("cairo/src/cairo-png.c");
+        cfg.define("CAIRO_HAS_PNG_FUNCTIONS", Some("1"));
+        let includes = std::env::var("DEP_FREETYPE_PNG_INCLUDE").unwrap();
+        for dir in includes.split(';') {
+            cfg.include(dir);
+        }
+    }
+
     cfg.compile("cairo");
 }
 
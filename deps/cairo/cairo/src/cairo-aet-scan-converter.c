@@ -0,0 +1,1411 @@
+/* -*- Mode: c; tab-width: 8; c-basic-offset: 4; indent-tabs-mode: t; -*- */
+/* cairo - a vector graphics library with display and print output
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it either under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ * (the "LGPL") or, at your option, under the terms of the Mozilla
+ * Public License Version 1.1 (the "MPL"). If you do not alter this
+ * notice, a recipient may use your version of this file under either
+ * the MPL or the LGPL.
+ *
+ * You should have received a copy of the LGPL along with this library
+ * in the file COPYING-LGPL-2.1; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335, USA
+ * You should have received a copy of the MPL along with this library
+ * in the file COPYING-MPL-1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY
+ * OF ANY KIND, either express or implied. See the LGPL or the MPL for
+ * the specific language governing rights and limitations.
+ *
+ * The Original Code is the cairo graphics library.
+ */
+
+/* An active edge table scan converter.
+ *
+ * This converter computes exactly the coverage the tor scan converter
+ * does: edges are sampled on GRID_Y subsample rows per pixel row,
+ * except across rows in which no edge starts, ends or crosses another
+ * one, whose coverage is computed analytically.  Where tor keeps its
+ * active edges and coverage cells in linked lists, this converter
+ * keeps them in arrays.  The active edges are a structure of arrays
+ * ordered by x, stepped to the next subsample row in a single pass,
+ * two edges at a time with SSE2, and put back in order by insertion
+ * since edges only swap places where they cross.  The coverage cells
+ * of a pixel row are arrays indexed by x, with a bitmap of the cells
+ * that have been touched.  This pays off for polygons with many
+ * active edges, for which tor spends most of its time walking lists.
+ */
+
+#include "cairoint.h"
+#include "cairo-spans-private.h"
+#include "cairo-error-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* The subsample grid, which is the one tor uses. */
+#define GRID_X_BITS CAIRO_FIXED_FRAC_BITS
+#define GRID_X (1 << GRID_X_BITS)
+#define GRID_Y 15
+
+/* Splits a grid scaled x coordinate into its floored pixel and the
+ * subsample within it. */
+#define GRID_X_TO_INT_FRAC(t, i, f) do {	\
+    (f) = (t) & (GRID_X - 1);			\
+    (i) = (t) >> GRID_X_BITS;			\
+} while (0)
+
+#define INPUT_TO_GRID_Y(in, out) do {				\
+    long long tmp__ = (long long) GRID_Y * (in);		\
+    tmp__ += 1 << (CAIRO_FIXED_FRAC_BITS - 1);			\
+    tmp__ >>= CAIRO_FIXED_FRAC_BITS;				\
+    (out) = tmp__;						\
+} while (0)
+
+/* Unit area on the grid. */
+#define GRID_XY (2*GRID_X*GRID_Y)
+
+#if GRID_XY == 2*256*15
+#  define GRID_AREA_TO_ALPHA(c)  (((c) + ((c)<<4) + 256) >> 9)
+#else
+#  define GRID_AREA_TO_ALPHA(c)  (((c)*255 + GRID_XY/2) / GRID_XY)
+#endif
+#define GRID_AREA_TO_A1(A)  ((GRID_AREA_TO_ALPHA (A) > 127) ? 255 : 0)
+
+/* The dy of vertical edges, chosen so that stepping them never
+ * carries into x and they round to the cell of their x. */
+#define VERTICAL INT64_MAX
+
+struct quorem {
+    int64_t quo;
+    int64_t rem;
+};
+
+/* A polygon edge as it was added, before it becomes active.  The
+ * remainders of x and of the steps are in [0, dy), so that stepping an
+ * edge only ever carries upwards. */
+struct edge {
+    int ytop;
+    int height_left;
+    int dir;
+    int cell;
+
+    struct quorem x;
+    struct quorem dxdy;
+    struct quorem dxdy_full;
+
+    /* Half the step to the next subsample row, rounded as tor rounds
+     * it, to step back from the sample location to the pixel origin
+     * when rendering a full row. */
+    struct quorem dxdy_half;
+
+    int64_t dy;
+};
+
+/* The vertically clipped edges of the polygon, by the pixel row they
+ * start in. */
+struct polygon {
+    /* The vertical clip extents, on the grid. */
+    int ymin, ymax;
+
+    struct edge *edges;
+    int num_edges;
+
+    /* The edges starting in pixel row i are sorted[rows[i]] up to
+     * sorted[rows[i+1]], in the order they were added. */
+    int *sorted;
+    int *rows;
+    int num_rows;
+
+    /* The edges becoming active on the current subsample row, and
+     * room to sort them. */
+    int *pending;
+    int *tmp;
+};
+
+/* The edges crossing the current subsample row, ordered by the cell
+ * their x rounds to.  Edges on the same cell are in the order tor
+ * would have them in, as that decides which of them bound spans. */
+struct active_list {
+    int64_t *x_quo, *x_rem;
+    int64_t *dxdy_quo, *dxdy_rem;
+    int64_t *full_quo, *full_rem;
+    int64_t *dy;
+    int32_t *cell;
+    int32_t *height_left;
+    int32_t *dir;
+    int32_t *edge;
+    int count;
+
+    /* A lower bound on the height of the active edges, or -1 once it
+     * needs to be recomputed, and whether they are all vertical.
+     * These are updated exactly as tor updates them, so that both
+     * converters pick the same rows to render analytically. */
+    int min_height;
+    int is_vertical;
+};
+
+/* A single active edge, while it is being moved. */
+struct active_edge {
+    int64_t x_quo, x_rem;
+    int64_t dxdy_quo, dxdy_rem;
+    int64_t full_quo, full_rem;
+    int64_t dy;
+    int32_t cell, height_left, dir, edge;
+};
+
+/* The coverage cells of the current pixel row, see struct cell in
+ * cairo-tor-scan-converter.c.  Only the cells inside the clip extents
+ * are kept; the cells to their left only contribute their covered
+ * height. */
+struct cell_list {
+    int xmin, xmax;
+
+    int16_t *uncovered_area;
+    int16_t *covered_height;
+
+    /* The cells added to since the row was started, and the range of
+     * words of the bitmap that have bits set. */
+    uint64_t *touched;
+    int first_word, last_word;
+
+    int16_t left_height;
+    cairo_bool_t is_empty;
+};
+
+/* A block of memory kept by the converter from one fill to the next. */
+struct buffer {
+    void *data;
+    size_t size, used, keep;
+};
+
+static cairo_status_t
+buffer_reserve (struct buffer *buffer, size_t size)
+{
+    buffer->used = size;
+    if (size <= buffer->size)
+	return CAIRO_STATUS_SUCCESS;
+
+    free (buffer->data);
+    buffer->data = _cairo_malloc (size);
+    if (unlikely (buffer->data == NULL)) {
+	buffer->size = buffer->used = 0;
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+    buffer->size = size;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/* Releases the block unless it is no larger than what recent fills
+ * needed, that amount decaying by a quarter with every smaller fill. */
+static void
+buffer_trim (struct buffer *buffer)
+{
+    buffer->keep -= buffer->keep / 4;
+    if (buffer->used > buffer->keep)
+	buffer->keep = buffer->used;
+
+    if (buffer->size > buffer->keep) {
+	free (buffer->data);
+	buffer->data = NULL;
+	buffer->size = 0;
+    }
+    buffer->used = 0;
+}
+
+static void
+buffer_fini (struct buffer *buffer)
+{
+    free (buffer->data);
+}
+
+static inline int
+ctz64 (uint64_t v)
+{
+#if __GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)
+    return __builtin_ctzll (v);
+#else
+    int n = 0;
+
+    while ((v & 1) == 0) {
+	v >>= 1;
+	n++;
+    }
+    return n;
+#endif
+}
+
+/* Adds to the coverage of the cell at pixel x.  The cell becomes part
+ * of the row even if nothing is added, as a cell allocated by tor
+ * would. */
+static inline void
+cell_add (struct cell_list *cells,
+	  int x,
+	  int covered_height,
+	  int uncovered_area)
+{
+    int word;
+
+    cells->is_empty = FALSE;
+
+    if (x < cells->xmin) {
+	cells->left_height += covered_height;
+	return;
+    }
+    if (x >= cells->xmax)
+	return;
+
+    x -= cells->xmin;
+    cells->covered_height[x] += covered_height;
+    cells->uncovered_area[x] += uncovered_area;
+
+    word = x >> 6;
+    cells->touched[word] |= (uint64_t) 1 << (x & 63);
+    if (word < cells->first_word)
+	cells->first_word = word;
+    if (word > cells->last_word)
+	cells->last_word = word;
+}
+
+/* Add a subpixel span covering [x1, x2) to the coverage cells. */
+static inline void
+cell_list_add_subspan (struct cell_list *cells,
+		       int x1,
+		       int x2)
+{
+    int ix1, fx1;
+    int ix2, fx2;
+
+    if (x1 == x2)
+	return;
+
+    GRID_X_TO_INT_FRAC(x1, ix1, fx1);
+    GRID_X_TO_INT_FRAC(x2, ix2, fx2);
+
+    if (ix1 != ix2) {
+	cell_add (cells, ix1, 1, 2*fx1);
+	cell_add (cells, ix2, -1, -2*fx2);
+    } else {
+	cell_add (cells, ix1, 0, 2*(fx1-fx2));
+    }
+}
+
+static void
+cell_list_reset (struct cell_list *cells)
+{
+    int width = cells->xmax - cells->xmin;
+    int num_words = (width + 63) / 64;
+
+    memset (cells->touched, 0, num_words * sizeof (uint64_t));
+    memset (cells->uncovered_area, 0, width * sizeof (int16_t));
+    memset (cells->covered_height, 0, width * sizeof (int16_t));
+
+    cells->first_word = num_words;
+    cells->last_word = -1;
+    cells->left_height = 0;
+    cells->is_empty = TRUE;
+}
+
+static inline void
+active_save (const struct active_list *active, int i, struct active_edge *e)
+{
+    e->x_quo = active->x_quo[i];
+    e->x_rem = active->x_rem[i];
+    e->dxdy_quo = active->dxdy_quo[i];
+    e->dxdy_rem = active->dxdy_rem[i];
+    e->full_quo = active->full_quo[i];
+    e->full_rem = active->full_rem[i];
+    e->dy = active->dy[i];
+    e->cell = active->cell[i];
+    e->height_left = active->height_left[i];
+    e->dir = active->dir[i];
+    e->edge = active->edge[i];
+}
+
+static inline void
+active_restore (struct active_list *active, int i, const struct active_edge *e)
+{
+    active->x_quo[i] = e->x_quo;
+    active->x_rem[i] = e->x_rem;
+    active->dxdy_quo[i] = e->dxdy_quo;
+    active->dxdy_rem[i] = e->dxdy_rem;
+    active->full_quo[i] = e->full_quo;
+    active->full_rem[i] = e->full_rem;
+    active->dy[i] = e->dy;
+    active->cell[i] = e->cell;
+    active->height_left[i] = e->height_left;
+    active->dir[i] = e->dir;
+    active->edge[i] = e->edge;
+}
+
+static inline void
+active_move (struct active_list *active, int dst, int src)
+{
+    active->x_quo[dst] = active->x_quo[src];
+    active->x_rem[dst] = active->x_rem[src];
+    active->dxdy_quo[dst] = active->dxdy_quo[src];
+    active->dxdy_rem[dst] = active->dxdy_rem[src];
+    active->full_quo[dst] = active->full_quo[src];
+    active->full_rem[dst] = active->full_rem[src];
+    active->dy[dst] = active->dy[src];
+    active->cell[dst] = active->cell[src];
+    active->height_left[dst] = active->height_left[src];
+    active->dir[dst] = active->dir[src];
+    active->edge[dst] = active->edge[src];
+}
+
+static inline void
+active_load (struct active_list *active, int i,
+	     const struct edge *edges, int edge)
+{
+    const struct edge *e = &edges[edge];
+
+    active->x_quo[i] = e->x.quo;
+    active->x_rem[i] = e->x.rem;
+    active->dxdy_quo[i] = e->dxdy.quo;
+    active->dxdy_rem[i] = e->dxdy.rem;
+    active->full_quo[i] = e->dxdy_full.quo;
+    active->full_rem[i] = e->dxdy_full.rem;
+    active->dy[i] = e->dy;
+    active->cell[i] = e->cell;
+    active->height_left[i] = e->height_left;
+    active->dir[i] = e->dir;
+    active->edge[i] = edge;
+}
+
+/* Merges the sorted runs a and b of edges into out, as
+ * merge_sorted_edges() in cairo-tor-scan-converter.c does, down to the
+ * order of edges on the same cell: the run being consumed carries on
+ * through the edges on the same cell as the head of the other one. */
+static void
+merge_edges (const struct edge *edges,
+	     const int *a, int num_a,
+	     const int *b, int num_b,
+	     int *out)
+{
+    cairo_bool_t in_a = edges[a[0]].cell <= edges[b[0]].cell;
+    int i = 0, j = 0, n = 0;
+
+    while (i < num_a && j < num_b) {
+	if (in_a) {
+	    int x = edges[b[j]].cell;
+	    while (i < num_a && edges[a[i]].cell <= x)
+		out[n++] = a[i++];
+	} else {
+	    int x = edges[a[i]].cell;
+	    while (j < num_b && edges[b[j]].cell <= x)
+		out[n++] = b[j++];
+	}
+	in_a = ! in_a;
+    }
+    while (i < num_a)
+	out[n++] = a[i++];
+    while (j < num_b)
+	out[n++] = b[j++];
+}
+
+/* Sorts the first 2^(level+1) edges by cell in the order sort_edges()
+ * in cairo-tor-scan-converter.c sorts them, returning how many have
+ * been sorted. */
+static int
+sort_edges (const struct edge *edges,
+	    int *list, int num_list,
+	    unsigned int level,
+	    int *tmp)
+{
+    unsigned int i;
+    int n;
+
+    if (num_list == 1)
+	return 1;
+
+    if (edges[list[0]].cell > edges[list[1]].cell) {
+	int t = list[0];
+	list[0] = list[1];
+	list[1] = t;
+    }
+
+    n = 2;
+    for (i = 0; i < level && n < num_list; i++) {
+	int m = sort_edges (edges, list + n, num_list - n, i, tmp);
+
+	merge_edges (edges, list, n, list + n, m, tmp);
+	n += m;
+	memcpy (list, tmp, n * sizeof (int));
+    }
+
+    return n;
+}
+
+/* Makes the pending edges active, placing them among the active edges
+ * as merge_unsorted_edges() in cairo-tor-scan-converter.c would. */
+static void
+active_list_insert (struct active_list *active,
+		    const struct edge *edges,
+		    int *pending,
+		    int num_pending,
+		    int *tmp)
+{
+    cairo_bool_t in_active;
+    int i, j;
+
+    sort_edges (edges, pending, num_pending, UINT_MAX, tmp);
+
+    /* Count the active edges going before each pending edge. */
+    in_active = active->count && active->cell[0] <= edges[pending[0]].cell;
+    i = j = 0;
+    while (j < num_pending) {
+	if (in_active) {
+	    int x = edges[pending[j]].cell;
+	    while (i < active->count && active->cell[i] <= x)
+		i++;
+	} else {
+	    int x = i < active->count ? active->cell[i] : INT_MAX;
+	    while (j < num_pending && edges[pending[j]].cell <= x)
+		tmp[j++] = i;
+	}
+	in_active = ! in_active;
+    }
+
+    /* And move the active edges out of their way from the back. */
+    i = active->count - 1;
+    for (j = num_pending - 1; j >= 0; j--) {
+	for (; i >= tmp[j]; i--)
+	    active_move (active, i + j + 1, i);
+	active_load (active, tmp[j] + j, edges, pending[j]);
+    }
+    active->count += num_pending;
+}
+
+/* Drops the edges that have ended. */
+static void
+active_list_compact (struct active_list *active)
+{
+    int i, n;
+
+    for (i = n = 0; i < active->count; i++) {
+	if (active->height_left[i] == 0)
+	    continue;
+
+	if (i != n)
+	    active_move (active, n, i);
+	n++;
+    }
+    active->count = n;
+}
+
+/* Drops the edges that have ended and puts the others back in order
+ * after they have been stepped. */
+static void
+active_list_sort (struct active_list *active)
+{
+    int i, n;
+
+    for (i = n = 0; i < active->count; i++) {
+	int j;
+
+	if (active->height_left[i] == 0)
+	    continue;
+
+	j = n++;
+	if (j > 0 && active->cell[j-1] > active->cell[i]) {
+	    struct active_edge e;
+
+	    active_save (active, i, &e);
+	    do {
+		active_move (active, j, j-1);
+	    } while (--j > 0 && active->cell[j-1] > e.cell);
+	    active_restore (active, j, &e);
+	} else if (i != j) {
+	    active_move (active, j, i);
+	}
+    }
+    active->count = n;
+}
+
+/* Advances all active edges to the next subsample row. */
+static void
+active_list_step (struct active_list *active)
+{
+    int64_t *x_quo = active->x_quo;
+    int64_t *x_rem = active->x_rem;
+    const int64_t *dxdy_quo = active->dxdy_quo;
+    const int64_t *dxdy_rem = active->dxdy_rem;
+    const int64_t *dy = active->dy;
+    int32_t *cell = active->cell;
+    int32_t *height_left = active->height_left;
+    int i = 0, n = active->count;
+
+#if defined(__SSE2__)
+    {
+	const __m128i one = _mm_set1_epi64x (1);
+	const __m128i zero = _mm_setzero_si128 ();
+
+	/* SSE2 has no 64-bit compares, but as the remainders and dy are
+	 * far from overflowing, r < dy is the sign bit of r - dy. */
+	for (; i + 2 <= n; i += 2) {
+	    __m128i d = _mm_loadu_si128 ((const __m128i *) (dy + i));
+	    __m128i q = _mm_loadu_si128 ((const __m128i *) (x_quo + i));
+	    __m128i r = _mm_loadu_si128 ((const __m128i *) (x_rem + i));
+	    __m128i below;
+
+	    q = _mm_add_epi64 (q, _mm_loadu_si128 ((const __m128i *) (dxdy_quo + i)));
+	    r = _mm_add_epi64 (r, _mm_loadu_si128 ((const __m128i *) (dxdy_rem + i)));
+
+	    r = _mm_sub_epi64 (r, d);
+	    below = _mm_srli_epi64 (r, 63);
+	    r = _mm_add_epi64 (r, _mm_and_si128 (d, _mm_sub_epi64 (zero, below)));
+	    q = _mm_sub_epi64 (_mm_add_epi64 (q, one), below);
+	    _mm_storeu_si128 ((__m128i *) (x_quo + i), q);
+	    _mm_storeu_si128 ((__m128i *) (x_rem + i), r);
+
+	    below = _mm_srli_epi64 (_mm_sub_epi64 (r, _mm_srli_epi64 (d, 1)), 63);
+	    q = _mm_sub_epi64 (_mm_add_epi64 (q, one), below);
+	    _mm_storel_epi64 ((__m128i *) (cell + i),
+			      _mm_shuffle_epi32 (q, _MM_SHUFFLE (3, 1, 2, 0)));
+	}
+    }
+#endif
+
+    for (; i < n; i++) {
+	int64_t r = x_rem[i] + dxdy_rem[i];
+
+	x_quo[i] += dxdy_quo[i];
+	if (r >= dy[i]) {
+	    x_quo[i]++;
+	    r -= dy[i];
+	}
+	x_rem[i] = r;
+	cell[i] = x_quo[i] + (r >= dy[i] / 2);
+    }
+
+    for (i = 0; i < n; i++)
+	height_left[i]--;
+}
+
+static inline void
+full_step (struct active_list *active, int i)
+{
+    int64_t dy = active->dy[i];
+
+    active->x_quo[i] += active->full_quo[i];
+    active->x_rem[i] += active->full_rem[i];
+    if (active->x_rem[i] >= dy) {
+	active->x_quo[i]++;
+	active->x_rem[i] -= dy;
+    }
+
+    active->cell[i] = active->x_quo[i] + (active->x_rem[i] >= dy/2);
+}
+
+/* Adds the analytical coverage of an active edge crossing the current
+ * pixel row to the coverage cells and advances it to the following
+ * row, see cell_list_render_edge() in cairo-tor-scan-converter.c. */
+static void
+cell_list_render_edge (struct cell_list *cells,
+		       struct active_list *active,
+		       const struct edge *edges,
+		       int i,
+		       int sign)
+{
+    struct quorem x1, x2;
+    int64_t dy = active->dy[i];
+    int fx1, fx2;
+    int ix1, ix2;
+
+    x1.quo = active->x_quo[i];
+    x1.rem = active->x_rem[i];
+    full_step (active, i);
+    x2.quo = active->x_quo[i];
+    x2.rem = active->x_rem[i];
+
+    /* Step back from the sample location (half-subrow) to the pixel origin */
+    if (dy != VERTICAL) {
+	const struct quorem *half = &edges[active->edge[i]].dxdy_half;
+
+	x1.quo -= half->quo;
+	x1.rem -= half->rem;
+	if (x1.rem < 0) {
+	    --x1.quo;
+	    x1.rem += dy;
+	} else if (x1.rem >= dy) {
+	    ++x1.quo;
+	    x1.rem -= dy;
+	}
+
+	x2.quo -= half->quo;
+	x2.rem -= half->rem;
+	if (x2.rem < 0) {
+	    --x2.quo;
+	    x2.rem += dy;
+	} else if (x2.rem >= dy) {
+	    ++x2.quo;
+	    x2.rem -= dy;
+	}
+    }
+
+    GRID_X_TO_INT_FRAC(x1.quo, ix1, fx1);
+    GRID_X_TO_INT_FRAC(x2.quo, ix2, fx2);
+
+    /* Edge is entirely within a column? */
+    if (ix1 == ix2) {
+	cell_add (cells, ix1, sign*GRID_Y, sign*(fx1 + fx2)*GRID_Y);
+	return;
+    }
+
+    /* Orient the edge left-to-right. */
+    if (ix2 < ix1) {
+	struct quorem tx;
+	int t;
+
+	t = ix1;
+	ix1 = ix2;
+	ix2 = t;
+
+	t = fx1;
+	fx1 = fx2;
+	fx2 = t;
+
+	tx = x1;
+	x1 = x2;
+	x2 = tx;
+    }
+
+    /* Add coverage for all pixels [ix1,ix2] on this row crossed
+     * by the edge. */
+    {
+	struct quorem y;
+	int64_t tmp, dx;
+	int y_last;
+
+	dx = (x2.quo - x1.quo) * dy + (x2.rem - x1.rem);
+
+	tmp = (ix1 + 1) * GRID_X * dy;
+	tmp -= x1.quo * dy + x1.rem;
+	tmp *= GRID_Y;
+
+	y.quo = tmp / dx;
+	y.rem = tmp % dx;
+
+	cell_add (cells, ix1, sign*y.quo, sign*y.quo*(GRID_X + fx1));
+	y_last = y.quo;
+
+	if (ix1+1 < ix2) {
+	    struct quorem dydx_full;
+
+	    dydx_full.quo = GRID_Y * GRID_X * dy / dx;
+	    dydx_full.rem = GRID_Y * GRID_X * dy % dx;
+
+	    ++ix1;
+	    do {
+		y.quo += dydx_full.quo;
+		y.rem += dydx_full.rem;
+		if (y.rem >= dx) {
+		    y.quo++;
+		    y.rem -= dx;
+		}
+
+		cell_add (cells, ix1,
+			  sign*(y.quo - y_last),
+			  sign*(y.quo - y_last)*GRID_X);
+		y_last = y.quo;
+	    } while (++ix1 != ix2);
+	}
+
+	cell_add (cells, ix2,
+		  sign*(GRID_Y - y_last),
+		  sign*(GRID_Y - y_last)*fx2);
+    }
+}
+
+/* Test if the active edges can be safely advanced by a full row
+ * without intersections or any edges ending. */
+static cairo_bool_t
+can_do_full_row (struct active_list *active)
+{
+    int prev_x = INT_MIN;
+    int i;
+
+    if (active->min_height <= 0) {
+	int min_height = INT_MAX;
+	int is_vertical = 1;
+
+	for (i = 0; i < active->count; i++) {
+	    if (active->height_left[i] < min_height)
+		min_height = active->height_left[i];
+	    is_vertical &= active->dy[i] == VERTICAL;
+	}
+
+	active->is_vertical = is_vertical;
+	active->min_height = min_height;
+    }
+
+    if (active->min_height < GRID_Y)
+	return FALSE;
+
+    for (i = 0; i < active->count; i++) {
+	int64_t quo = active->x_quo[i] + active->full_quo[i];
+	int64_t rem = active->x_rem[i] + active->full_rem[i];
+	int64_t dy = active->dy[i];
+	int cell;
+
+	if (rem >= dy) {
+	    quo++;
+	    rem -= dy;
+	}
+	cell = quo + (rem >= dy/2);
+
+	if (cell < prev_x)
+	    return FALSE;
+	prev_x = cell;
+    }
+
+    return TRUE;
+}
+
+static void
+sub_row (struct active_list *active,
+	 struct cell_list *cells,
+	 unsigned int mask)
+{
+    const int32_t *cell = active->cell;
+    const int32_t *dir = active->dir;
+    int xstart = INT_MIN;
+    int winding = 0;
+    int i, n = active->count;
+
+    for (i = 0; i < n; i++) {
+	int xend = cell[i];
+
+	winding += dir[i];
+	if ((winding & mask) == 0) {
+	    if ((i + 1 < n ? cell[i+1] : INT_MAX) != xend) {
+		cell_list_add_subspan (cells, xstart, xend);
+		xstart = INT_MIN;
+	    }
+	} else if (xstart == INT_MIN)
+	    xstart = xend;
+    }
+
+    active_list_step (active);
+    active_list_sort (active);
+    if (active->count)
+	active->min_height = -1;
+}
+
+static void
+full_row (struct active_list *active,
+	  struct cell_list *cells,
+	  const struct edge *edges,
+	  unsigned int mask)
+{
+    int32_t *height_left = active->height_left;
+    const int32_t *cell = active->cell;
+    const int32_t *dir = active->dir;
+    int n = active->count;
+    cairo_bool_t ended = FALSE;
+    int left = 0;
+
+    while (left < n - 1) {
+	int right, winding;
+
+	ended |= (height_left[left] -= GRID_Y) == 0;
+
+	winding = dir[left];
+	right = left + 1;
+	while (right < n - 1) {
+	    ended |= (height_left[right] -= GRID_Y) == 0;
+
+	    winding += dir[right];
+	    if ((winding & mask) == 0 && cell[right+1] != cell[right])
+		break;
+
+	    full_step (active, right);
+	    right++;
+	}
+	if (right == n - 1)
+	    ended |= (height_left[right] -= GRID_Y) == 0;
+
+	cell_list_render_edge (cells, active, edges, left, +1);
+	cell_list_render_edge (cells, active, edges, right, -1);
+
+	left = right + 1;
+    }
+
+    if (ended) {
+	active_list_compact (active);
+	active->min_height = -1;
+    }
+}
+
+static void
+step_edges (struct active_list *active, int count)
+{
+    cairo_bool_t ended = FALSE;
+    int i;
+
+    count *= GRID_Y;
+    for (i = 0; i < active->count; i++)
+	ended |= (active->height_left[i] -= count) == 0;
+
+    if (ended) {
+	active_list_compact (active);
+	active->min_height = -1;
+    }
+}
+
+/* Forms the spans of a pixel row from its coverage cells, clearing
+ * them for the next row, see blit_a8() and blit_a1() in
+ * cairo-tor-scan-converter.c. */
+static cairo_status_t
+blit (struct cell_list *cells,
+      cairo_span_renderer_t *renderer,
+      cairo_half_open_span_t *spans,
+      int y, int height,
+      cairo_bool_t antialias)
+{
+    int xmin = cells->xmin, xmax = cells->xmax;
+    int prev_x = xmin, last_x = -1;
+    int16_t cover = 0, last_cover = 0;
+    unsigned num_spans = 0;
+    int word;
+
+    if (cells->is_empty)
+	return CAIRO_STATUS_SUCCESS;
+
+    cover = cells->left_height;
+    cover *= GRID_X*2;
+    cells->left_height = 0;
+    cells->is_empty = TRUE;
+
+    for (word = cells->first_word; word <= cells->last_word; word++) {
+	uint64_t bits = cells->touched[word];
+
+	cells->touched[word] = 0;
+	while (bits) {
+	    int i = word * 64 + ctz64 (bits);
+	    int x = xmin + i;
+	    int16_t area, c;
+
+	    bits &= bits - 1;
+
+	    c = antialias ? cover : GRID_AREA_TO_A1 (cover);
+	    if (x > prev_x && c != last_cover) {
+		spans[num_spans].x = prev_x;
+		spans[num_spans].coverage = antialias ? GRID_AREA_TO_ALPHA (cover) : c;
+		last_cover = c;
+		last_x = prev_x;
+		++num_spans;
+	    }
+
+	    cover += cells->covered_height[i]*GRID_X*2;
+	    area = cover - cells->uncovered_area[i];
+	    cells->covered_height[i] = 0;
+	    cells->uncovered_area[i] = 0;
+
+	    c = antialias ? area : GRID_AREA_TO_A1 (area);
+	    if (c != last_cover) {
+		spans[num_spans].x = x;
+		spans[num_spans].coverage = antialias ? GRID_AREA_TO_ALPHA (area) : c;
+		last_cover = c;
+		last_x = x;
+		++num_spans;
+	    }
+
+	    prev_x = x+1;
+	}
+    }
+    cells->first_word = (xmax - xmin + 63) / 64;
+    cells->last_word = -1;
+
+    {
+	int16_t c = antialias ? cover : GRID_AREA_TO_A1 (cover);
+	if (prev_x <= xmax && c != last_cover) {
+	    spans[num_spans].x = prev_x;
+	    spans[num_spans].coverage = antialias ? GRID_AREA_TO_ALPHA (cover) : c;
+	    last_cover = c;
+	    last_x = prev_x;
+	    ++num_spans;
+	}
+    }
+
+    if (last_x < xmax && last_cover) {
+	spans[num_spans].x = xmax;
+	spans[num_spans].coverage = 0;
+	++num_spans;
+    }
+
+    if (! antialias && num_spans == 1)
+	return CAIRO_STATUS_SUCCESS;
+
+    return renderer->render_rows (renderer, y, height, spans, num_spans);
+}
+
+typedef struct _cairo_aet_scan_converter {
+    cairo_scan_converter_t base;
+
+    struct polygon polygon[1];
+    struct active_list active[1];
+    struct cell_list cells[1];
+    cairo_half_open_span_t *spans;
+
+    /* The memory for the edges, the rows and the cells respectively,
+     * kept between fills. */
+    struct buffer edge_buffer;
+    struct buffer row_buffer;
+    struct buffer cell_buffer;
+
+    cairo_fill_rule_t fill_rule;
+    cairo_antialias_t antialias;
+} cairo_aet_scan_converter_t;
+
+static cairo_status_t
+_aet_scan_converter_render (cairo_aet_scan_converter_t *self,
+			    cairo_span_renderer_t *renderer)
+{
+    struct polygon *polygon = self->polygon;
+    struct active_list *active = self->active;
+    struct cell_list *cells = self->cells;
+    unsigned int mask = self->fill_rule == CAIRO_FILL_RULE_WINDING ? ~0 : 1;
+    cairo_bool_t antialias = self->antialias != CAIRO_ANTIALIAS_NONE;
+    int ymin_i = polygon->ymin / GRID_Y;
+    int h = polygon->num_rows;
+    int i, j;
+
+    if (cells->xmin >= cells->xmax)
+	return CAIRO_STATUS_SUCCESS;
+
+    /* Render each pixel row. */
+    for (i = 0; i < h; i = j) {
+	const int *row = polygon->sorted + polygon->rows[i];
+	int num_row = polygon->rows[i+1] - polygon->rows[i];
+	int y = (i + ymin_i) * GRID_Y;
+	cairo_bool_t do_full_row = FALSE;
+	cairo_status_t status;
+	int max_suby = 0;
+	int k;
+
+	j = i + 1;
+
+	for (k = 0; k < num_row; k++) {
+	    const struct edge *e = &polygon->edges[row[k]];
+
+	    if (e->ytop - y > max_suby)
+		max_suby = e->ytop - y;
+	    if (e->height_left < active->min_height)
+		active->min_height = e->height_left;
+	    active->is_vertical &= e->dy == VERTICAL;
+	}
+
+	/* Determine if we can ignore this row or use the full pixel
+	 * stepper. */
+	if (max_suby == 0) {
+	    if (num_row) {
+		memcpy (polygon->pending, row, num_row * sizeof (int));
+		active_list_insert (active, polygon->edges,
+				    polygon->pending, num_row,
+				    polygon->tmp);
+	    }
+
+	    if (active->count == 0) {
+		active->min_height = INT_MAX;
+		active->is_vertical = 1;
+		for (; j < h && polygon->rows[j] == polygon->rows[j+1]; j++)
+		    ;
+		continue;
+	    }
+
+	    do_full_row = can_do_full_row (active);
+	}
+
+	if (do_full_row) {
+	    /* Step by a full pixel row's worth. */
+	    full_row (active, cells, polygon->edges, mask);
+
+	    if (active->is_vertical) {
+		while (j < h &&
+		       polygon->rows[j] == polygon->rows[j+1] &&
+		       active->min_height >= 2*GRID_Y)
+		{
+		    active->min_height -= GRID_Y;
+		    j++;
+		}
+		if (j != i + 1)
+		    step_edges (active, j - (i + 1));
+	    }
+	} else {
+	    int sub;
+
+	    /* Subsample this row. */
+	    for (sub = 0; sub < GRID_Y; sub++) {
+		if (max_suby) {
+		    int num_pending = 0;
+
+		    for (k = 0; k < num_row; k++) {
+			if (polygon->edges[row[k]].ytop - y == sub)
+			    polygon->pending[num_pending++] = row[k];
+		    }
+		    if (num_pending)
+			active_list_insert (active, polygon->edges,
+					    polygon->pending, num_pending,
+					    polygon->tmp);
+		}
+
+		sub_row (active, cells, mask);
+	    }
+	}
+
+	status = blit (cells, renderer, self->spans,
+		       i+ymin_i, j-i, antialias);
+	if (unlikely (status))
+	    return status;
+
+	active->min_height -= GRID_Y;
+    }
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static int
+int_to_grid_scaled (int i, int scale)
+{
+    /* Clamp to max/min representable scaled number. */
+    if (i >= 0) {
+	if (i >= INT_MAX/scale)
+	    i = INT_MAX/scale;
+    }
+    else {
+	if (i <= INT_MIN/scale)
+	    i = INT_MIN/scale;
+    }
+    return i*scale;
+}
+
+static cairo_status_t
+_aet_scan_converter_reset (cairo_aet_scan_converter_t *self,
+			   int xmin, int ymin,
+			   int xmax, int ymax)
+{
+    struct polygon *polygon = self->polygon;
+    struct cell_list *cells = self->cells;
+    cairo_status_t status;
+    int width, num_words;
+    char *ptr;
+
+    polygon->ymin = int_to_grid_scaled (ymin, GRID_Y);
+    polygon->ymax = int_to_grid_scaled (ymax, GRID_Y);
+    polygon->num_rows = MAX (polygon->ymax / GRID_Y - polygon->ymin / GRID_Y, 0);
+    polygon->num_edges = 0;
+
+    status = buffer_reserve (&self->row_buffer,
+			     (polygon->num_rows + 1) * sizeof (int));
+    if (unlikely (status))
+	return status;
+
+    polygon->rows = self->row_buffer.data;
+    memset (polygon->rows, 0, (polygon->num_rows + 1) * sizeof (int));
+
+    cells->xmin = int_to_grid_scaled (xmin, GRID_X) / GRID_X;
+    cells->xmax = int_to_grid_scaled (xmax, GRID_X) / GRID_X;
+    width = MAX (cells->xmax - cells->xmin, 0);
+    num_words = (width + 63) / 64;
+
+    status = buffer_reserve (&self->cell_buffer,
+			     num_words * sizeof (uint64_t) +
+			     (width + 1) * sizeof (cairo_half_open_span_t) +
+			     2 * width * sizeof (int16_t));
+    if (unlikely (status))
+	return status;
+
+    ptr = self->cell_buffer.data;
+    cells->touched = (uint64_t *) ptr;
+    ptr += num_words * sizeof (uint64_t);
+    self->spans = (cairo_half_open_span_t *) ptr;
+    ptr += (width + 1) * sizeof (cairo_half_open_span_t);
+    cells->uncovered_area = (int16_t *) ptr;
+    ptr += width * sizeof (int16_t);
+    cells->covered_height = (int16_t *) ptr;
+
+    if (width)
+	cell_list_reset (cells);
+    else
+	cells->is_empty = TRUE;
+
+    self->active->count = 0;
+    self->active->min_height = 0;
+    self->active->is_vertical = 1;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+_aet_scan_converter_allocate_edges (cairo_aet_scan_converter_t *self,
+				    int num_edges)
+{
+    struct polygon *polygon = self->polygon;
+    struct active_list *active = self->active;
+    cairo_status_t status;
+    char *ptr;
+
+    if (unlikely ((unsigned) num_edges >= INT32_MAX /
+		  (sizeof (struct edge) + sizeof (struct active_edge) + 3 * sizeof (int))))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    status = buffer_reserve (&self->edge_buffer,
+			     num_edges * (sizeof (struct edge) +
+					  7 * sizeof (int64_t) +
+					  7 * sizeof (int32_t)));
+    if (unlikely (status))
+	return status;
+
+    ptr = self->edge_buffer.data;
+    polygon->edges = (struct edge *) ptr;
+    ptr += num_edges * sizeof (struct edge);
+
+    active->x_quo = (int64_t *) ptr;
+    active->x_rem = active->x_quo + num_edges;
+    active->dxdy_quo = active->x_rem + num_edges;
+    active->dxdy_rem = active->dxdy_quo + num_edges;
+    active->full_quo = active->dxdy_rem + num_edges;
+    active->full_rem = active->full_quo + num_edges;
+    active->dy = active->full_rem + num_edges;
+
+    active->cell = (int32_t *) (active->dy + num_edges);
+    active->height_left = active->cell + num_edges;
+    active->dir = active->height_left + num_edges;
+    active->edge = active->dir + num_edges;
+
+    polygon->sorted = active->edge + num_edges;
+    polygon->pending = polygon->sorted + num_edges;
+    polygon->tmp = polygon->pending + num_edges;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static void
+polygon_add_edge (struct polygon *polygon,
+		  const cairo_edge_t *edge)
+{
+    struct edge *e;
+    int ytop, ybot;
+    const cairo_point_t *p1, *p2;
+
+    INPUT_TO_GRID_Y (edge->top, ytop);
+    if (ytop < polygon->ymin)
+	ytop = polygon->ymin;
+
+    INPUT_TO_GRID_Y (edge->bottom, ybot);
+    if (ybot > polygon->ymax)
+	ybot = polygon->ymax;
+
+    if (ybot <= ytop)
+	return;
+
+    e = &polygon->edges[polygon->num_edges++];
+
+    e->ytop = ytop;
+    e->height_left = ybot - ytop;
+    if (edge->line.p2.y > edge->line.p1.y) {
+	e->dir = edge->dir;
+	p1 = &edge->line.p1;
+	p2 = &edge->line.p2;
+    } else {
+	e->dir = -edge->dir;
+	p1 = &edge->line.p2;
+	p2 = &edge->line.p1;
+    }
+
+    if (p2->x == p1->x) {
+	e->cell = p1->x;
+	e->x.quo = p1->x;
+	e->x.rem = 0;
+	e->dxdy.quo = e->dxdy.rem = 0;
+	e->dxdy_full.quo = e->dxdy_full.rem = 0;
+	e->dxdy_half.quo = e->dxdy_half.rem = 0;
+	e->dy = VERTICAL;
+    } else {
+	int64_t Ex, Ey, tmp;
+
+	Ex = (int64_t)(p2->x - p1->x) * GRID_X;
+	Ey = (int64_t)(p2->y - p1->y) * GRID_Y * (2 << CAIRO_FIXED_FRAC_BITS);
+
+	e->dxdy.quo = Ex * (2 << CAIRO_FIXED_FRAC_BITS) / Ey;
+	e->dxdy.rem = Ex * (2 << CAIRO_FIXED_FRAC_BITS) % Ey;
+	e->dxdy_half.quo = e->dxdy.quo / 2;
+	e->dxdy_half.rem = e->dxdy.rem / 2;
+	if (e->dxdy.rem < 0) {
+	    e->dxdy.quo--;
+	    e->dxdy.rem += Ey;
+	}
+
+	tmp = (int64_t)(2*ytop + 1) << CAIRO_FIXED_FRAC_BITS;
+	tmp -= (int64_t)p1->y * GRID_Y * 2;
+	tmp *= Ex;
+	e->x.quo = tmp / Ey + p1->x;
+	e->x.rem = tmp % Ey;
+	if (e->x.rem < 0) {
+	    e->x.quo--;
+	    e->x.rem += Ey;
+	} else if (e->x.rem >= Ey) {
+	    e->x.quo++;
+	    e->x.rem -= Ey;
+	}
+
+	if (e->height_left >= GRID_Y) {
+	    tmp = Ex * (2 * GRID_Y << CAIRO_FIXED_FRAC_BITS);
+	    e->dxdy_full.quo = tmp / Ey;
+	    e->dxdy_full.rem = tmp % Ey;
+	    if (e->dxdy_full.rem < 0) {
+		e->dxdy_full.quo--;
+		e->dxdy_full.rem += Ey;
+	    }
+	} else
+	    e->dxdy_full.quo = e->dxdy_full.rem = 0;
+
+	e->cell = e->x.quo + (e->x.rem >= Ey/2);
+	e->dy = Ey;
+    }
+}
+
+/* Sorts the edges by the pixel row they start in, keeping the order
+ * they were added in within each row. */
+static void
+polygon_sort_edges (struct polygon *polygon)
+{
+    int *rows = polygon->rows;
+    int ymin = polygon->ymin;
+    int i;
+
+    for (i = 0; i < polygon->num_edges; i++)
+	rows[(polygon->edges[i].ytop - ymin) / GRID_Y + 1]++;
+    for (i = 1; i <= polygon->num_rows; i++)
+	rows[i] += rows[i-1];
+
+    /* Fill each row from its start, leaving rows[i] at the start of
+     * the following row. */
+    for (i = 0; i < polygon->num_edges; i++)
+	polygon->sorted[rows[(polygon->edges[i].ytop - ymin) / GRID_Y]++] = i;
+    memmove (rows + 1, rows, polygon->num_rows * sizeof (int));
+    rows[0] = 0;
+}
+
+static cairo_scan_converter_stash_t converter_stash;
+
+static void
+_aet_scan_converter_fini (cairo_aet_scan_converter_t *self)
+{
+    buffer_fini (&self->edge_buffer);
+    buffer_fini (&self->row_buffer);
+    buffer_fini (&self->cell_buffer);
+}
+
+static void
+_cairo_aet_scan_converter_destroy (void *converter)
+{
+    cairo_aet_scan_converter_t *self = converter;
+
+    if (self->base.status == CAIRO_STATUS_SUCCESS) {
+	buffer_trim (&self->edge_buffer);
+	buffer_trim (&self->row_buffer);
+	buffer_trim (&self->cell_buffer);
+	if (_cairo_scan_converter_stash_put (&converter_stash, self))
+	    return;
+    }
+
+    _aet_scan_converter_fini (self);
+    free (self);
+}
+
+void
+_cairo_aet_scan_converter_reset_static_data (void)
+{
+    cairo_aet_scan_converter_t *self;
+
+    while ((self = _cairo_scan_converter_stash_get (&converter_stash))) {
+	_aet_scan_converter_fini (self);
+	free (self);
+    }
+}
+
+/* Unlike the other converters, this one expects the whole polygon to
+ * be added at once. */
+cairo_status_t
+_cairo_aet_scan_converter_add_polygon (void		*converter,
+				       const cairo_polygon_t *polygon)
+{
+    cairo_aet_scan_converter_t *self = converter;
+    cairo_status_t status;
+    int i;
+
+    status = _aet_scan_converter_allocate_edges (self, polygon->num_edges);
+    if (unlikely (status))
+	return status;
+
+    for (i = 0; i < polygon->num_edges; i++)
+	polygon_add_edge (self->polygon, &polygon->edges[i]);
+
+    polygon_sort_edges (self->polygon);
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+_cairo_aet_scan_converter_generate (void			*converter,
+				    cairo_span_renderer_t	*renderer)
+{
+    return _aet_scan_converter_render (converter, renderer);
+}
+
+cairo_scan_converter_t *
+_cairo_aet_scan_converter_create (int			xmin,
+				  int			ymin,
+				  int			xmax,
+				  int			ymax,
+				  cairo_fill_rule_t	fill_rule,
+				  cairo_antialias_t	antialias)
+{
+    cairo_aet_scan_converter_t *self;
+    cairo_status_t status;
+
+    /* Reuse the workspace of a previous fill when one is available */
+    self = _cairo_scan_converter_stash_get (&converter_stash);
+    if (self == NULL) {
+	self = calloc (1, sizeof (cairo_aet_scan_converter_t));
+	if (unlikely (self == NULL)) {
+	    status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	    goto bail_nomem;
+	}
+    }
+
+    self->base.destroy = _cairo_aet_scan_converter_destroy;
+    self->base.generate = _cairo_aet_scan_converter_generate;
+    self->base.status = CAIRO_STATUS_SUCCESS;
+
+    status = _aet_scan_converter_reset (self, xmin, ymin, xmax, ymax);
+    if (unlikely (status))
+	goto bail;
+
+    self->fill_rule = fill_rule;
+    self->antialias = antialias;
+
+    return &self->base;
+
+ bail:
+    self->base.status = status;
+    self->base.destroy(&self->base);
+ bail_nomem:
+    return _cairo_scan_converter_create_in_error (status);
+}
@@ -97,6 +97,11 @@ _cairo_atomic_ptr_get (void **x)
 # define _cairo_atomic_int_dec(x) ((void) __atomic_fetch_sub(x, 1, __ATOMIC_SEQ_CST))
 # define _cairo_atomic_int_dec_and_test(x) (__atomic_fetch_sub(x, 1, __ATOMIC_SEQ_CST) == 1)
 
+/* Taking another reference to an object that is already held needs no
+ * ordering, only dropping the last one must see every prior access. */
+# define _cairo_atomic_int_inc_relaxed(x) ((void) __atomic_fetch_add(x, 1, __ATOMIC_RELAXED))
+# define _cairo_atomic_int_dec_and_test_release(x) (__atomic_fetch_sub(x, 1, __ATOMIC_ACQ_REL) == 1)
+
 #if SIZEOF_VOID_P==SIZEOF_INT
 typedef int cairo_atomic_intptr_t;
 #elif SIZEOF_VOID_P==SIZEOF_LONG
@@ -435,6 +440,14 @@ _cairo_atomic_ptr_cmpxchg_return_old_fallback(void **x, void *oldv, void *newv)
 #define _cairo_atomic_ptr_cmpxchg(x, oldv, newv) (_cairo_atomic_ptr_cmpxchg_return_old (x, oldv, newv) == oldv)
 #endif
 
+#ifndef _cairo_atomic_int_inc_relaxed
+#define _cairo_atomic_int_inc_relaxed(x) _cairo_atomic_int_inc(x)
+#endif
+
+#ifndef _cairo_atomic_int_dec_and_test_release
+#define _cairo_atomic_int_dec_and_test_release(x) _cairo_atomic_int_dec_and_test(x)
+#endif
+
 #define _cairo_atomic_uint_get(x) _cairo_atomic_int_get(x)
 #define _cairo_atomic_uint_cmpxchg(x, oldv, newv) \
     _cairo_atomic_int_cmpxchg((cairo_atomic_int_t *)x, oldv, newv)
@@ -36,6 +36,7 @@
 #ifndef CAIRO_BACKEND_PRIVATE_H
 #define CAIRO_BACKEND_PRIVATE_H
 
+#include "cairo-error-private.h"
 #include "cairo-types-private.h"
 #include "cairo-private.h"
 
@@ -47,6 +48,7 @@ typedef enum _cairo_backend_type {
 struct _cairo_backend {
     cairo_backend_type_t type;
     void (*destroy) (void *cr);
+    cairo_int_status_t (*retarget) (void *cr, cairo_surface_t *target);
 
     cairo_surface_t *(*get_original_target) (void *cr);
     cairo_surface_t *(*get_current_target) (void *cr);
@@ -112,6 +114,7 @@ struct _cairo_backend {
     cairo_status_t (*rel_line_to) (void *cr, double dx, double dy);
     cairo_status_t (*curve_to) (void *cr, double x1, double y1, double x2, double y2, double x3, double y3);
     cairo_status_t (*rel_curve_to) (void *cr, double dx1, double dy1, double dx2, double dy2, double dx3, double dy3);
+    cairo_status_t (*quad_to) (void *cr, double x1, double y1, double x2, double y2);
     cairo_status_t (*arc_to) (void *cr, double x1, double y1, double x2, double y2, double radius);
     cairo_status_t (*rel_arc_to) (void *cr, double dx1, double dy1, double dx2, double dy2, double radius);
     cairo_status_t (*close_path) (void *cr);
@@ -164,8 +167,13 @@ struct _cairo_backend {
     cairo_status_t (*glyphs) (void *cr,
 			      const cairo_glyph_t *glyphs, int num_glyphs,
 			      cairo_glyph_text_info_t *info);
+    cairo_status_t (*glyph_run) (void *cr,
+				 const cairo_glyph_run_t *run,
+				 double dx, double dy);
     cairo_status_t (*glyph_path) (void *cr,
 				  const cairo_glyph_t *glyphs, int num_glyphs);
+    cairo_status_t (*clip_glyphs) (void *cr,
+				   const cairo_glyph_t *glyphs, int num_glyphs);
 
     cairo_status_t (*glyph_extents) (void *cr,
 				     const cairo_glyph_t *glyphs,
@@ -40,17 +40,85 @@
 #include "cairo-error-private.h"
 #include "cairo-output-stream-private.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Encoded output is collected here and handed to the underlying
+ * stream in large writes rather than four bytes at a time. */
+#define BASE64_BUFFER_SIZE 4096
+
 typedef struct _cairo_base64_stream {
     cairo_output_stream_t base;
     cairo_output_stream_t *output;
     unsigned int in_mem;
-    unsigned int trailing;
     unsigned char src[3];
+    unsigned int out_len;
+    unsigned char out[BASE64_BUFFER_SIZE];
 } cairo_base64_stream_t;
 
 static char const base64_table[64] =
 "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+/* Encodes @groups 3 byte groups from @src as 4 characters each. */
+static void
+_base64_encode_groups (const unsigned char *src,
+		       unsigned int	    groups,
+		       unsigned char	   *dst)
+{
+#if defined(__SSE2__)
+    const __m128i b1 = _mm_set1_epi32 (0x3f00);
+    const __m128i b2 = _mm_set1_epi32 (0x3f0000);
+    const __m128i b3 = _mm_set1_epi32 (0x3f000000);
+
+    /* Four groups per iteration: each 32 bit lane holds one group, which
+     * is split into its four 6 bit indices, one per byte, and the
+     * indices are mapped onto the alphabet by adding the offset of the
+     * range each falls in, rather than by table lookups. */
+    for (; groups >= 4; groups -= 4, src += 12, dst += 16) {
+	__m128i w, idx, out;
+
+	w = _mm_setr_epi32 (src[0] << 16 | src[1] << 8 | src[2],
+			    src[3] << 16 | src[4] << 8 | src[5],
+			    src[6] << 16 | src[7] << 8 | src[8],
+			    src[9] << 16 | src[10] << 8 | src[11]);
+	idx = _mm_or_si128 (_mm_or_si128 (_mm_srli_epi32 (w, 18),
+					  _mm_and_si128 (_mm_srli_epi32 (w, 4), b1)),
+			    _mm_or_si128 (_mm_and_si128 (_mm_slli_epi32 (w, 10), b2),
+					  _mm_and_si128 (_mm_slli_epi32 (w, 24), b3)));
+
+	out = _mm_add_epi8 (idx, _mm_set1_epi8 ('A'));
+	out = _mm_add_epi8 (out,
+			    _mm_and_si128 (_mm_cmpgt_epi8 (idx, _mm_set1_epi8 (25)),
+					   _mm_set1_epi8 ('a' - 26 - 'A')));
+	out = _mm_add_epi8 (out,
+			    _mm_and_si128 (_mm_cmpgt_epi8 (idx, _mm_set1_epi8 (51)),
+					   _mm_set1_epi8 (('0' - 52) - ('a' - 26))));
+	out = _mm_add_epi8 (out,
+			    _mm_and_si128 (_mm_cmpgt_epi8 (idx, _mm_set1_epi8 (61)),
+					   _mm_set1_epi8 (('+' - 62) - ('0' - 52))));
+	out = _mm_add_epi8 (out,
+			    _mm_and_si128 (_mm_cmpgt_epi8 (idx, _mm_set1_epi8 (62)),
+					   _mm_set1_epi8 (('/' - 63) - ('+' - 62))));
+	_mm_storeu_si128 ((__m128i *) dst, out);
+    }
+#endif
+
+    for (; groups; groups--, src += 3, dst += 4) {
+	dst[0] = base64_table[src[0] >> 2];
+	dst[1] = base64_table[(src[0] & 0x03) << 4 | src[1] >> 4];
+	dst[2] = base64_table[(src[1] & 0x0f) << 2 | src[2] >> 6];
+	dst[3] = base64_table[src[2] & 0x3f];
+    }
+}
+
+static void
+_cairo_base64_stream_flush_buffer (cairo_base64_stream_t *stream)
+{
+    _cairo_output_stream_write (stream->output, stream->out, stream->out_len);
+    stream->out_len = 0;
+}
+
 static cairo_status_t
 _cairo_base64_stream_write (cairo_output_stream_t *base,
 			    const unsigned char	  *data,
@@ -68,31 +136,35 @@ _cairo_base64_stream_write (cairo_output_stream_t *base,
 	return CAIRO_STATUS_SUCCESS;
     }
 
-    do {
-	unsigned char dst[4];
-
+    if (stream->in_mem) {
 	for (i = stream->in_mem; i < 3; i++) {
 	    src[i] = *data++;
 	    length--;
 	}
 	stream->in_mem = 0;
 
-	dst[0] = base64_table[src[0] >> 2];
-	dst[1] = base64_table[(src[0] & 0x03) << 4 | src[1] >> 4];
-	dst[2] = base64_table[(src[1] & 0x0f) << 2 | src[2] >> 6];
-	dst[3] = base64_table[src[2] & 0xfc >> 2];
-	/* Special case for the last missing bits */
-	switch (stream->trailing) {
-	    case 2:
-		dst[2] = '=';
-		/* fall through */
-	    case 1:
-		dst[3] = '=';
-	    default:
-		break;
+	if (stream->out_len + 4 > BASE64_BUFFER_SIZE)
+	    _cairo_base64_stream_flush_buffer (stream);
+	_base64_encode_groups (src, 1, stream->out + stream->out_len);
+	stream->out_len += 4;
+    }
+
+    while (length >= 3) {
+	unsigned int groups;
+
+	groups = (BASE64_BUFFER_SIZE - stream->out_len) / 4;
+	if (groups == 0) {
+	    _cairo_base64_stream_flush_buffer (stream);
+	    continue;
 	}
-	_cairo_output_stream_write (stream->output, dst, 4);
-    } while (length >= 3);
+	if (groups > length / 3)
+	    groups = length / 3;
+
+	_base64_encode_groups (data, groups, stream->out + stream->out_len);
+	stream->out_len += 4 * groups;
+	data += 3 * groups;
+	length -= 3 * groups;
+    }
 
     for (i = 0; i < length; i++) {
 	src[i] = *data++;
@@ -106,16 +178,34 @@ static cairo_status_t
 _cairo_base64_stream_close (cairo_output_stream_t *base)
 {
     cairo_base64_stream_t *stream = (cairo_base64_stream_t *) base;
-    cairo_status_t status = CAIRO_STATUS_SUCCESS;
 
     if (stream->in_mem > 0) {
+	unsigned char *dst;
+
 	memset (stream->src + stream->in_mem, 0, 3 - stream->in_mem);
-	stream->trailing = 3 - stream->in_mem;
-	stream->in_mem = 3;
-	status = _cairo_base64_stream_write (base, NULL, 0);
+
+	if (stream->out_len + 4 > BASE64_BUFFER_SIZE)
+	    _cairo_base64_stream_flush_buffer (stream);
+	dst = stream->out + stream->out_len;
+	_base64_encode_groups (stream->src, 1, dst);
+	stream->out_len += 4;
+
+	/* Special case for the last missing bits */
+	switch (3 - stream->in_mem) {
+	    case 2:
+		dst[2] = '=';
+		/* fall through */
+	    case 1:
+		dst[3] = '=';
+	    default:
+		break;
+	}
+	stream->in_mem = 0;
     }
 
-    return status;
+    _cairo_base64_stream_flush_buffer (stream);
+
+    return _cairo_output_stream_get_status (stream->output);
 }
 
 cairo_output_stream_t *
@@ -139,7 +229,7 @@ _cairo_base64_stream_create (cairo_output_stream_t *output)
 
     stream->output = output;
     stream->in_mem = 0;
-    stream->trailing = 0;
+    stream->out_len = 0;
 
     return &stream->base;
 }
@@ -38,33 +38,62 @@
 #include "cairo-error-private.h"
 #include "cairo-output-stream-private.h"
 
+/* Encoded output is collected here and handed to the underlying
+ * stream in large writes rather than five bytes at a time. */
+#define BASE85_BUFFER_SIZE 4096
+
 typedef struct _cairo_base85_stream {
     cairo_output_stream_t base;
     cairo_output_stream_t *output;
     unsigned char four_tuple[4];
     int pending;
+    unsigned int out_len;
+    unsigned char out[BASE85_BUFFER_SIZE];
 } cairo_base85_stream_t;
 
 static void
-_expand_four_tuple_to_five (unsigned char four_tuple[4],
-			    unsigned char five_tuple[5],
-			    cairo_bool_t *all_zero)
+_expand_four_tuple_to_five (const unsigned char four_tuple[4],
+			    unsigned char five_tuple[5])
 {
     uint32_t value;
-    int digit, i;
+    int i;
 
     value = (uint32_t)four_tuple[0] << 24 | four_tuple[1] << 16 | four_tuple[2] << 8 | four_tuple[3];
-    if (all_zero)
-	*all_zero = TRUE;
     for (i = 0; i < 5; i++) {
-	digit = value % 85;
-	if (digit != 0 && all_zero)
-	    *all_zero = FALSE;
-	five_tuple[4-i] = digit + 33;
+	five_tuple[4-i] = value % 85 + 33;
 	value = value / 85;
     }
 }
 
+/* Encodes @length bytes, a multiple of four, from @data into @out,
+ * writing "z" for all zero tuples.  Returns the number of bytes
+ * written, at most 5 * @length / 4. */
+static unsigned int
+_base85_encode_tuples (const unsigned char *data,
+		       unsigned int	    length,
+		       unsigned char	   *out)
+{
+    unsigned char *dst = out;
+
+    for (; length; length -= 4, data += 4) {
+	if ((data[0] | data[1] | data[2] | data[3]) == 0) {
+	    *dst++ = 'z';
+	} else {
+	    _expand_four_tuple_to_five (data, dst);
+	    dst += 5;
+	}
+    }
+
+    return dst - out;
+}
+
+static void
+_cairo_base85_stream_flush_buffer (cairo_base85_stream_t *stream)
+{
+    _cairo_output_stream_write (stream->output, stream->out, stream->out_len);
+    stream->out_len = 0;
+}
+
 static cairo_status_t
 _cairo_base85_stream_write (cairo_output_stream_t *base,
 			    const unsigned char	  *data,
@@ -72,22 +101,41 @@ _cairo_base85_stream_write (cairo_output_stream_t *base,
 {
     cairo_base85_stream_t *stream = (cairo_base85_stream_t *) base;
     const unsigned char *ptr = data;
-    unsigned char five_tuple[5];
-    cairo_bool_t is_zero;
 
-    while (length) {
+    while (stream->pending && length) {
 	stream->four_tuple[stream->pending++] = *ptr++;
 	length--;
 	if (stream->pending == 4) {
-	    _expand_four_tuple_to_five (stream->four_tuple, five_tuple, &is_zero);
-	    if (is_zero)
-		_cairo_output_stream_write (stream->output, "z", 1);
-	    else
-		_cairo_output_stream_write (stream->output, five_tuple, 5);
+	    if (stream->out_len + 5 > BASE85_BUFFER_SIZE)
+		_cairo_base85_stream_flush_buffer (stream);
+	    stream->out_len += _base85_encode_tuples (stream->four_tuple, 4,
+						      stream->out + stream->out_len);
 	    stream->pending = 0;
 	}
     }
 
+    while (length >= 4) {
+	unsigned int n;
+
+	n = (BASE85_BUFFER_SIZE - stream->out_len) / 5 * 4;
+	if (n == 0) {
+	    _cairo_base85_stream_flush_buffer (stream);
+	    continue;
+	}
+	if (n > (length & ~3))
+	    n = length & ~3;
+
+	stream->out_len += _base85_encode_tuples (ptr, n,
+						  stream->out + stream->out_len);
+	ptr += n;
+	length -= n;
+    }
+
+    while (length) {
+	stream->four_tuple[stream->pending++] = *ptr++;
+	length--;
+    }
+
     return _cairo_output_stream_get_status (stream->output);
 }
 
@@ -97,9 +145,11 @@ _cairo_base85_stream_close (cairo_output_stream_t *base)
     cairo_base85_stream_t *stream = (cairo_base85_stream_t *) base;
     unsigned char five_tuple[5];
 
+    _cairo_base85_stream_flush_buffer (stream);
+
     if (stream->pending) {
 	memset (stream->four_tuple + stream->pending, 0, 4 - stream->pending);
-	_expand_four_tuple_to_five (stream->four_tuple, five_tuple, NULL);
+	_expand_four_tuple_to_five (stream->four_tuple, five_tuple);
 	_cairo_output_stream_write (stream->output, five_tuple, stream->pending + 1);
     }
 
@@ -126,6 +176,7 @@ _cairo_base85_stream_create (cairo_output_stream_t *output)
 			       _cairo_base85_stream_close);
     stream->output = output;
     stream->pending = 0;
+    stream->out_len = 0;
 
     return &stream->base;
 }
@@ -0,0 +1,251 @@
+/* cairo - a vector graphics library with display and print output
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it either under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ * (the "LGPL") or, at your option, under the terms of the Mozilla
+ * Public License Version 1.1 (the "MPL"). If you do not alter this
+ * notice, a recipient may use your version of this file under either
+ * the MPL or the LGPL.
+ *
+ * You should have received a copy of the LGPL along with this library
+ * in the file COPYING-LGPL-2.1; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335, USA
+ * You should have received a copy of the MPL along with this library
+ * in the file COPYING-MPL-1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY
+ * OF ANY KIND, either express or implied. See the LGPL or the MPL for
+ * the specific language governing rights and limitations.
+ *
+ * The Original Code is the cairo graphics library.
+ */
+
+#include "cairoint.h"
+
+#include "cairo-list-inline.h"
+
+/**
+ * SECTION:cairo-cache-budget
+ * @Title: Cache Memory Budget
+ * @Short_Description: Limiting the memory held by cairo's caches
+ *
+ * cairo keeps glyph images and outlines, recently used scaled fonts,
+ * raster source tiles and solid colour images in global caches so
+ * that they do not have to be recreated for every drawing operation.
+ * Each of these caches has its own fixed limit, which may hold more
+ * memory than a constrained process can afford.
+ *
+ * cairo_cache_set_memory_budget() sets a single limit for the memory
+ * held by all of them together. When the caches grow past it, cairo
+ * evicts entries from the cache holding the most memory relative to
+ * the cost of recreating its entries, so that fonts and glyphs, which
+ * are expensive to rasterise, are kept in preference to cheaper
+ * entries. cairo_cache_get_memory_usage() reports what the caches
+ * currently hold.
+ *
+ * The sizes are estimates of the memory allocated by cairo itself,
+ * and do not include memory held by font backends.
+ **/
+
+static cairo_list_t clients = { &clients, &clients };
+static size_t budget;
+static size_t usage;
+static unsigned int current_round;
+static cairo_bool_t enforcing;
+
+/**
+ * _cairo_cache_budget_charge:
+ * @client: the cache accounting for the memory
+ * @size: number of bytes the cache has started to hold
+ *
+ * Adds @size bytes to the usage of @client, registering it on first
+ * use. This never evicts anything; see _cairo_cache_budget_enforce().
+ **/
+void
+_cairo_cache_budget_charge (cairo_cache_budget_client_t *client,
+			    size_t			 size)
+{
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    if (client->link.next == NULL)
+	cairo_list_add_tail (&client->link, &clients);
+    client->size += size;
+    usage += size;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+}
+
+/**
+ * _cairo_cache_budget_release:
+ * @client: the cache accounting for the memory
+ * @size: number of bytes the cache no longer holds
+ *
+ * Subtracts @size bytes, previously charged, from the usage of @client.
+ **/
+void
+_cairo_cache_budget_release (cairo_cache_budget_client_t *client,
+			     size_t			  size)
+{
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    assert (client->size >= size);
+    client->size -= size;
+    usage -= size;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+}
+
+size_t
+_cairo_cache_budget_get_size (cairo_cache_budget_client_t *client)
+{
+    size_t size;
+
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    size = client->size;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+
+    return size;
+}
+
+/* Of the clients not yet asked to shrink in @round, pick the one
+ * holding the most bytes per unit of cost. */
+static cairo_cache_budget_client_t *
+_cairo_cache_budget_choose_victim (unsigned int round)
+{
+    cairo_cache_budget_client_t *client, *victim = NULL;
+
+    cairo_list_foreach_entry (client, cairo_cache_budget_client_t,
+			      &clients, link)
+    {
+	if (client->round == round || client->size == 0)
+	    continue;
+
+	if (victim == NULL ||
+	    (uint64_t) client->size * victim->cost >
+	    (uint64_t) victim->size * client->cost)
+	{
+	    victim = client;
+	}
+    }
+
+    return victim;
+}
+
+/**
+ * _cairo_cache_budget_enforce:
+ *
+ * If the caches together hold more than the budget, ask them to
+ * shrink, each at most once, in order of decreasing bytes per unit of
+ * cost until the usage is within the budget again. Must be called
+ * without any cache lock held, as the shrink() callbacks take their
+ * own locks.
+ **/
+void
+_cairo_cache_budget_enforce (void)
+{
+    cairo_cache_budget_client_t *victim;
+    unsigned int round;
+
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    /* Destroying cache entries can in turn destroy fonts and enforce
+     * the budget again; leave that to the outermost call. */
+    if (budget == 0 || usage <= budget || enforcing) {
+	CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+	return;
+    }
+    enforcing = TRUE;
+
+    /* Clients start out in round 0, so never use it. */
+    if (++current_round == 0)
+	++current_round;
+    round = current_round;
+
+    while (usage > budget &&
+	   (victim = _cairo_cache_budget_choose_victim (round)) != NULL)
+    {
+	size_t excess = MIN (usage - budget, victim->size);
+
+	victim->round = round;
+
+	/* The callback takes the locks of its cache, which may in turn
+	 * charge or release memory, so it must not run under ours. */
+	CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+	victim->shrink (excess);
+	CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    }
+    enforcing = FALSE;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+}
+
+/**
+ * cairo_cache_set_memory_budget:
+ * @bytes: the maximum number of bytes for cairo's caches to hold, or 0
+ * for no limit
+ *
+ * Sets a limit on the memory held by all of cairo's global caches
+ * together. If the caches currently hold more than @bytes, entries are
+ * evicted immediately. Entries that are in use, such as the glyphs of
+ * a font that is currently being drawn with, are not evicted, so the
+ * usage may briefly exceed the budget.
+ *
+ * By default there is no budget and each cache is only limited by its
+ * own fixed size.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_cache_set_memory_budget (unsigned long bytes)
+{
+    CAIRO_MUTEX_INITIALIZE ();
+
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    budget = bytes;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+
+    _cairo_cache_budget_enforce ();
+}
+
+/**
+ * cairo_cache_get_memory_budget:
+ *
+ * Returns the limit set with cairo_cache_set_memory_budget().
+ *
+ * Return value: the memory budget in bytes, or 0 if there is no limit.
+ *
+ * Since: 1.18
+ **/
+unsigned long
+cairo_cache_get_memory_budget (void)
+{
+    size_t bytes;
+
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    bytes = budget;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+
+    return bytes;
+}
+
+/**
+ * cairo_cache_get_memory_usage:
+ *
+ * Returns an estimate of the memory currently held by cairo's global
+ * caches, as limited by cairo_cache_set_memory_budget().
+ *
+ * Return value: the number of bytes held by the caches.
+ *
+ * Since: 1.18
+ **/
+unsigned long
+cairo_cache_get_memory_usage (void)
+{
+    size_t bytes;
+
+    CAIRO_MUTEX_LOCK (_cairo_cache_budget_mutex);
+    bytes = usage;
+    CAIRO_MUTEX_UNLOCK (_cairo_cache_budget_mutex);
+
+    return bytes;
+}
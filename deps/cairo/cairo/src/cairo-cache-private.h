@@ -142,4 +142,51 @@ _cairo_cache_foreach (cairo_cache_t		 *cache,
 		      cairo_cache_callback_func_t cache_callback,
 		      void			 *closure);
 
+cairo_private cairo_bool_t
+_cairo_cache_evict_one (cairo_cache_t *cache);
+
+/**
+ * _cairo_cache_budget_client:
+ *
+ * A #cairo_cache_budget_client_t accounts for the memory held by one
+ * of cairo's global caches against the process-wide budget set with
+ * cairo_cache_set_memory_budget(). The cache reports every byte it
+ * starts or stops holding with _cairo_cache_budget_charge() and
+ * _cairo_cache_budget_release(), and calls _cairo_cache_budget_enforce()
+ * whenever it has grown and holds no locks.
+ *
+ * When the budget is exceeded, the clients are asked in turn to give
+ * up memory through their shrink() callback, starting with the one
+ * holding the most bytes per unit of @cost. The cost expresses how
+ * expensive the contents are to recreate relative to the other caches,
+ * so that a cheap cache is emptied before an expensive one of the same
+ * size. shrink() is called without any lock held and should release at
+ * least the requested number of bytes if it can.
+ **/
+typedef struct _cairo_cache_budget_client {
+    cairo_list_t link;
+
+    unsigned int cost;
+    void (*shrink) (size_t size);
+
+    size_t size;
+    unsigned int round;
+} cairo_cache_budget_client_t;
+
+#define CAIRO_CACHE_BUDGET_CLIENT_INIT(cost, shrink) { { NULL, NULL }, (cost), (shrink), 0, 0 }
+
+cairo_private void
+_cairo_cache_budget_charge (cairo_cache_budget_client_t *client,
+			    size_t			 size);
+
+cairo_private void
+_cairo_cache_budget_release (cairo_cache_budget_client_t *client,
+			     size_t			  size);
+
+cairo_private size_t
+_cairo_cache_budget_get_size (cairo_cache_budget_client_t *client);
+
+cairo_private void
+_cairo_cache_budget_enforce (void);
+
 #endif
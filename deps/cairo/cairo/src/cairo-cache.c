@@ -225,6 +225,26 @@ _cairo_cache_remove_random (cairo_cache_t *cache)
     return TRUE;
 }
 
+/**
+ * _cairo_cache_evict_one:
+ * @cache: a cache
+ *
+ * Remove a random entry from the cache unless it is frozen, for
+ * callers that need to give back memory outside of the usual
+ * max_size limit.
+ *
+ * Return value: %TRUE if an entry was removed, %FALSE if the cache
+ * is frozen or there are no entries that can be removed.
+ **/
+cairo_bool_t
+_cairo_cache_evict_one (cairo_cache_t *cache)
+{
+    if (cache->freeze_count)
+	return FALSE;
+
+    return _cairo_cache_remove_random (cache);
+}
+
 /**
  * _cairo_cache_shrink_to_accommodate:
  * @cache: a cache
@@ -106,6 +106,9 @@ cairo_private cairo_bool_t
 _cairo_clip_equal (const cairo_clip_t *clip_a,
 		   const cairo_clip_t *clip_b);
 
+cairo_private uintptr_t
+_cairo_clip_hash (const cairo_clip_t *clip);
+
 cairo_private cairo_clip_t *
 _cairo_clip_intersect_rectangle (cairo_clip_t       *clip,
 				 const cairo_rectangle_int_t *rectangle);
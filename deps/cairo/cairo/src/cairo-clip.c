@@ -403,6 +403,29 @@ _cairo_clip_equal (const cairo_clip_t *clip_a,
     return cp_a == NULL && cp_b == NULL;
 }
 
+/* A hash consistent with _cairo_clip_equal() */
+uintptr_t
+_cairo_clip_hash (const cairo_clip_t *clip)
+{
+    const cairo_clip_path_t *clip_path;
+    uintptr_t hash = _CAIRO_HASH_INIT_VALUE;
+
+    if (clip == NULL || _cairo_clip_is_all_clipped (clip))
+	return hash;
+
+    hash = _cairo_hash_bytes (hash, &clip->num_boxes, sizeof (clip->num_boxes));
+    hash = _cairo_hash_bytes (hash, clip->boxes,
+			      clip->num_boxes * sizeof (cairo_box_t));
+
+    for (clip_path = clip->path; clip_path; clip_path = clip_path->prev) {
+	uintptr_t path_hash = _cairo_path_fixed_hash (&clip_path->path);
+
+	hash = _cairo_hash_bytes (hash, &path_hash, sizeof (path_hash));
+    }
+
+    return hash;
+}
+
 static cairo_clip_t *
 _cairo_clip_path_copy_with_translation (cairo_clip_t      *clip,
 					cairo_clip_path_t *other_path,
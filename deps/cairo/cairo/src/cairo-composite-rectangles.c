@@ -37,6 +37,7 @@
 
 #include "cairo-clip-inline.h"
 #include "cairo-error-private.h"
+#include "cairo-glyph-run-private.h"
 #include "cairo-composite-rectangles-private.h"
 #include "cairo-pattern-private.h"
 
@@ -465,6 +466,7 @@ _cairo_composite_rectangles_init_for_glyphs (cairo_composite_rectangles_t *exten
 					     const cairo_clip_t		*clip,
 					     cairo_bool_t		*overlap)
 {
+    const cairo_glyph_run_extents_t *run_extents;
     cairo_status_t status;
     cairo_int_status_t int_status;
 
@@ -473,13 +475,25 @@ _cairo_composite_rectangles_init_for_glyphs (cairo_composite_rectangles_t *exten
 	return CAIRO_INT_STATUS_NOTHING_TO_DO;
     }
 
-    status = _cairo_scaled_font_glyph_device_extents (scaled_font,
-						      glyphs, num_glyphs,
-						      &extents->mask,
-						      overlap);
-    if (unlikely (status)) {
-	_cairo_composite_rectangles_fini(extents);
-	return status;
+    run_extents = surface->glyph_run_extents;
+    if (run_extents != NULL &&
+	run_extents->glyphs == glyphs &&
+	run_extents->num_glyphs == num_glyphs)
+    {
+	extents->mask = run_extents->extents;
+	if (overlap)
+	    *overlap = run_extents->overlap;
+    }
+    else
+    {
+	status = _cairo_scaled_font_glyph_device_extents (scaled_font,
+							  glyphs, num_glyphs,
+							  &extents->mask,
+							  overlap);
+	if (unlikely (status)) {
+	    _cairo_composite_rectangles_fini(extents);
+	    return status;
+	}
     }
     if (overlap && *overlap &&
 	scaled_font->options.antialias == CAIRO_ANTIALIAS_NONE &&
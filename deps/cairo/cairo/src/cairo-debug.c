@@ -34,7 +34,11 @@
  */
 
 #include "cairoint.h"
+#include "cairo-backend-private.h"
+#include "cairo-default-context-private.h"
 #include "cairo-image-surface-private.h"
+#include "cairo-pattern-private.h"
+#include "cairo-spans-private.h"
 
 /**
  * cairo_debug_reset_static_data:
@@ -82,14 +86,19 @@ cairo_debug_reset_static_data (void)
 
     _cairo_pattern_reset_static_data ();
 
+    _cairo_raster_source_pattern_reset_static_data ();
+
     _cairo_clip_reset_static_data ();
 
     _cairo_image_reset_static_data ();
 
-    _cairo_image_compositor_reset_static_data ();
-
     _cairo_default_context_reset_static_data ();
 
+    _cairo_aet_scan_converter_reset_static_data ();
+    _cairo_tor_scan_converter_reset_static_data ();
+    _cairo_tor22_scan_converter_reset_static_data ();
+    _cairo_mono_scan_converter_reset_static_data ();
+
     CAIRO_MUTEX_FINALIZE ();
 }
 
@@ -303,6 +312,29 @@ _cairo_debug_print_polygon (FILE *stream, cairo_polygon_t *polygon)
     }
 }
 
+/* Returns the number of edges the current path of @cr is filled with,
+ * or -1 if @cr does not keep a path of its own. */
+int
+_cairo_debug_count_fill_edges (cairo_t *cr)
+{
+    cairo_default_context_t *dcr = (cairo_default_context_t *) cr;
+    cairo_polygon_t polygon;
+    cairo_status_t status;
+    int num_edges;
+
+    if (cr->status || cr->backend->type != CAIRO_TYPE_DEFAULT)
+	return -1;
+
+    _cairo_polygon_init (&polygon, NULL, 0);
+    status = _cairo_path_fixed_fill_to_polygon (dcr->path,
+						_cairo_gstate_get_tolerance (dcr->gstate),
+						&polygon);
+    num_edges = status ? -1 : polygon.num_edges;
+    _cairo_polygon_fini (&polygon);
+
+    return num_edges;
+}
+
 void
 _cairo_debug_print_matrix (FILE *file, const cairo_matrix_t *matrix)
 {
@@ -51,6 +51,9 @@ struct _cairo_default_context {
     cairo_gstate_t  gstate_tail[2];
     cairo_gstate_t *gstate_freelist;
 
+    /* storage of the last solid source, kept across a retarget */
+    cairo_pattern_t *spare_solid;
+
     cairo_path_fixed_t path[1];
 };
 
@@ -80,6 +80,9 @@ _cairo_default_context_fini (cairo_default_context_t *cr)
 	free (gstate);
     }
 
+    /* already finished when it was set aside */
+    free (cr->spare_solid);
+
     _cairo_path_fixed_fini (cr->path);
 
     _cairo_fini (&cr->base);
@@ -97,6 +100,46 @@ _cairo_default_context_destroy (void *abstract_cr)
     _freed_pool_put (&context_pool, cr);
 }
 
+static cairo_int_status_t
+_cairo_default_context_retarget (void *abstract_cr, cairo_surface_t *target)
+{
+    cairo_default_context_t *cr = abstract_cr;
+    cairo_pattern_t *source;
+
+    if (target->backend == NULL ||
+	target->backend->create_context != _cairo_default_context_create)
+	return CAIRO_INT_STATUS_UNSUPPORTED;
+
+    /* Unwind the saved states onto the freelist so that they are
+     * reused by later saves, then start afresh from the bottom state.
+     */
+    while (cr->gstate != &cr->gstate_tail[0]) {
+	if (_cairo_gstate_restore (&cr->gstate, &cr->gstate_freelist))
+	    break;
+    }
+
+    /* Keep the storage of a solid source that nobody else holds, for
+     * the next set_source_rgba() on the new target.
+     */
+    source = _cairo_gstate_get_source (cr->gstate);
+    if (cr->spare_solid == NULL &&
+	source->type == CAIRO_PATTERN_TYPE_SOLID &&
+	! CAIRO_REFERENCE_COUNT_IS_INVALID (&source->ref_count) &&
+	CAIRO_REFERENCE_COUNT_GET_VALUE (&source->ref_count) == 1)
+    {
+	cairo_pattern_reference (source);
+	_cairo_gstate_set_source (cr->gstate,
+				  (cairo_pattern_t *) &_cairo_pattern_black);
+	_cairo_pattern_fini (source);
+	cr->spare_solid = source;
+    }
+
+    _cairo_gstate_fini (cr->gstate);
+    _cairo_path_fixed_reset (cr->path);
+
+    return _cairo_gstate_init (cr->gstate, target);
+}
+
 static cairo_surface_t *
 _cairo_default_context_get_original_target (void *abstract_cr)
 {
@@ -300,9 +343,24 @@ _cairo_default_context_set_source_rgba (void *abstract_cr, double red, double gr
     /* push the current pattern to the freed lists */
     _cairo_default_context_set_source (cr, (cairo_pattern_t *) &_cairo_pattern_black);
 
-    pattern = cairo_pattern_create_rgba (red, green, blue, alpha);
-    if (unlikely (pattern->status))
-	return pattern->status;
+    if (cr->spare_solid != NULL) {
+	cairo_color_t color;
+
+	_cairo_color_init_rgba (&color,
+				_cairo_restrict_value (red,   0.0, 1.0),
+				_cairo_restrict_value (green, 0.0, 1.0),
+				_cairo_restrict_value (blue,  0.0, 1.0),
+				_cairo_restrict_value (alpha, 0.0, 1.0));
+
+	pattern = cr->spare_solid;
+	cr->spare_solid = NULL;
+	_cairo_pattern_init_solid ((cairo_solid_pattern_t *) pattern, &color);
+	CAIRO_REFERENCE_COUNT_INIT (&pattern->ref_count, 1);
+    } else {
+	pattern = cairo_pattern_create_rgba (red, green, blue, alpha);
+	if (unlikely (pattern->status))
+	    return pattern->status;
+    }
 
     status = _cairo_default_context_set_source (cr, pattern);
     cairo_pattern_destroy (pattern);
@@ -692,8 +750,7 @@ _cairo_default_context_new_path (void *abstract_cr)
 {
     cairo_default_context_t *cr = abstract_cr;
 
-    _cairo_path_fixed_fini (cr->path);
-    _cairo_path_fixed_init (cr->path);
+    _cairo_path_fixed_reset (cr->path);
 
     return CAIRO_STATUS_SUCCESS;
 }
@@ -770,6 +827,31 @@ _cairo_default_context_curve_to (void *abstract_cr,
 				       x3_fixed, y3_fixed);
 }
 
+static cairo_status_t
+_cairo_default_context_quad_to (void *abstract_cr,
+				double x1, double y1,
+				double x2, double y2)
+{
+    cairo_default_context_t *cr = abstract_cr;
+    cairo_fixed_t x1_fixed, y1_fixed;
+    cairo_fixed_t x2_fixed, y2_fixed;
+    double width;
+
+    _cairo_gstate_user_to_backend (cr->gstate, &x1, &y1);
+    _cairo_gstate_user_to_backend (cr->gstate, &x2, &y2);
+    width = _cairo_gstate_get_line_width (cr->gstate);
+
+    x1_fixed = _cairo_fixed_from_double_clamped (x1, width);
+    y1_fixed = _cairo_fixed_from_double_clamped (y1, width);
+
+    x2_fixed = _cairo_fixed_from_double_clamped (x2, width);
+    y2_fixed = _cairo_fixed_from_double_clamped (y2, width);
+
+    return _cairo_path_fixed_quad_to (cr->path,
+				      x1_fixed, y1_fixed,
+				      x2_fixed, y2_fixed);
+}
+
 static cairo_status_t
 _cairo_default_context_arc (void *abstract_cr,
 			    double xc, double yc, double radius,
@@ -1340,6 +1422,16 @@ _cairo_default_context_glyphs (void *abstract_cr,
     return _cairo_gstate_show_text_glyphs (cr->gstate, glyphs, num_glyphs, info);
 }
 
+static cairo_status_t
+_cairo_default_context_glyph_run (void *abstract_cr,
+				  const cairo_glyph_run_t *run,
+				  double dx, double dy)
+{
+    cairo_default_context_t *cr = abstract_cr;
+
+    return _cairo_gstate_show_glyph_run (cr->gstate, run, dx, dy);
+}
+
 static cairo_status_t
 _cairo_default_context_glyph_path (void *abstract_cr,
 				   const cairo_glyph_t *glyphs,
@@ -1352,6 +1444,16 @@ _cairo_default_context_glyph_path (void *abstract_cr,
 				     cr->path);
 }
 
+static cairo_status_t
+_cairo_default_context_clip_glyphs (void *abstract_cr,
+				    const cairo_glyph_t *glyphs,
+				    int num_glyphs)
+{
+    cairo_default_context_t *cr = abstract_cr;
+
+    return _cairo_gstate_clip_glyphs (cr->gstate, glyphs, num_glyphs);
+}
+
 static cairo_status_t
 _cairo_default_context_glyph_extents (void                *abstract_cr,
 				      const cairo_glyph_t    *glyphs,
@@ -1366,6 +1468,7 @@ _cairo_default_context_glyph_extents (void                *abstract_cr,
 static const cairo_backend_t _cairo_default_context_backend = {
     CAIRO_TYPE_DEFAULT,
     _cairo_default_context_destroy,
+    _cairo_default_context_retarget,
 
     _cairo_default_context_get_original_target,
     _cairo_default_context_get_current_target,
@@ -1430,6 +1533,7 @@ static const cairo_backend_t _cairo_default_context_backend = {
     _cairo_default_context_rel_line_to,
     _cairo_default_context_curve_to,
     _cairo_default_context_rel_curve_to,
+    _cairo_default_context_quad_to,
     NULL, /* arc-to */
     NULL, /* rel-arc-to */
     _cairo_default_context_close_path,
@@ -1477,7 +1581,9 @@ static const cairo_backend_t _cairo_default_context_backend = {
     _cairo_default_context_font_extents,
 
     _cairo_default_context_glyphs,
+    _cairo_default_context_glyph_run,
     _cairo_default_context_glyph_path,
+    _cairo_default_context_clip_glyphs,
     _cairo_default_context_glyph_extents,
 
     _cairo_default_context_copy_page,
@@ -1496,6 +1602,7 @@ _cairo_default_context_init (cairo_default_context_t *cr, void *target)
     cr->gstate = &cr->gstate_tail[0];
     cr->gstate_freelist = &cr->gstate_tail[1];
     cr->gstate_tail[1].next = NULL;
+    cr->spare_solid = NULL;
 
     return _cairo_gstate_init (cr->gstate, target);
 }
@@ -189,6 +189,10 @@ struct _cairo_ft_unscaled_font {
     int lock_count;
 
     cairo_ft_font_face_t *faces;	/* Linked list of faces for this font */
+
+    /* Unhinted glyph outlines in font units, shared by all sizes */
+    cairo_bool_t have_outlines;
+    cairo_cache_t outlines;
 };
 
 static int
@@ -504,6 +508,7 @@ _cairo_ft_unscaled_font_init (cairo_ft_unscaled_font_t *unscaled,
     unscaled->lock_count = 0;
 
     unscaled->faces = NULL;
+    unscaled->have_outlines = FALSE;
 
     return CAIRO_STATUS_SUCCESS;
 }
@@ -529,6 +534,9 @@ _cairo_ft_unscaled_font_fini (cairo_ft_unscaled_font_t *unscaled)
 
     free (unscaled->variations);
 
+    if (unscaled->have_outlines)
+	_cairo_cache_fini (&unscaled->outlines);
+
     CAIRO_MUTEX_FINI (unscaled->mutex);
 }
 
@@ -1486,6 +1494,7 @@ _render_glyph_outline (FT_Face                    face,
     case CAIRO_ANTIALIAS_GRAY:
     case CAIRO_ANTIALIAS_GOOD:
     case CAIRO_ANTIALIAS_FAST:
+    case CAIRO_ANTIALIAS_ADAPTIVE:
 	render_mode = FT_RENDER_MODE_NORMAL;
     }
 
@@ -2213,31 +2222,18 @@ _conic_to (FT_Vector *control, FT_Vector *to, void *closure)
 {
     cairo_path_fixed_t *path = closure;
 
-    cairo_fixed_t x0, y0;
     cairo_fixed_t x1, y1;
     cairo_fixed_t x2, y2;
-    cairo_fixed_t x3, y3;
-    cairo_point_t conic;
-
-    if (! _cairo_path_fixed_get_current_point (path, &x0, &y0))
-	return 1;
-
-    conic.x = _cairo_fixed_from_26_6 (control->x);
-    conic.y = _cairo_fixed_from_26_6 (control->y);
 
-    x3 = _cairo_fixed_from_26_6 (to->x);
-    y3 = _cairo_fixed_from_26_6 (to->y);
+    x1 = _cairo_fixed_from_26_6 (control->x);
+    y1 = _cairo_fixed_from_26_6 (control->y);
 
-    x1 = x0 + 2.0/3.0 * (conic.x - x0);
-    y1 = y0 + 2.0/3.0 * (conic.y - y0);
-
-    x2 = x3 + 2.0/3.0 * (conic.x - x3);
-    y2 = y3 + 2.0/3.0 * (conic.y - y3);
+    x2 = _cairo_fixed_from_26_6 (to->x);
+    y2 = _cairo_fixed_from_26_6 (to->y);
 
-    if (_cairo_path_fixed_curve_to (path,
-				    x1, y1,
-				    x2, y2,
-				    x3, y3) != CAIRO_STATUS_SUCCESS)
+    if (_cairo_path_fixed_quad_to (path,
+				   x1, y1,
+				   x2, y2) != CAIRO_STATUS_SUCCESS)
 	return 1;
 
     return 0;
@@ -3396,6 +3392,171 @@ _cairo_ft_scaled_glyph_init_metrics (cairo_ft_scaled_font_t  *scaled_font,
     return status;
 }
 
+/*
+ * Without hinting a glyph outline scales linearly, so rather than
+ * loading and decomposing the glyph again for every size it is used
+ * at, its outline is decomposed once in font units and kept with the
+ * unscaled font.  Each scaled font derives its device space path from
+ * that with a single transformation.
+ */
+
+#define MAX_SHARED_OUTLINES 1024
+
+typedef struct _cairo_ft_outline {
+    cairo_cache_entry_t base; /* hash is the glyph index */
+    cairo_path_fixed_t *path;
+} cairo_ft_outline_t;
+
+static cairo_bool_t
+_cairo_ft_outline_keys_equal (const void *key_a,
+			      const void *key_b)
+{
+    const cairo_ft_outline_t *outline_a = key_a;
+    const cairo_ft_outline_t *outline_b = key_b;
+
+    return outline_a->base.hash == outline_b->base.hash;
+}
+
+static void
+_cairo_ft_outline_destroy (void *abstract_outline)
+{
+    cairo_ft_outline_t *outline = abstract_outline;
+
+    _cairo_path_fixed_destroy (outline->path);
+    free (outline);
+}
+
+static cairo_bool_t
+_cairo_ft_scaled_font_shares_outlines (cairo_ft_scaled_font_t *scaled_font,
+				       FT_Face                 face,
+				       int                     load_flags)
+{
+    /* Hinting, synthesis and variations all make the outline depend
+     * on more than the glyph index. */
+    return (load_flags & FT_LOAD_NO_HINTING) &&
+	   scaled_font->ft_options.synth_flags == 0 &&
+	   FT_IS_SCALABLE (face) &&
+	   ! FT_IS_TRICKY (face) &&
+	   ! FT_HAS_MULTIPLE_MASTERS (face);
+}
+
+static cairo_int_status_t
+_cairo_ft_unscaled_font_get_outline (cairo_ft_unscaled_font_t *unscaled,
+				     FT_Face                   face,
+				     unsigned long             index,
+				     cairo_path_fixed_t      **pathp)
+{
+    /* _cairo_ft_face_decompose_glyph_outline() reads 26.6 coordinates */
+    static const FT_Matrix units_to_26_6 = {
+	DOUBLE_TO_16_16 (64.0), 0,
+	0, DOUBLE_TO_16_16 (64.0),
+    };
+    cairo_ft_outline_t key, *outline;
+    cairo_path_fixed_t *path;
+    cairo_status_t status;
+    FT_Error error;
+
+    if (! unscaled->have_outlines) {
+	status = _cairo_cache_init (&unscaled->outlines,
+				    _cairo_ft_outline_keys_equal,
+				    NULL,
+				    _cairo_ft_outline_destroy,
+				    MAX_SHARED_OUTLINES);
+	if (unlikely (status))
+	    return status;
+
+	unscaled->have_outlines = TRUE;
+    }
+
+    key.base.hash = index;
+    outline = _cairo_cache_lookup (&unscaled->outlines, &key.base);
+    if (outline != NULL) {
+	*pathp = outline->path;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    /* Load the glyph in font units, without the current transformation. */
+    if (! unscaled->have_scale || unscaled->have_shape) {
+	FT_Set_Transform (face, NULL, NULL);
+	unscaled->have_scale = FALSE;
+	unscaled->have_shape = FALSE;
+    }
+
+    error = FT_Load_Glyph (face, index,
+			   FT_LOAD_NO_SCALE |
+			   FT_LOAD_NO_BITMAP |
+			   FT_LOAD_IGNORE_GLOBAL_ADVANCE_WIDTH);
+    if (error == FT_Err_Out_Of_Memory)
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    if (error || face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+	return CAIRO_INT_STATUS_UNSUPPORTED;
+
+    FT_Outline_Transform (&face->glyph->outline, &units_to_26_6);
+    status = _cairo_ft_face_decompose_glyph_outline (face, &path);
+    if (unlikely (status))
+	return status;
+
+    outline = _cairo_malloc (sizeof (cairo_ft_outline_t));
+    if (unlikely (outline == NULL)) {
+	_cairo_path_fixed_destroy (path);
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    outline->base.hash = index;
+    outline->base.size = 1;
+    outline->path = path;
+
+    status = _cairo_cache_insert (&unscaled->outlines, &outline->base);
+    if (unlikely (status)) {
+	_cairo_ft_outline_destroy (outline);
+	return status;
+    }
+
+    *pathp = path;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_int_status_t
+_cairo_ft_scaled_glyph_init_shared_path (cairo_ft_scaled_font_t *scaled_font,
+					 cairo_scaled_glyph_t   *scaled_glyph,
+					 FT_Face                 face,
+					 cairo_path_fixed_t    **pathp)
+{
+    cairo_path_fixed_t *outline = NULL, *path;
+    cairo_matrix_t matrix;
+    cairo_int_status_t status;
+
+    status = _cairo_ft_unscaled_font_get_outline (scaled_font->unscaled,
+						  face,
+						  _cairo_scaled_glyph_index (scaled_glyph),
+						  &outline);
+    if (unlikely (status))
+	return status;
+
+    path = _cairo_malloc (sizeof (cairo_path_fixed_t));
+    if (unlikely (path == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    status = _cairo_path_fixed_init_copy (path, outline);
+    if (unlikely (status)) {
+	free (path);
+	return status;
+    }
+
+    matrix = scaled_font->base.scale;
+    matrix.x0 = matrix.y0 = 0;
+    cairo_matrix_scale (&matrix, 1. / face->units_per_EM, 1. / face->units_per_EM);
+    _cairo_path_fixed_transform (path, &matrix);
+
+    /* The same subpixel phase as _cairo_ft_scaled_glyph_load_glyph() */
+    _cairo_path_fixed_translate (path,
+				 _cairo_fixed_from_26_6 (_cairo_scaled_glyph_xphase (scaled_glyph) << 4),
+				 _cairo_fixed_from_26_6 (_cairo_scaled_glyph_yphase (scaled_glyph) << 4));
+
+    *pathp = path;
+    return CAIRO_STATUS_SUCCESS;
+}
+
 static cairo_int_status_t
 _cairo_ft_scaled_glyph_init (void			*abstract_font,
 			     cairo_scaled_glyph_t	*scaled_glyph,
@@ -3541,6 +3702,13 @@ _cairo_ft_scaled_glyph_init (void			*abstract_font,
 		goto FAIL;
 	    }
 
+	} else if (glyph_priv->format == CAIRO_FT_GLYPH_TYPE_OUTLINE &&
+		   ! vertical_layout &&
+		   _cairo_ft_scaled_font_shares_outlines (scaled_font, face, load_flags)) {
+	    status = _cairo_ft_scaled_glyph_init_shared_path (scaled_font,
+							      scaled_glyph,
+							      face,
+							      &path);
 	} else {
 	    /*
 	     * A kludge -- the above code will trash the outline,
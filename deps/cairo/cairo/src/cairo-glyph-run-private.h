@@ -0,0 +1,78 @@
+/* cairo - a vector graphics library with display and print output
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it either under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ * (the "LGPL") or, at your option, under the terms of the Mozilla
+ * Public License Version 1.1 (the "MPL"). If you do not alter this
+ * notice, a recipient may use your version of this file under either
+ * the MPL or the LGPL.
+ *
+ * You should have received a copy of the LGPL along with this library
+ * in the file COPYING-LGPL-2.1; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335, USA
+ * You should have received a copy of the MPL along with this library
+ * in the file COPYING-MPL-1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY
+ * OF ANY KIND, either express or implied. See the LGPL or the MPL for
+ * the specific language governing rights and limitations.
+ *
+ * The Original Code is the cairo graphics library.
+ */
+
+#ifndef CAIRO_GLYPH_RUN_PRIVATE_H
+#define CAIRO_GLYPH_RUN_PRIVATE_H
+
+#include "cairo-types-private.h"
+#include "cairo-reference-count-private.h"
+
+CAIRO_BEGIN_DECLS
+
+struct _cairo_glyph_run {
+    cairo_reference_count_t ref_count;
+    cairo_status_t status;
+
+    /* The font and the user to backend transformation (including the
+     * font matrix offset) that device_glyphs were computed for. */
+    cairo_scaled_font_t *scaled_font;
+    cairo_matrix_t transform;
+
+    int num_glyphs;
+    cairo_glyph_t *glyphs;
+    cairo_glyph_t *device_glyphs;
+
+    /* Unrounded backend-space ink bounds of device_glyphs */
+    cairo_box_t box;
+    cairo_bool_t overlap;
+};
+
+/* Attached to the target surface while the glyphs of a run are being
+ * shown, so that the compositor can skip recomputing their extents.
+ * Only a call passing exactly @glyphs and @num_glyphs may use it. */
+struct _cairo_glyph_run_extents {
+    const cairo_glyph_t *glyphs;
+    int num_glyphs;
+    cairo_rectangle_int_t extents;
+    cairo_bool_t overlap;
+};
+
+cairo_private void
+_cairo_glyph_run_get_transform (cairo_matrix_t		*transform,
+				const cairo_matrix_t	*font_matrix,
+				const cairo_matrix_t	*ctm,
+				const cairo_matrix_t	*device_transform);
+
+cairo_private cairo_bool_t
+_cairo_glyph_run_matches (const cairo_glyph_run_t	*run,
+			  const cairo_scaled_font_t	*scaled_font,
+			  const cairo_matrix_t		*transform);
+
+CAIRO_END_DECLS
+
+#endif /* CAIRO_GLYPH_RUN_PRIVATE_H */
@@ -0,0 +1,267 @@
+/* cairo - a vector graphics library with display and print output
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it either under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ * (the "LGPL") or, at your option, under the terms of the Mozilla
+ * Public License Version 1.1 (the "MPL"). If you do not alter this
+ * notice, a recipient may use your version of this file under either
+ * the MPL or the LGPL.
+ *
+ * You should have received a copy of the LGPL along with this library
+ * in the file COPYING-LGPL-2.1; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335, USA
+ * You should have received a copy of the MPL along with this library
+ * in the file COPYING-MPL-1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY
+ * OF ANY KIND, either express or implied. See the LGPL or the MPL for
+ * the specific language governing rights and limitations.
+ *
+ * The Original Code is the cairo graphics library.
+ */
+
+#include "cairoint.h"
+
+#include "cairo-error-private.h"
+#include "cairo-glyph-run-private.h"
+
+/**
+ * SECTION:cairo-glyph-run
+ * @Title: Glyph Runs
+ * @Short_Description: Glyphs prepared for repeated drawing
+ * @See_Also: cairo_show_glyphs()
+ *
+ * Before glyphs can be drawn, cairo_show_glyphs() transforms each of
+ * them to device space and looks up every glyph in the font cache to
+ * compute the area it covers. When the same glyphs are drawn again
+ * and again, as happens when redrawing lines of text, that work is
+ * repeated for every call.
+ *
+ * A #cairo_glyph_run_t keeps the result of that work. It is created
+ * once for the scaled font and transformation of a context, and can
+ * then be drawn with cairo_show_glyph_run() at any offset for the
+ * cost of a translation, for as long as the context uses the same
+ * scaled font and the same transformation up to a translation.
+ **/
+
+static const cairo_glyph_run_t _cairo_glyph_run_nil = {
+    CAIRO_REFERENCE_COUNT_INVALID,	/* ref_count */
+    CAIRO_STATUS_NO_MEMORY,		/* status */
+};
+
+static cairo_glyph_run_t *
+_cairo_glyph_run_create_in_error (cairo_status_t status)
+{
+    cairo_glyph_run_t *run;
+
+    assert (status != CAIRO_STATUS_SUCCESS);
+
+    if (status == CAIRO_STATUS_NO_MEMORY)
+	return (cairo_glyph_run_t *) &_cairo_glyph_run_nil;
+
+    run = _cairo_malloc (sizeof (cairo_glyph_run_t));
+    if (unlikely (run == NULL)) {
+	_cairo_error_throw (CAIRO_STATUS_NO_MEMORY);
+	return (cairo_glyph_run_t *) &_cairo_glyph_run_nil;
+    }
+
+    *run = _cairo_glyph_run_nil;
+    CAIRO_REFERENCE_COUNT_INIT (&run->ref_count, 1);
+    run->status = status;
+
+    return run;
+}
+
+void
+_cairo_glyph_run_get_transform (cairo_matrix_t		*transform,
+				const cairo_matrix_t	*font_matrix,
+				const cairo_matrix_t	*ctm,
+				const cairo_matrix_t	*device_transform)
+{
+    cairo_matrix_init_translate (transform, font_matrix->x0, font_matrix->y0);
+    cairo_matrix_multiply (transform, transform, ctm);
+    cairo_matrix_multiply (transform, transform, device_transform);
+}
+
+/* A run can be reused with the given font and transformation if they
+ * only differ from its own by a translation. */
+cairo_bool_t
+_cairo_glyph_run_matches (const cairo_glyph_run_t	*run,
+			  const cairo_scaled_font_t	*scaled_font,
+			  const cairo_matrix_t		*transform)
+{
+    return run->scaled_font == scaled_font &&
+	   run->transform.xx == transform->xx &&
+	   run->transform.yx == transform->yx &&
+	   run->transform.xy == transform->xy &&
+	   run->transform.yy == transform->yy;
+}
+
+/**
+ * cairo_glyph_run_create:
+ * @cr: a cairo context
+ * @glyphs: array of glyphs to prepare
+ * @num_glyphs: number of glyphs in @glyphs
+ *
+ * Creates an immutable run of @glyphs, prepared for drawing with the
+ * current scaled font and transformation of @cr. The glyph positions
+ * are transformed to device space and the device extents of the run
+ * are computed once here, so that cairo_show_glyph_run() does not
+ * have to repeat that work.
+ *
+ * Later changes to @cr do not modify the run. If the run is drawn
+ * while @cr uses another scaled font, or a transformation that is not
+ * a translation of the one in effect here, it is drawn exactly as
+ * cairo_show_glyphs() would draw it, just without the savings.
+ *
+ * Return value: a newly created #cairo_glyph_run_t. Free with
+ * cairo_glyph_run_destroy(). This function always returns a valid
+ * pointer; if memory cannot be allocated, or @cr or its scaled font
+ * is in an error state, a special error object is returned whose
+ * status can be checked with cairo_glyph_run_status().
+ *
+ * Since: 1.18
+ **/
+cairo_glyph_run_t *
+cairo_glyph_run_create (cairo_t			*cr,
+			const cairo_glyph_t	*glyphs,
+			int			 num_glyphs)
+{
+    cairo_scaled_font_t *scaled_font;
+    cairo_matrix_t font_matrix, ctm;
+    cairo_surface_t *target;
+    cairo_glyph_run_t *run;
+    cairo_status_t status;
+
+    status = cairo_status (cr);
+    if (unlikely (status))
+	return _cairo_glyph_run_create_in_error (status);
+
+    if (unlikely (num_glyphs < 0))
+	return _cairo_glyph_run_create_in_error (_cairo_error (CAIRO_STATUS_NEGATIVE_COUNT));
+
+    if (unlikely (glyphs == NULL && num_glyphs != 0))
+	return _cairo_glyph_run_create_in_error (_cairo_error (CAIRO_STATUS_NULL_POINTER));
+
+    scaled_font = cairo_get_scaled_font (cr);
+    if (unlikely (scaled_font->status))
+	return _cairo_glyph_run_create_in_error (scaled_font->status);
+
+    if (unlikely ((unsigned) num_glyphs >= INT32_MAX / (2 * sizeof (cairo_glyph_t))))
+	return _cairo_glyph_run_create_in_error (_cairo_error (CAIRO_STATUS_NO_MEMORY));
+
+    run = _cairo_malloc (sizeof (cairo_glyph_run_t) +
+			 2 * num_glyphs * sizeof (cairo_glyph_t));
+    if (unlikely (run == NULL))
+	return _cairo_glyph_run_create_in_error (_cairo_error (CAIRO_STATUS_NO_MEMORY));
+
+    CAIRO_REFERENCE_COUNT_INIT (&run->ref_count, 1);
+    run->status = CAIRO_STATUS_SUCCESS;
+    run->scaled_font = cairo_scaled_font_reference (scaled_font);
+
+    cairo_get_font_matrix (cr, &font_matrix);
+    cairo_get_matrix (cr, &ctm);
+    target = cairo_get_group_target (cr);
+    _cairo_glyph_run_get_transform (&run->transform,
+				    &font_matrix, &ctm,
+				    &target->device_transform);
+
+    run->num_glyphs = num_glyphs;
+    run->glyphs = (cairo_glyph_t *) (run + 1);
+    run->device_glyphs = run->glyphs + num_glyphs;
+    if (num_glyphs)
+	memcpy (run->glyphs, glyphs, num_glyphs * sizeof (cairo_glyph_t));
+
+    _cairo_matrix_transform_glyphs (&run->transform,
+				    glyphs, run->device_glyphs, num_glyphs);
+
+    run->box.p1.x = run->box.p1.y = 0;
+    run->box.p2.x = run->box.p2.y = 0;
+    run->overlap = FALSE;
+    if (num_glyphs) {
+	status = _cairo_scaled_font_glyph_device_box (scaled_font,
+						      run->device_glyphs,
+						      num_glyphs,
+						      &run->box,
+						      &run->overlap);
+	if (unlikely (status)) {
+	    cairo_glyph_run_destroy (run);
+	    return _cairo_glyph_run_create_in_error (status);
+	}
+    }
+
+    return run;
+}
+
+/**
+ * cairo_glyph_run_reference:
+ * @run: a #cairo_glyph_run_t
+ *
+ * Increases the reference count on @run by one. This prevents
+ * @run from being destroyed until a matching call to
+ * cairo_glyph_run_destroy() is made.
+ *
+ * Return value: the referenced #cairo_glyph_run_t.
+ *
+ * Since: 1.18
+ **/
+cairo_glyph_run_t *
+cairo_glyph_run_reference (cairo_glyph_run_t *run)
+{
+    if (run == NULL || CAIRO_REFERENCE_COUNT_IS_INVALID (&run->ref_count))
+	return run;
+
+    assert (CAIRO_REFERENCE_COUNT_HAS_REFERENCE (&run->ref_count));
+
+    _cairo_reference_count_inc (&run->ref_count);
+
+    return run;
+}
+
+/**
+ * cairo_glyph_run_destroy:
+ * @run: a #cairo_glyph_run_t
+ *
+ * Decreases the reference count on @run by one. If the result is
+ * zero, then @run and all associated resources are freed.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_glyph_run_destroy (cairo_glyph_run_t *run)
+{
+    if (run == NULL || CAIRO_REFERENCE_COUNT_IS_INVALID (&run->ref_count))
+	return;
+
+    assert (CAIRO_REFERENCE_COUNT_HAS_REFERENCE (&run->ref_count));
+
+    if (! _cairo_reference_count_dec_and_test (&run->ref_count))
+	return;
+
+    cairo_scaled_font_destroy (run->scaled_font);
+    free (run);
+}
+
+/**
+ * cairo_glyph_run_status:
+ * @run: a #cairo_glyph_run_t
+ *
+ * Checks whether an error has previously occurred for this run.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS, %CAIRO_STATUS_NO_MEMORY,
+ * %CAIRO_STATUS_NEGATIVE_COUNT, %CAIRO_STATUS_NULL_POINTER, or the
+ * error status of the context or scaled font it was created from.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_glyph_run_status (cairo_glyph_run_t *run)
+{
+    return run->status;
+}
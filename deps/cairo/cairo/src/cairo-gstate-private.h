@@ -56,6 +56,8 @@ struct _cairo_gstate {
     cairo_font_options_t font_options;
 
     cairo_clip_t *clip;
+    /* Set while the last change to clip was cairo_clip_glyphs() */
+    struct _cairo_gstate_glyph_clip *glyph_clip;
 
     cairo_surface_t *target;		/* The target to which all rendering is directed */
     cairo_surface_t *parent_target;	/* The previous target which was receiving rendering */
@@ -311,6 +313,11 @@ _cairo_gstate_clip (cairo_gstate_t *gstate, cairo_path_fixed_t *path);
 cairo_private cairo_status_t
 _cairo_gstate_reset_clip (cairo_gstate_t *gstate);
 
+cairo_private cairo_status_t
+_cairo_gstate_clip_glyphs (cairo_gstate_t      *gstate,
+			   const cairo_glyph_t *glyphs,
+			   int		        num_glyphs);
+
 cairo_private cairo_bool_t
 _cairo_gstate_clip_extents (cairo_gstate_t *gstate,
 		            double         *x1,
@@ -386,6 +393,12 @@ _cairo_gstate_show_text_glyphs (cairo_gstate_t		   *gstate,
 				int			    num_glyphs,
 				cairo_glyph_text_info_t    *info);
 
+cairo_private cairo_status_t
+_cairo_gstate_show_glyph_run (cairo_gstate_t		*gstate,
+			      const cairo_glyph_run_t	*run,
+			      double			 dx,
+			      double			 dy);
+
 cairo_private cairo_status_t
 _cairo_gstate_glyph_path (cairo_gstate_t      *gstate,
 			  const cairo_glyph_t *glyphs,
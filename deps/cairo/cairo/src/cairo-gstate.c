@@ -40,6 +40,7 @@
 #include "cairo-clip-inline.h"
 #include "cairo-clip-private.h"
 #include "cairo-error-private.h"
+#include "cairo-glyph-run-private.h"
 #include "cairo-list-inline.h"
 #include "cairo-gstate-private.h"
 #include "cairo-pattern-private.h"
@@ -68,6 +69,41 @@ _cairo_gstate_transform_glyphs_to_backend (cairo_gstate_t      *gstate,
 					   int			*num_transformed_glyphs,
 					   cairo_text_cluster_t *transformed_clusters);
 
+/* The glyphs, in backend space, whose outlines were last intersected
+ * with the clip by cairo_clip_glyphs(), together with the clip from
+ * before that.  A paint through such a clip is the same as showing
+ * the glyphs with the source through the earlier clip, which uses the
+ * cached glyph masks instead of tessellating the outlines again.
+ */
+typedef struct _cairo_gstate_glyph_clip {
+    cairo_reference_count_t ref_count;
+    cairo_clip_t *clip;
+    cairo_scaled_font_t *scaled_font;
+    int num_glyphs;
+    cairo_glyph_t glyphs[1];
+} cairo_gstate_glyph_clip_t;
+
+static void
+_cairo_gstate_glyph_clip_destroy (cairo_gstate_glyph_clip_t *glyph_clip)
+{
+    if (glyph_clip == NULL)
+	return;
+
+    if (! _cairo_reference_count_dec_and_test (&glyph_clip->ref_count))
+	return;
+
+    _cairo_clip_destroy (glyph_clip->clip);
+    cairo_scaled_font_destroy (glyph_clip->scaled_font);
+    free (glyph_clip);
+}
+
+static void
+_cairo_gstate_forget_glyph_clip (cairo_gstate_t *gstate)
+{
+    _cairo_gstate_glyph_clip_destroy (gstate->glyph_clip);
+    gstate->glyph_clip = NULL;
+}
+
 static void
 _cairo_gstate_update_device_transform (cairo_observer_t *observer,
 				       void *arg)
@@ -109,6 +145,7 @@ _cairo_gstate_init (cairo_gstate_t  *gstate,
     _cairo_font_options_init_default (&gstate->font_options);
 
     gstate->clip = NULL;
+    gstate->glyph_clip = NULL;
 
     gstate->target = cairo_surface_reference (target);
     gstate->parent_target = NULL;
@@ -167,6 +204,9 @@ _cairo_gstate_init_copy (cairo_gstate_t *gstate, cairo_gstate_t *other)
     _cairo_font_options_init_copy (&gstate->font_options , &other->font_options);
 
     gstate->clip = _cairo_clip_copy (other->clip);
+    gstate->glyph_clip = other->glyph_clip;
+    if (gstate->glyph_clip != NULL)
+	_cairo_reference_count_inc (&gstate->glyph_clip->ref_count);
 
     gstate->target = cairo_surface_reference (other->target);
     /* parent_target is always set to NULL; it's only ever set by redirect_target */
@@ -204,6 +244,7 @@ _cairo_gstate_fini (cairo_gstate_t *gstate)
     gstate->scaled_font = NULL;
 
     _cairo_clip_destroy (gstate->clip);
+    _cairo_gstate_forget_glyph_clip (gstate);
 
     cairo_list_del (&gstate->device_transform_observer.link);
 
@@ -316,6 +357,7 @@ _cairo_gstate_redirect_target (cairo_gstate_t *gstate, cairo_surface_t *child)
     /* The clip is in surface backend coordinates for the previous target;
      * translate it into the child's backend coordinates. */
     _cairo_clip_destroy (gstate->clip);
+    _cairo_gstate_forget_glyph_clip (gstate);
     gstate->clip = _cairo_clip_copy_with_translation (gstate->next->clip,
 						      child->device_transform.x0 - gstate->parent_target->device_transform.x0,
 						      child->device_transform.y0 - gstate->parent_target->device_transform.y0);
@@ -1087,6 +1129,39 @@ _cairo_gstate_get_pattern_status (const cairo_pattern_t *pattern)
     return pattern->status;
 }
 
+static cairo_status_t
+_cairo_gstate_paint_glyph_clip (cairo_gstate_t		*gstate,
+				cairo_operator_t	 op,
+				const cairo_pattern_t	*pattern)
+{
+    const cairo_gstate_glyph_clip_t *glyph_clip = gstate->glyph_clip;
+    cairo_glyph_t stack_glyphs[CAIRO_STACK_ARRAY_LENGTH (cairo_glyph_t)];
+    cairo_glyph_t *glyphs;
+    cairo_status_t status;
+
+    glyphs = stack_glyphs;
+    if (glyph_clip->num_glyphs > ARRAY_LENGTH (stack_glyphs)) {
+	glyphs = cairo_glyph_allocate (glyph_clip->num_glyphs);
+	if (unlikely (glyphs == NULL))
+	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    memcpy (glyphs, glyph_clip->glyphs,
+	    glyph_clip->num_glyphs * sizeof (cairo_glyph_t));
+
+    status = _cairo_surface_show_text_glyphs (gstate->target, op, pattern,
+					      NULL, 0,
+					      glyphs, glyph_clip->num_glyphs,
+					      NULL, 0, 0,
+					      glyph_clip->scaled_font,
+					      glyph_clip->clip);
+
+    if (glyphs != stack_glyphs)
+	cairo_glyph_free (glyphs);
+
+    return status;
+}
+
 cairo_status_t
 _cairo_gstate_paint (cairo_gstate_t *gstate)
 {
@@ -1113,6 +1188,11 @@ _cairo_gstate_paint (cairo_gstate_t *gstate)
 	pattern = &source_pattern.base;
     }
 
+    /* Outside of the glyphs an unbounded operator would still affect
+     * the area inside the clip, so only bounded ones may use the masks */
+    if (gstate->glyph_clip != NULL && _cairo_operator_bounded_by_mask (op))
+	return _cairo_gstate_paint_glyph_clip (gstate, op, pattern);
+
     return _cairo_surface_paint (gstate->target,
 				 op, pattern,
 				 gstate->clip);
@@ -1607,6 +1687,7 @@ _cairo_gstate_reset_clip (cairo_gstate_t *gstate)
 {
     _cairo_clip_destroy (gstate->clip);
     gstate->clip = NULL;
+    _cairo_gstate_forget_glyph_clip (gstate);
 
     return CAIRO_STATUS_SUCCESS;
 }
@@ -1614,6 +1695,8 @@ _cairo_gstate_reset_clip (cairo_gstate_t *gstate)
 cairo_status_t
 _cairo_gstate_clip (cairo_gstate_t *gstate, cairo_path_fixed_t *path)
 {
+    _cairo_gstate_forget_glyph_clip (gstate);
+
     gstate->clip =
 	_cairo_clip_intersect_path (gstate->clip,
 				    path,
@@ -2131,6 +2214,162 @@ CLEANUP_GLYPHS:
     return status;
 }
 
+static cairo_status_t
+_cairo_gstate_show_glyph_run_fallback (cairo_gstate_t		*gstate,
+				       const cairo_glyph_run_t	*run,
+				       double			 dx,
+				       double			 dy)
+{
+    cairo_glyph_t stack_glyphs[CAIRO_STACK_ARRAY_LENGTH (cairo_glyph_t)];
+    cairo_glyph_t *glyphs;
+    cairo_status_t status;
+    int i;
+
+    glyphs = stack_glyphs;
+    if (run->num_glyphs > ARRAY_LENGTH (stack_glyphs)) {
+	glyphs = cairo_glyph_allocate (run->num_glyphs);
+	if (unlikely (glyphs == NULL))
+	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    for (i = 0; i < run->num_glyphs; i++) {
+	glyphs[i].index = run->glyphs[i].index;
+	glyphs[i].x = run->glyphs[i].x + dx;
+	glyphs[i].y = run->glyphs[i].y + dy;
+    }
+
+    status = _cairo_gstate_show_text_glyphs (gstate,
+					     glyphs, run->num_glyphs,
+					     NULL);
+
+    if (glyphs != stack_glyphs)
+	cairo_glyph_free (glyphs);
+
+    return status;
+}
+
+cairo_status_t
+_cairo_gstate_show_glyph_run (cairo_gstate_t		*gstate,
+			      const cairo_glyph_run_t	*run,
+			      double			 dx,
+			      double			 dy)
+{
+    cairo_glyph_t stack_glyphs[CAIRO_STACK_ARRAY_LENGTH (cairo_glyph_t)];
+    cairo_glyph_run_extents_t run_extents;
+    const cairo_glyph_run_extents_t *saved_extents;
+    cairo_pattern_union_t source_pattern;
+    const cairo_pattern_t *pattern;
+    cairo_rectangle_int_t clip_extents;
+    cairo_matrix_t transform;
+    cairo_glyph_t *glyphs;
+    cairo_operator_t op;
+    cairo_box_t box;
+    cairo_fixed_t fx, fy, pad;
+    double ox, oy;
+    cairo_status_t status;
+    int i;
+
+    status = _cairo_gstate_get_pattern_status (gstate->source);
+    if (unlikely (status))
+	return status;
+
+    if (gstate->op == CAIRO_OPERATOR_DEST)
+	return CAIRO_STATUS_SUCCESS;
+
+    if (_cairo_clip_is_all_clipped (gstate->clip))
+	return CAIRO_STATUS_SUCCESS;
+
+    status = _cairo_gstate_ensure_scaled_font (gstate);
+    if (unlikely (status))
+	return status;
+
+    /* The run is only valid for the linear part of the transformation
+     * it was created with; huge fonts are drawn as paths, see
+     * _cairo_gstate_show_text_glyphs(). */
+    _cairo_glyph_run_get_transform (&transform,
+				    &gstate->font_matrix,
+				    &gstate->ctm,
+				    &gstate->target->device_transform);
+    if (! _cairo_glyph_run_matches (run, gstate->scaled_font, &transform) ||
+	(! cairo_surface_has_show_text_glyphs (gstate->target) &&
+	 _cairo_scaled_font_get_max_scale (gstate->scaled_font) > 10240))
+    {
+	return _cairo_gstate_show_glyph_run_fallback (gstate, run, dx, dy);
+    }
+
+    ox = transform.xx * dx + transform.xy * dy + transform.x0 - run->transform.x0;
+    oy = transform.yx * dx + transform.yy * dy + transform.y0 - run->transform.y0;
+
+    if (run->box.p1.x < run->box.p2.x) {
+	/* Translating the cached bounds may differ from the bounds of the
+	 * translated glyphs by the rounding of the offset, or by a whole
+	 * pixel when glyph positions are rounded. */
+	fx = _cairo_fixed_from_double (ox);
+	fy = _cairo_fixed_from_double (oy);
+	pad = 1;
+	if (_cairo_font_options_get_round_glyph_positions (&gstate->scaled_font->options) == CAIRO_ROUND_GLYPH_POS_ON)
+	    pad = CAIRO_FIXED_ONE;
+	box.p1.x = run->box.p1.x + fx - pad;
+	box.p1.y = run->box.p1.y + fy - pad;
+	box.p2.x = run->box.p2.x + fx + pad;
+	box.p2.y = run->box.p2.y + fy + pad;
+	_cairo_box_round_to_rectangle (&box, &run_extents.extents);
+
+	/* Drop the whole run if none of it can be visible */
+	if (_cairo_gstate_int_clip_extents (gstate, &clip_extents) &&
+	    ! _cairo_rectangle_intersects (&clip_extents, &run_extents.extents))
+	{
+	    return CAIRO_STATUS_SUCCESS;
+	}
+    } else {
+	/* Nothing but blank glyphs */
+	run_extents.extents.x = run_extents.extents.y = 0;
+	run_extents.extents.width = run_extents.extents.height = 0;
+    }
+
+    glyphs = stack_glyphs;
+    if (run->num_glyphs > ARRAY_LENGTH (stack_glyphs)) {
+	glyphs = cairo_glyph_allocate (run->num_glyphs);
+	if (unlikely (glyphs == NULL))
+	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    for (i = 0; i < run->num_glyphs; i++) {
+	glyphs[i].index = run->device_glyphs[i].index;
+	glyphs[i].x = run->device_glyphs[i].x + ox;
+	glyphs[i].y = run->device_glyphs[i].y + oy;
+    }
+
+    op = _reduce_op (gstate);
+    if (op == CAIRO_OPERATOR_CLEAR) {
+	pattern = &_cairo_pattern_clear.base;
+    } else {
+	_cairo_gstate_copy_transformed_source (gstate, &source_pattern.base);
+	pattern = &source_pattern.base;
+    }
+
+    run_extents.glyphs = glyphs;
+    run_extents.num_glyphs = run->num_glyphs;
+    run_extents.overlap = run->overlap;
+
+    saved_extents = gstate->target->glyph_run_extents;
+    gstate->target->glyph_run_extents = &run_extents;
+
+    status = _cairo_surface_show_text_glyphs (gstate->target, op, pattern,
+					      NULL, 0,
+					      glyphs, run->num_glyphs,
+					      NULL, 0, 0,
+					      gstate->scaled_font,
+					      gstate->clip);
+
+    gstate->target->glyph_run_extents = saved_extents;
+
+    if (glyphs != stack_glyphs)
+	cairo_glyph_free (glyphs);
+
+    return status;
+}
+
 cairo_status_t
 _cairo_gstate_glyph_path (cairo_gstate_t      *gstate,
 			  const cairo_glyph_t *glyphs,
@@ -2169,6 +2408,75 @@ _cairo_gstate_glyph_path (cairo_gstate_t      *gstate,
     return status;
 }
 
+cairo_status_t
+_cairo_gstate_clip_glyphs (cairo_gstate_t      *gstate,
+			   const cairo_glyph_t *glyphs,
+			   int		        num_glyphs)
+{
+    cairo_gstate_glyph_clip_t *glyph_clip;
+    cairo_scaled_font_t *scaled_font;
+    cairo_clip_t *clip;
+    cairo_path_fixed_t path;
+    cairo_status_t status;
+
+    status = _cairo_gstate_ensure_scaled_font (gstate);
+    if (unlikely (status))
+	return status;
+
+    scaled_font = gstate->scaled_font;
+
+    glyph_clip = _cairo_malloc_ab_plus_c (num_glyphs, sizeof (cairo_glyph_t),
+					  sizeof (cairo_gstate_glyph_clip_t));
+    if (unlikely (glyph_clip == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    _cairo_gstate_transform_glyphs_to_backend (gstate,
+					       glyphs, num_glyphs,
+					       NULL, 0, 0,
+					       glyph_clip->glyphs,
+					       &glyph_clip->num_glyphs, NULL);
+
+    _cairo_path_fixed_init (&path);
+    status = _cairo_scaled_font_glyph_path (scaled_font,
+					    glyph_clip->glyphs,
+					    glyph_clip->num_glyphs,
+					    &path);
+    if (unlikely (status)) {
+	_cairo_path_fixed_fini (&path);
+	free (glyph_clip);
+	return status;
+    }
+
+    /* Fill the outlines the way the glyph masks are rendered */
+    _cairo_gstate_forget_glyph_clip (gstate);
+    clip = _cairo_clip_copy (gstate->clip);
+    gstate->clip = _cairo_clip_intersect_path (gstate->clip, &path,
+					       CAIRO_FILL_RULE_WINDING,
+					       gstate->tolerance,
+					       scaled_font->options.antialias);
+    _cairo_path_fixed_fini (&path);
+
+    /* Color glyphs are drawn with their own colors and subpixel masks
+     * per channel, neither of which a paint through the clip would do. */
+    if (_cairo_clip_is_all_clipped (gstate->clip) ||
+	_cairo_scaled_font_has_color_glyphs (scaled_font) ||
+	scaled_font->options.antialias == CAIRO_ANTIALIAS_SUBPIXEL ||
+	(! cairo_surface_has_show_text_glyphs (gstate->target) &&
+	 _cairo_scaled_font_get_max_scale (scaled_font) > 10240))
+    {
+	_cairo_clip_destroy (clip);
+	free (glyph_clip);
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    CAIRO_REFERENCE_COUNT_INIT (&glyph_clip->ref_count, 1);
+    glyph_clip->clip = clip;
+    glyph_clip->scaled_font = cairo_scaled_font_reference (scaled_font);
+    gstate->glyph_clip = glyph_clip;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
 cairo_status_t
 _cairo_gstate_set_antialias (cairo_gstate_t *gstate,
 			     cairo_antialias_t antialias)
@@ -2362,13 +2670,12 @@ _cairo_gstate_transform_glyphs_to_backend (cairo_gstate_t	*gstate,
                                &aggregate_transform, device_transform);
 
 	if (! drop || num_clusters == 0) {
+	    _cairo_matrix_transform_glyphs (&aggregate_transform,
+					    glyphs, transformed_glyphs,
+					    num_glyphs);
 	    for (i = 0; i < num_glyphs; i++) {
-		transformed_glyphs[j] = glyphs[i];
-		cairo_matrix_transform_point (&aggregate_transform,
-					      &transformed_glyphs[j].x,
-					      &transformed_glyphs[j].y);
-		if (! drop || KEEP_GLYPH (transformed_glyphs[j]))
-		    j++;
+		if (! drop || KEEP_GLYPH (transformed_glyphs[i]))
+		    transformed_glyphs[j++] = transformed_glyphs[i];
 	    }
 	    memcpy (transformed_clusters, clusters,
 		    num_clusters * sizeof (cairo_text_cluster_t));
@@ -2384,11 +2691,6 @@ _cairo_gstate_transform_glyphs_to_backend (cairo_gstate_t	*gstate,
 		cairo_bool_t cluster_visible = FALSE;
 		for (k = 0; k < clusters[i].num_glyphs; k++) {
 		    transformed_glyphs[j+k] = *cur_glyph;
-		    cairo_matrix_transform_point (&aggregate_transform,
-						  &transformed_glyphs[j+k].x,
-						  &transformed_glyphs[j+k].y);
-		    if (KEEP_GLYPH (transformed_glyphs[j+k]))
-			cluster_visible = TRUE;
 
 		    if (cluster_flags & CAIRO_TEXT_CLUSTER_FLAG_BACKWARD)
 			cur_glyph--;
@@ -2396,6 +2698,15 @@ _cairo_gstate_transform_glyphs_to_backend (cairo_gstate_t	*gstate,
 			cur_glyph++;
 		}
 
+		_cairo_matrix_transform_glyphs (&aggregate_transform,
+						transformed_glyphs + j,
+						transformed_glyphs + j,
+						k);
+		for (k = 0; k < clusters[i].num_glyphs; k++) {
+		    if (KEEP_GLYPH (transformed_glyphs[j+k]))
+			cluster_visible = TRUE;
+		}
+
 		transformed_clusters[i] = clusters[i];
 		if (cluster_visible)
 		    j += k;
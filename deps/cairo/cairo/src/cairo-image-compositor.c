@@ -44,6 +44,7 @@
 #include "cairoint.h"
 
 #include "cairo-image-surface-private.h"
+#include "cairo-list-inline.h"
 
 #include "cairo-compositor-private.h"
 #include "cairo-spans-compositor-private.h"
@@ -54,6 +55,10 @@
 
 #include "cairo-pixman-private.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 static pixman_image_t *
 to_pixman_image (cairo_surface_t *s)
 {
@@ -809,42 +814,68 @@ check_composite_glyphs (const cairo_composite_rectangles_t *extents,
 }
 
 #if HAS_PIXMAN_GLYPHS
-static pixman_glyph_cache_t *global_glyph_cache;
+/* The pixman glyph for a scaled glyph is attached to it, and shares the
+ * image of its surface rather than copying it into a pixman glyph cache.
+ * So the scaled glyph cache is the only store of glyph images, and its
+ * eviction alone decides how long they are kept.
+ */
+typedef struct _cairo_image_glyph_private {
+    cairo_scaled_glyph_private_t base;
+    pixman_image_t *image;
+    const void *glyph;
+} cairo_image_glyph_private_t;
+
+static const int image_glyph_private_key;
 
-static inline pixman_glyph_cache_t *
-get_glyph_cache (void)
+static void
+_cairo_image_glyph_fini (cairo_scaled_glyph_private_t *glyph_private,
+			 cairo_scaled_glyph_t *scaled_glyph,
+			 cairo_scaled_font_t *scaled_font)
 {
-    if (!global_glyph_cache)
-	global_glyph_cache = pixman_glyph_cache_create ();
+    cairo_image_glyph_private_t *priv =
+	(cairo_image_glyph_private_t *) glyph_private;
 
-    return global_glyph_cache;
+    cairo_list_del (&priv->base.link);
+    pixman_glyph_destroy (priv->glyph);
+    free (priv);
 }
 
-void
-_cairo_image_compositor_reset_static_data (void)
+static const void *
+_cairo_image_glyph (cairo_scaled_font_t *scaled_font,
+		    cairo_scaled_glyph_t *scaled_glyph)
 {
-    CAIRO_MUTEX_LOCK (_cairo_glyph_cache_mutex);
+    cairo_image_surface_t *glyph_surface = scaled_glyph->surface;
+    cairo_scaled_glyph_private_t *glyph_private;
+    cairo_image_glyph_private_t *priv;
 
-    if (global_glyph_cache)
-	pixman_glyph_cache_destroy (global_glyph_cache);
-    global_glyph_cache = NULL;
+    glyph_private = _cairo_scaled_glyph_find_private (scaled_glyph,
+						      &image_glyph_private_key);
+    if (glyph_private != NULL) {
+	priv = (cairo_image_glyph_private_t *) glyph_private;
+	if (priv->image == glyph_surface->pixman_image)
+	    return priv->glyph;
 
-    CAIRO_MUTEX_UNLOCK (_cairo_glyph_cache_mutex);
-}
+	/* the glyph has been rendered again since */
+	_cairo_image_glyph_fini (glyph_private, scaled_glyph, scaled_font);
+    }
 
-void
-_cairo_image_scaled_glyph_fini (cairo_scaled_font_t *scaled_font,
-				cairo_scaled_glyph_t *scaled_glyph)
-{
-    CAIRO_MUTEX_LOCK (_cairo_glyph_cache_mutex);
+    priv = _cairo_malloc (sizeof (*priv));
+    if (unlikely (priv == NULL))
+	return NULL;
 
-    if (global_glyph_cache) {
-	pixman_glyph_cache_remove (
-	    global_glyph_cache, scaled_font,
-	    (void *)scaled_glyph->hash_entry.hash);
+    priv->glyph = pixman_glyph_create (glyph_surface->base.device_transform.x0,
+				       glyph_surface->base.device_transform.y0,
+				       glyph_surface->pixman_image);
+    if (unlikely (priv->glyph == NULL)) {
+	free (priv);
+	return NULL;
     }
+    priv->image = glyph_surface->pixman_image;
 
-    CAIRO_MUTEX_UNLOCK (_cairo_glyph_cache_mutex);
+    _cairo_scaled_glyph_attach_private (scaled_glyph, &priv->base,
+					&image_glyph_private_key,
+					_cairo_image_glyph_fini);
+    return priv->glyph;
 }
 
 #define PHASE(x) ((int)(floor (4 * (x + 0.125)) - 4 * floor (x + 0.125)))
@@ -861,7 +892,7 @@ composite_glyphs (void				*_dst,
 		  cairo_composite_glyphs_info_t *info)
 {
     cairo_int_status_t status = CAIRO_INT_STATUS_SUCCESS;
-    pixman_glyph_cache_t *glyph_cache;
+    cairo_scaled_glyph_t *glyph_cache[64];
     pixman_glyph_t pglyphs_stack[CAIRO_STACK_ARRAY_LENGTH (pixman_glyph_t)];
     pixman_glyph_t *pglyphs = pglyphs_stack;
     pixman_glyph_t *pg;
@@ -869,62 +900,45 @@ composite_glyphs (void				*_dst,
 
     TRACE ((stderr, "%s\n", __FUNCTION__));
 
-    CAIRO_MUTEX_LOCK (_cairo_glyph_cache_mutex);
-
-    glyph_cache = get_glyph_cache();
-    if (unlikely (glyph_cache == NULL)) {
-	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
-	goto out_unlock;
-    }
-
-    pixman_glyph_cache_freeze (glyph_cache);
-
     if (info->num_glyphs > ARRAY_LENGTH (pglyphs_stack)) {
 	pglyphs = _cairo_malloc_ab (info->num_glyphs, sizeof (pixman_glyph_t));
-	if (unlikely (pglyphs == NULL)) {
-	    status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
-	    goto out_thaw;
-	}
+	if (unlikely (pglyphs == NULL))
+	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
     }
 
+    /* The scaled font is frozen, so none of its glyphs can be evicted
+     * before they have been composited. */
+    memset (glyph_cache, 0, sizeof (glyph_cache));
     pg = pglyphs;
     for (i = 0; i < info->num_glyphs; i++) {
 	unsigned long index = info->glyphs[i].index;
+	cairo_scaled_glyph_t *scaled_glyph;
 	const void *glyph;
         unsigned long xphase, yphase;
+	int cache_index;
 
         xphase = PHASE(info->glyphs[i].x);
         yphase = PHASE(info->glyphs[i].y);
 
 	index = index | (xphase << 24) | (yphase << 26);
+	cache_index = index % ARRAY_LENGTH (glyph_cache);
 
-	glyph = pixman_glyph_cache_lookup (glyph_cache, info->font, (void *)(uintptr_t)index);
-	if (!glyph) {
-	    cairo_scaled_glyph_t *scaled_glyph;
-	    cairo_image_surface_t *glyph_surface;
-
-	    /* This call can actually end up recursing, so we have to
-	     * drop the mutex around it.
-	     */
-	    CAIRO_MUTEX_UNLOCK (_cairo_glyph_cache_mutex);
+	scaled_glyph = glyph_cache[cache_index];
+	if (scaled_glyph == NULL || scaled_glyph->hash_entry.hash != index) {
 	    status = _cairo_scaled_glyph_lookup (info->font, index,
 						 CAIRO_SCALED_GLYPH_INFO_SURFACE,
 						 NULL, /* foreground color */
 						 &scaled_glyph);
-	    CAIRO_MUTEX_LOCK (_cairo_glyph_cache_mutex);
-
 	    if (unlikely (status))
-		goto out_thaw;
-
-	    glyph_surface = scaled_glyph->surface;
-	    glyph = pixman_glyph_cache_insert (glyph_cache, info->font, (void *)(uintptr_t)index,
-					       glyph_surface->base.device_transform.x0,
-					       glyph_surface->base.device_transform.y0,
-					       glyph_surface->pixman_image);
-	    if (unlikely (!glyph)) {
-		status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
-		goto out_thaw;
-	    }
+		goto out;
+
+	    glyph_cache[cache_index] = scaled_glyph;
+	}
+
+	glyph = _cairo_image_glyph (info->font, scaled_glyph);
+	if (unlikely (glyph == NULL)) {
+	    status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	    goto out;
 	}
 
 	pg->x = POSITION (info->glyphs[i].x);
@@ -936,7 +950,7 @@ composite_glyphs (void				*_dst,
     if (info->use_mask) {
 	pixman_format_code_t mask_format;
 
-	mask_format = pixman_glyph_get_mask_format (glyph_cache, pg - pglyphs, pglyphs);
+	mask_format = pixman_glyph_get_mask_format (NULL, pg - pglyphs, pglyphs);
 
 	pixman_composite_glyphs (_pixman_operator (op),
 				 ((cairo_image_source_t *)_src)->pixman_image,
@@ -946,38 +960,23 @@ composite_glyphs (void				*_dst,
 				 info->extents.x, info->extents.y,
 				 info->extents.x - dst_x, info->extents.y - dst_y,
 				 info->extents.width, info->extents.height,
-				 glyph_cache, pg - pglyphs, pglyphs);
+				 NULL, pg - pglyphs, pglyphs);
     } else {
 	pixman_composite_glyphs_no_mask (_pixman_operator (op),
 					 ((cairo_image_source_t *)_src)->pixman_image,
 					 to_pixman_image (_dst),
 					 src_x, src_y,
 					 - dst_x, - dst_y,
-					 glyph_cache, pg - pglyphs, pglyphs);
+					 NULL, pg - pglyphs, pglyphs);
     }
 
-out_thaw:
-    pixman_glyph_cache_thaw (glyph_cache);
-
+out:
     if (pglyphs != pglyphs_stack)
 	free(pglyphs);
 
-out_unlock:
-    CAIRO_MUTEX_UNLOCK (_cairo_glyph_cache_mutex);
     return status;
 }
 #else
-void
-_cairo_image_compositor_reset_static_data (void)
-{
-}
-
-void
-_cairo_image_scaled_glyph_fini (cairo_scaled_font_t *scaled_font,
-				cairo_scaled_glyph_t *scaled_glyph)
-{
-}
-
 static cairo_int_status_t
 composite_one_glyph (void				*_dst,
 		     cairo_operator_t			 op,
@@ -2482,6 +2481,277 @@ _blit_xrgb32_lerp_spans (void *abstract_renderer, int y, int h,
     return CAIRO_STATUS_SUCCESS;
 }
 
+/* The remaining in-place renderers replace the per-span pixman calls
+ * of _inplace_spans for the common operators that do not reduce to
+ * a plain fill or copy: OVER and ADD of a solid colour, and OVER of an
+ * image.  Each is specialised for its operator, source and destination
+ * at compile time and the choice is made once per operation, so
+ * rendering a span is just the loop over its pixels.
+ *
+ * These must produce the same pixels as pixman would for the coverage
+ * mask, so unlike the helpers above they round like pixman does.
+ */
+static inline uint8_t
+un8_mul_un8 (uint8_t a, uint8_t b)
+{
+    uint16_t t = a * (uint16_t)b + 0x80;
+    return ((t >> G_SHIFT) + t) >> G_SHIFT;
+}
+
+static inline uint32_t
+un8x4_mul_un8 (uint32_t x, uint8_t a)
+{
+    uint32_t rb = (x & RB_MASK) * a + 0x00800080;
+    uint32_t ag = ((x >> G_SHIFT) & RB_MASK) * a + 0x00800080;
+
+    rb = ((rb + ((rb >> G_SHIFT) & RB_MASK)) >> G_SHIFT) & RB_MASK;
+    ag = (ag + ((ag >> G_SHIFT) & RB_MASK)) & ~RB_MASK;
+    return rb | ag;
+}
+
+static inline uint32_t
+un8x4_add_un8x4 (uint32_t x, uint32_t y)
+{
+    return (add8x2_8x2 (x & RB_MASK, y & RB_MASK) |
+	    add8x2_8x2 ((x >> G_SHIFT) & RB_MASK,
+			(y >> G_SHIFT) & RB_MASK) << G_SHIFT);
+}
+
+#if defined(__SSE2__)
+/* x * a / 255 on eight 16-bit lanes holding 8-bit values */
+static inline __m128i
+un16x8_mul_un16x8 (__m128i x, __m128i a)
+{
+    x = _mm_add_epi16 (_mm_mullo_epi16 (x, a), _mm_set1_epi16 (0x80));
+    return _mm_mulhi_epu16 (x, _mm_set1_epi16 (0x0101));
+}
+
+static inline __m128i
+un8x16_mul_un16 (__m128i x, __m128i a)
+{
+    __m128i zero = _mm_setzero_si128 ();
+
+    return _mm_packus_epi16 (un16x8_mul_un16x8 (_mm_unpacklo_epi8 (x, zero), a),
+			     un16x8_mul_un16x8 (_mm_unpackhi_epi8 (x, zero), a));
+}
+#endif
+
+static inline void
+_over_n_xrgb32_row (uint32_t *d, int len, uint32_t src, uint8_t m)
+{
+    uint32_t s = m == 0xff ? src : un8x4_mul_un8 (src, m);
+    uint8_t ia = ~s >> 24;
+
+#if defined(__SSE2__)
+    if (len >= 4) {
+	__m128i vs = _mm_set1_epi32 (s);
+	__m128i via = _mm_set1_epi16 (ia);
+	do {
+	    __m128i v = _mm_loadu_si128 ((__m128i *) d);
+	    v = _mm_adds_epu8 (vs, un8x16_mul_un16 (v, via));
+	    _mm_storeu_si128 ((__m128i *) d, v);
+	    d += 4, len -= 4;
+	} while (len >= 4);
+    }
+#endif
+
+    while (len-- > 0) {
+	*d = un8x4_add_un8x4 (s, un8x4_mul_un8 (*d, ia));
+	d++;
+    }
+}
+
+static inline void
+_add_n_xrgb32_row (uint32_t *d, int len, uint32_t src, uint8_t m)
+{
+    uint32_t s = m == 0xff ? src : un8x4_mul_un8 (src, m);
+
+#if defined(__SSE2__)
+    if (len >= 4) {
+	__m128i vs = _mm_set1_epi32 (s);
+	do {
+	    __m128i v = _mm_loadu_si128 ((__m128i *) d);
+	    _mm_storeu_si128 ((__m128i *) d, _mm_adds_epu8 (vs, v));
+	    d += 4, len -= 4;
+	} while (len >= 4);
+    }
+#endif
+
+    while (len-- > 0) {
+	*d = un8x4_add_un8x4 (s, *d);
+	d++;
+    }
+}
+
+static inline void
+_over_n_a8_row (uint8_t *d, int len, uint32_t src, uint8_t m)
+{
+    uint8_t s = m == 0xff ? src : un8_mul_un8 (src, m);
+    uint8_t ia = ~s;
+
+#if defined(__SSE2__)
+    if (len >= 16) {
+	__m128i vs = _mm_set1_epi8 (s);
+	__m128i via = _mm_set1_epi16 (ia);
+	do {
+	    __m128i v = _mm_loadu_si128 ((__m128i *) d);
+	    v = _mm_adds_epu8 (vs, un8x16_mul_un16 (v, via));
+	    _mm_storeu_si128 ((__m128i *) d, v);
+	    d += 16, len -= 16;
+	} while (len >= 16);
+    }
+#endif
+
+    while (len-- > 0) {
+	*d = s + un8_mul_un8 (*d, ia);
+	d++;
+    }
+}
+
+static inline void
+_add_n_a8_row (uint8_t *d, int len, uint32_t src, uint8_t m)
+{
+    uint8_t s = m == 0xff ? src : un8_mul_un8 (src, m);
+
+#if defined(__SSE2__)
+    if (len >= 16) {
+	__m128i vs = _mm_set1_epi8 (s);
+	do {
+	    __m128i v = _mm_loadu_si128 ((__m128i *) d);
+	    _mm_storeu_si128 ((__m128i *) d, _mm_adds_epu8 (vs, v));
+	    d += 16, len -= 16;
+	} while (len >= 16);
+    }
+#endif
+
+    while (len-- > 0) {
+	uint16_t t = *d + s;
+	*d++ = t > 0xff ? 0xff : t;
+    }
+}
+
+static inline void
+_over_xrgb32_row (uint32_t *d, const uint32_t *s, int len, uint8_t m)
+{
+#if defined(__SSE2__)
+    if (len >= 4) {
+	__m128i zero = _mm_setzero_si128 ();
+	__m128i alpha = _mm_set1_epi16 (0x00ff);
+	__m128i vm = _mm_set1_epi16 (m);
+	do {
+	    __m128i v = _mm_loadu_si128 ((const __m128i *) s);
+	    __m128i lo = _mm_unpacklo_epi8 (v, zero);
+	    __m128i hi = _mm_unpackhi_epi8 (v, zero);
+	    __m128i ialo, iahi;
+
+	    if (m != 0xff) {
+		lo = un16x8_mul_un16x8 (lo, vm);
+		hi = un16x8_mul_un16x8 (hi, vm);
+	    }
+	    ialo = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (lo, _MM_SHUFFLE (3, 3, 3, 3)),
+					_MM_SHUFFLE (3, 3, 3, 3));
+	    iahi = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (hi, _MM_SHUFFLE (3, 3, 3, 3)),
+					_MM_SHUFFLE (3, 3, 3, 3));
+	    ialo = _mm_xor_si128 (ialo, alpha);
+	    iahi = _mm_xor_si128 (iahi, alpha);
+
+	    v = _mm_loadu_si128 ((__m128i *) d);
+	    v = _mm_packus_epi16 (un16x8_mul_un16x8 (_mm_unpacklo_epi8 (v, zero), ialo),
+				  un16x8_mul_un16x8 (_mm_unpackhi_epi8 (v, zero), iahi));
+	    v = _mm_adds_epu8 (_mm_packus_epi16 (lo, hi), v);
+	    _mm_storeu_si128 ((__m128i *) d, v);
+	    s += 4, d += 4, len -= 4;
+	} while (len >= 4);
+    }
+#endif
+
+    while (len-- > 0) {
+	uint32_t p = m == 0xff ? *s : un8x4_mul_un8 (*s, m);
+	uint8_t ia = ~p >> 24;
+
+	if (ia == 0)
+	    *d = p;
+	else if (ia != 0xff)
+	    *d = un8x4_add_un8x4 (p, un8x4_mul_un8 (*d, ia));
+	else if (p)
+	    *d = un8x4_add_un8x4 (p, *d);
+	s++, d++;
+    }
+}
+
+#define DEFINE_SOLID_SPANS(name, type, row, opacity)			\
+static cairo_status_t							\
+name (void *abstract_renderer, int y, int h,				\
+      const cairo_half_open_span_t *spans, unsigned num_spans)		\
+{									\
+    cairo_image_span_renderer_t *r = abstract_renderer;		\
+									\
+    if (num_spans == 0)							\
+	return CAIRO_STATUS_SUCCESS;					\
+									\
+    do {								\
+	uint8_t a = opacity ? mul8_8 (spans[0].coverage, r->bpp) :	\
+			      spans[0].coverage;			\
+	if (a) {							\
+	    uint8_t *d = r->u.fill.data + r->u.fill.stride*y +		\
+			 spans[0].x * sizeof (type);			\
+	    int len = spans[1].x - spans[0].x;				\
+	    int hh = h;							\
+	    do {							\
+		row ((type *) d, len, r->u.fill.pixel, a);		\
+		d += r->u.fill.stride;					\
+	    } while (--hh);						\
+	}								\
+	spans++;							\
+    } while (--num_spans > 1);						\
+									\
+    return CAIRO_STATUS_SUCCESS;					\
+}
+
+DEFINE_SOLID_SPANS (_over_n_xrgb32_spans, uint32_t, _over_n_xrgb32_row, FALSE)
+DEFINE_SOLID_SPANS (_over_n_xrgb32_opacity_spans, uint32_t, _over_n_xrgb32_row, TRUE)
+DEFINE_SOLID_SPANS (_add_n_xrgb32_spans, uint32_t, _add_n_xrgb32_row, FALSE)
+DEFINE_SOLID_SPANS (_add_n_xrgb32_opacity_spans, uint32_t, _add_n_xrgb32_row, TRUE)
+DEFINE_SOLID_SPANS (_over_n_a8_spans, uint8_t, _over_n_a8_row, FALSE)
+DEFINE_SOLID_SPANS (_over_n_a8_opacity_spans, uint8_t, _over_n_a8_row, TRUE)
+DEFINE_SOLID_SPANS (_add_n_a8_spans, uint8_t, _add_n_a8_row, FALSE)
+DEFINE_SOLID_SPANS (_add_n_a8_opacity_spans, uint8_t, _add_n_a8_row, TRUE)
+
+#define DEFINE_BLIT_SPANS(name, row, opacity)				\
+static cairo_status_t							\
+name (void *abstract_renderer, int y, int h,				\
+      const cairo_half_open_span_t *spans, unsigned num_spans)		\
+{									\
+    cairo_image_span_renderer_t *r = abstract_renderer;		\
+									\
+    if (num_spans == 0)							\
+	return CAIRO_STATUS_SUCCESS;					\
+									\
+    do {								\
+	uint8_t a = opacity ? mul8_8 (spans[0].coverage, r->bpp) :	\
+			      spans[0].coverage;			\
+	if (a) {							\
+	    uint8_t *s = r->u.blit.src_data + r->u.blit.src_stride*y +	\
+			 spans[0].x * 4;				\
+	    uint8_t *d = r->u.blit.data + r->u.blit.stride*y +		\
+			 spans[0].x * 4;				\
+	    int len = spans[1].x - spans[0].x;				\
+	    int hh = h;							\
+	    do {							\
+		row ((uint32_t *) d, (uint32_t *) s, len, a);		\
+		s += r->u.blit.src_stride;				\
+		d += r->u.blit.stride;					\
+	    } while (--hh);						\
+	}								\
+	spans++;							\
+    } while (--num_spans > 1);						\
+									\
+    return CAIRO_STATUS_SUCCESS;					\
+}
+
+DEFINE_BLIT_SPANS (_blit_over_xrgb32_spans, _over_xrgb32_row, FALSE)
+DEFINE_BLIT_SPANS (_blit_over_xrgb32_opacity_spans, _over_xrgb32_row, TRUE)
+
 static cairo_status_t
 _inplace_spans (void *abstract_renderer,
 		int y, int h,
@@ -2884,20 +3154,60 @@ inplace_renderer_init (cairo_image_span_renderer_t	*r,
 	    }
 	    r->u.fill.data = dst->data;
 	    r->u.fill.stride = dst->stride;
+	} else if (composite->op == CAIRO_OPERATOR_OVER ||
+		   composite->op == CAIRO_OPERATOR_ADD) {
+	    cairo_bool_t over = composite->op == CAIRO_OPERATOR_OVER;
+	    cairo_bool_t opacity = r->bpp != 0xff;
+
+	    switch (dst->format) {
+	    case CAIRO_FORMAT_A8:
+		if (over)
+		    r->base.render_rows = opacity ? _over_n_a8_opacity_spans : _over_n_a8_spans;
+		else
+		    r->base.render_rows = opacity ? _add_n_a8_opacity_spans : _add_n_a8_spans;
+		color_to_pixel (color, PIXMAN_a8, &r->u.fill.pixel);
+		break;
+	    case CAIRO_FORMAT_RGB24:
+	    case CAIRO_FORMAT_ARGB32:
+		if (over)
+		    r->base.render_rows = opacity ? _over_n_xrgb32_opacity_spans : _over_n_xrgb32_spans;
+		else
+		    r->base.render_rows = opacity ? _add_n_xrgb32_opacity_spans : _add_n_xrgb32_spans;
+		color_to_pixel (color, PIXMAN_a8r8g8b8, &r->u.fill.pixel);
+		break;
+	    case CAIRO_FORMAT_A1:
+	    case CAIRO_FORMAT_RGB16_565:
+	    case CAIRO_FORMAT_RGB30:
+	    case CAIRO_FORMAT_RGB96F:
+	    case CAIRO_FORMAT_RGBA128F:
+	    case CAIRO_FORMAT_INVALID:
+	    default: break;
+	    }
+	    r->u.fill.data = dst->data;
+	    r->u.fill.stride = dst->stride;
 	}
     } else if ((dst->format == CAIRO_FORMAT_ARGB32 || dst->format == CAIRO_FORMAT_RGB24) &&
 	       (composite->op == CAIRO_OPERATOR_SOURCE ||
-		(composite->op == CAIRO_OPERATOR_OVER &&
-		 (dst->base.is_clear || (dst->base.content & CAIRO_CONTENT_ALPHA) == 0))) &&
+		composite->op == CAIRO_OPERATOR_OVER) &&
 	       composite->source_pattern.base.type == CAIRO_PATTERN_TYPE_SURFACE &&
-	       composite->source_pattern.surface.surface->backend->type == CAIRO_SURFACE_TYPE_IMAGE &&
-	       to_image_surface(composite->source_pattern.surface.surface)->format == dst->format)
+	       composite->source_pattern.surface.surface->backend->type == CAIRO_SURFACE_TYPE_IMAGE)
     {
        cairo_image_surface_t *src =
 	   to_image_surface(composite->source_pattern.surface.surface);
+       cairo_bool_t copy, over;
        int tx, ty;
 
-	if (_cairo_matrix_is_integer_translation(&composite->source_pattern.base.matrix,
+	/* A copy when the source replaces the destination, otherwise
+	 * a premultiplied source is blended over it. */
+	copy = src->format == dst->format &&
+	       (composite->op == CAIRO_OPERATOR_SOURCE ||
+		dst->base.is_clear || (dst->base.content & CAIRO_CONTENT_ALPHA) == 0);
+	over = ! copy &&
+	       composite->op == CAIRO_OPERATOR_OVER &&
+	       src->format == CAIRO_FORMAT_ARGB32;
+
+	if ((copy || over) &&
+	    _cairo_matrix_is_integer_translation(&composite->source_pattern.base.matrix,
 						 &tx, &ty) &&
 	    composite->bounded.x + tx >= 0 &&
 	    composite->bounded.y + ty >= 0 &&
@@ -2909,7 +3219,12 @@ inplace_renderer_init (cairo_image_span_renderer_t	*r,
 	    r->u.blit.data = dst->data;
 	    r->u.blit.src_stride = src->stride;
 	    r->u.blit.src_data = src->data + src->stride * ty + tx * 4;
-	    r->base.render_rows = _blit_xrgb32_lerp_spans;
+	    if (copy)
+		r->base.render_rows = _blit_xrgb32_lerp_spans;
+	    else if (r->bpp == 0xff)
+		r->base.render_rows = _blit_over_xrgb32_spans;
+	    else
+		r->base.render_rows = _blit_over_xrgb32_opacity_spans;
 	}
     }
     if (r->base.render_rows == NULL) {
@@ -54,6 +54,7 @@
 #include "cairo-surface-observer-private.h"
 #include "cairo-surface-snapshot-inline.h"
 #include "cairo-surface-subsurface-private.h"
+#include "cairo-tiled-surface-private.h"
 
 #define PIXMAN_MAX_INT ((pixman_fixed_1 >> 1) - pixman_fixed_e) /* need to ensure deltas also fit */
 
@@ -177,6 +178,32 @@ static struct {
 } cache[16];
 static int n_cached;
 
+/* pixman does not tell the size of its images, so the solid images are
+ * charged against the cache memory budget with a rough estimate. They
+ * are the cheapest entries of all to recreate. */
+#define SOLID_IMAGE_SIZE 256
+
+static void
+_pixman_solid_cache_shrink (size_t size);
+
+static cairo_cache_budget_client_t solid_cache_budget =
+    CAIRO_CACHE_BUDGET_CLIENT_INIT (1, _pixman_solid_cache_shrink);
+
+static void
+_pixman_solid_cache_shrink (size_t size)
+{
+    int n = 0;
+
+    CAIRO_MUTEX_LOCK (_cairo_image_solid_cache_mutex);
+    while (n_cached && n * SOLID_IMAGE_SIZE < size) {
+	pixman_image_unref (cache[--n_cached].image);
+	n++;
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_image_solid_cache_mutex);
+
+    _cairo_cache_budget_release (&solid_cache_budget, n * SOLID_IMAGE_SIZE);
+}
+
 #else  /* !PIXMAN_HAS_ATOMIC_OPS */
 static pixman_image_t *
 _pixman_transparent_image (void)
@@ -250,6 +277,7 @@ _pixman_image_for_color (const cairo_color_t *cairo_color)
 
     if (n_cached < ARRAY_LENGTH (cache)) {
 	i = n_cached++;
+	_cairo_cache_budget_charge (&solid_cache_budget, SOLID_IMAGE_SIZE);
     } else {
 	i = hars_petruska_f54_1_random () % ARRAY_LENGTH (cache);
 	pixman_image_unref (cache[i].image);
@@ -257,6 +285,10 @@ _pixman_image_for_color (const cairo_color_t *cairo_color)
     cache[i].image = pixman_image_ref (image);
     cache[i].color = *cairo_color;
 
+    CAIRO_MUTEX_UNLOCK (_cairo_image_solid_cache_mutex);
+    _cairo_cache_budget_enforce ();
+    return image;
+
 UNLOCK:
     CAIRO_MUTEX_UNLOCK (_cairo_image_solid_cache_mutex);
 #endif
@@ -268,6 +300,7 @@ void
 _cairo_image_reset_static_data (void)
 {
 #if PIXMAN_HAS_ATOMIC_OPS
+    _cairo_cache_budget_release (&solid_cache_budget, n_cached * SOLID_IMAGE_SIZE);
     while (n_cached)
 	pixman_image_unref (cache[--n_cached].image);
 
@@ -915,20 +948,73 @@ create_separable_convolution (int *n_values,
 
 /* ========================================================================== */
 
-static cairo_bool_t
-_pixman_image_set_properties (pixman_image_t *pixman_image,
-			      const cairo_pattern_t *pattern,
+/* Compute the pixman transform for sampling through @pattern an image
+ * that starts at (@x_origin, @y_origin) in pattern space. The origin
+ * is applied after the transform is computed, as an exact integer
+ * translation, so that the samples match those of an image covering
+ * the whole pattern. Only if that is beyond the range of pixman, as
+ * it can be for tiled surfaces, is the origin folded into the matrix.
+ */
+static cairo_int_status_t
+_pixman_transform_for_origin (const cairo_pattern_t *pattern,
 			      const cairo_rectangle_int_t *extents,
-			      int *ix,int *iy)
+			      int x_origin, int y_origin,
+			      pixman_transform_t *pixman_transform,
+			      int *ix, int *iy)
 {
-    pixman_transform_t pixman_transform;
+    double xc = extents->x + extents->width/2.;
+    double yc = extents->y + extents->height/2.;
+    int x_offset = *ix, y_offset = *iy;
+    cairo_matrix_t matrix;
     cairo_int_status_t status;
 
     status = _cairo_matrix_to_pixman_matrix_offset (&pattern->matrix,
 						    pattern->filter,
-						    extents->x + extents->width/2.,
-						    extents->y + extents->height/2.,
-						    &pixman_transform, ix, iy);
+						    xc, yc,
+						    pixman_transform, ix, iy);
+    if (status == CAIRO_INT_STATUS_NOTHING_TO_DO) {
+	*ix -= x_origin;
+	*iy -= y_origin;
+	return status;
+    }
+
+    if ((x_origin | y_origin) == 0)
+	return status;
+
+    if (status == CAIRO_INT_STATUS_SUCCESS &&
+	abs (x_origin) <= PIXMAN_MAX_INT && abs (y_origin) <= PIXMAN_MAX_INT &&
+	pixman_transform_translate (pixman_transform, NULL,
+				    pixman_int_to_fixed (-x_origin),
+				    pixman_int_to_fixed (-y_origin)))
+    {
+	return status;
+    }
+
+    *ix = x_offset;
+    *iy = y_offset;
+    cairo_matrix_init_translate (&matrix, -x_origin, -y_origin);
+    cairo_matrix_multiply (&matrix, &pattern->matrix, &matrix);
+    return _cairo_matrix_to_pixman_matrix_offset (&matrix,
+						  pattern->filter,
+						  xc, yc,
+						  pixman_transform, ix, iy);
+}
+
+/* Set up @pixman_image to be sampled through @pattern, where the image
+ * starts at (@x_origin, @y_origin) in pattern space. */
+static cairo_bool_t
+_pixman_image_set_properties_at (pixman_image_t *pixman_image,
+				 const cairo_pattern_t *pattern,
+				 const cairo_rectangle_int_t *extents,
+				 int x_origin, int y_origin,
+				 int *ix,int *iy)
+{
+    pixman_transform_t pixman_transform;
+    cairo_int_status_t status;
+
+    status = _pixman_transform_for_origin (pattern, extents,
+					   x_origin, y_origin,
+					   &pixman_transform, ix, iy);
     if (status == CAIRO_INT_STATUS_NOTHING_TO_DO)
     {
 	/* If the transform is an identity, we don't need to set it
@@ -1054,6 +1140,16 @@ _pixman_image_set_properties (pixman_image_t *pixman_image,
     return TRUE;
 }
 
+static cairo_bool_t
+_pixman_image_set_properties (pixman_image_t *pixman_image,
+			      const cairo_pattern_t *pattern,
+			      const cairo_rectangle_int_t *extents,
+			      int *ix,int *iy)
+{
+    return _pixman_image_set_properties_at (pixman_image, pattern, extents,
+					    0, 0, ix, iy);
+}
+
 struct proxy {
     cairo_surface_t base;
     cairo_surface_t *image;
@@ -1263,6 +1359,41 @@ done:
     return pixman_image;
 }
 
+/* Read the region of a tiled surface that covers @sample. As with
+ * tiled raster sources, this is limited to sources that are not
+ * repeated or whose sample lies within a single period. */
+static pixman_image_t *
+_pixman_image_for_tiled (const cairo_surface_pattern_t *pattern,
+			 const cairo_rectangle_int_t *extents,
+			 const cairo_rectangle_int_t *sample,
+			 const cairo_rectangle_int_t *limit,
+			 int *ix, int *iy)
+{
+    pixman_image_t *pixman_image;
+    cairo_rectangle_int_t region;
+
+    TRACE ((stderr, "%s\n", __FUNCTION__));
+
+    region = *sample;
+    if (! _cairo_rectangle_intersect (&region, limit))
+	return _pixman_transparent_image ();
+
+    pixman_image = _cairo_tiled_surface_read_region (pattern->surface, &region);
+    if (unlikely (pixman_image == NULL))
+	return NULL;
+
+    /* The image starts at the origin of the region in pattern space. */
+    if (! _pixman_image_set_properties_at (pixman_image,
+					   &pattern->base, extents,
+					   region.x, region.y,
+					   ix, iy)) {
+	pixman_image_unref (pixman_image);
+	pixman_image= NULL;
+    }
+
+    return pixman_image;
+}
+
 static pixman_image_t *
 _pixman_image_for_surface (cairo_image_surface_t *dst,
 			   const cairo_surface_pattern_t *pattern,
@@ -1283,6 +1414,18 @@ _pixman_image_for_surface (cairo_image_surface_t *dst,
 					   is_mask, extents, sample,
 					   ix, iy);
 
+    if (pattern->surface->type == CAIRO_SURFACE_TYPE_TILED) {
+	cairo_rectangle_int_t limit;
+
+	_cairo_surface_get_extents (pattern->surface, &limit);
+	if (extend == CAIRO_EXTEND_NONE ||
+	    _cairo_rectangle_contains_rectangle (&limit, sample))
+	{
+	    return _pixman_image_for_tiled (pattern, extents, sample,
+					    &limit, ix, iy);
+	}
+    }
+
     if (pattern->surface->type == CAIRO_SURFACE_TYPE_IMAGE &&
 	(! is_mask || ! pattern->base.has_component_alpha ||
 	 (pattern->surface->content & CAIRO_CONTENT_COLOR) == 0))
@@ -1485,6 +1628,93 @@ _raster_source_cleanup (pixman_image_t *pixman_image,
     free (data);
 }
 
+/* Assemble the tiles of a tiled raster source that cover @sample. Only
+ * the sampled region is built, so this is limited to sources that are
+ * not repeated or whose sample lies within a single period. */
+static pixman_image_t *
+_pixman_image_for_raster_tiles (cairo_image_surface_t *dst,
+				const cairo_raster_source_pattern_t *pattern,
+				const cairo_rectangle_int_t *extents,
+				const cairo_rectangle_int_t *sample,
+				int *ix, int *iy)
+{
+    pixman_image_t *pixman_image;
+    cairo_image_surface_t *tile;
+    cairo_rectangle_int_t region;
+    cairo_status_t status;
+    int col, row, col_end, row_end;
+
+    TRACE ((stderr, "%s\n", __FUNCTION__));
+
+    region = *sample;
+    if (! _cairo_rectangle_intersect (&region, &pattern->extents))
+	return _pixman_transparent_image ();
+
+    col = region.x / pattern->tile_width;
+    row = region.y / pattern->tile_height;
+    col_end = (region.x + region.width - 1) / pattern->tile_width;
+    row_end = (region.y + region.height - 1) / pattern->tile_height;
+
+    if (col == col_end && row == row_end) {
+	/* Sample straight from the cached tile. */
+	status = _cairo_raster_source_pattern_acquire_tile (&pattern->base,
+							    &dst->base,
+							    col, row, &tile);
+	if (unlikely (status))
+	    return NULL;
+
+	pixman_image = pixman_image_ref (tile->pixman_image);
+	cairo_surface_destroy (&tile->base);
+
+	region.x = col * pattern->tile_width;
+	region.y = row * pattern->tile_height;
+    } else {
+	cairo_format_t format = _cairo_format_from_content (pattern->content);
+
+	pixman_image = pixman_image_create_bits (_cairo_format_to_pixman_format_code (format),
+						 region.width, region.height,
+						 NULL, 0);
+	if (unlikely (pixman_image == NULL))
+	    return NULL;
+
+	for (; row <= row_end; row++) {
+	    int c;
+
+	    for (c = col; c <= col_end; c++) {
+		int x = c * pattern->tile_width;
+		int y = row * pattern->tile_height;
+
+		status = _cairo_raster_source_pattern_acquire_tile (&pattern->base,
+								    &dst->base,
+								    c, row, &tile);
+		if (unlikely (status)) {
+		    pixman_image_unref (pixman_image);
+		    return NULL;
+		}
+
+		pixman_image_composite32 (PIXMAN_OP_SRC,
+					  tile->pixman_image, NULL, pixman_image,
+					  0, 0,
+					  0, 0,
+					  x - region.x, y - region.y,
+					  tile->width, tile->height);
+		cairo_surface_destroy (&tile->base);
+	    }
+	}
+    }
+
+    /* The image starts at the origin of the region in pattern space. */
+    if (! _pixman_image_set_properties_at (pixman_image,
+					   &pattern->base, extents,
+					   region.x, region.y,
+					   ix, iy)) {
+	pixman_image_unref (pixman_image);
+	pixman_image= NULL;
+    }
+
+    return pixman_image;
+}
+
 static pixman_image_t *
 _pixman_image_for_raster (cairo_image_surface_t *dst,
 			  const cairo_raster_source_pattern_t *pattern,
@@ -1504,6 +1734,15 @@ _pixman_image_for_raster (cairo_image_surface_t *dst,
 
     *ix = *iy = 0;
 
+    if (pattern->tile_width &&
+	(pattern->base.extend == CAIRO_EXTEND_NONE ||
+	 _cairo_rectangle_contains_rectangle (&pattern->extents, sample)))
+    {
+	return _pixman_image_for_raster_tiles (dst, pattern,
+					       extents, sample,
+					       ix, iy);
+    }
+
     surface = _cairo_raster_source_pattern_acquire (&pattern->base,
 						    &dst->base, NULL);
     if (unlikely (surface == NULL || surface->status))
@@ -38,6 +38,10 @@
 #include "cairo-error-private.h"
 #include <float.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define PIXMAN_MAX_INT ((pixman_fixed_1 >> 1) - pixman_fixed_e) /* need to ensure deltas also fit */
 
 /**
@@ -417,6 +421,141 @@ cairo_matrix_transform_point (const cairo_matrix_t *matrix, double *x, double *y
 }
 slim_hidden_def(cairo_matrix_transform_point);
 
+/*
+ * Batch versions of cairo_matrix_transform_point() for the loops over
+ * glyph runs and paths.  With SSE2 both coordinates of a point are
+ * transformed by the same packed multiply-adds, computed in the same
+ * order as the scalar code so that the results are identical.
+ */
+
+#if defined(__SSE2__)
+static inline __m128d
+_transform_xy_sse2 (__m128d p, __m128d cx, __m128d cy, __m128d c0)
+{
+    __m128d x = _mm_unpacklo_pd (p, p);
+    __m128d y = _mm_unpackhi_pd (p, p);
+
+    return _mm_add_pd (_mm_add_pd (_mm_mul_pd (x, cx), _mm_mul_pd (y, cy)), c0);
+}
+#endif
+
+/**
+ * _cairo_matrix_transform_points:
+ * @matrix: a #cairo_matrix_t
+ * @src: the points to transform
+ * @dst: the transformed points, may be the same array as @src
+ * @num_points: the number of points
+ *
+ * Transforms each point of @src by @matrix into @dst.
+ **/
+void
+_cairo_matrix_transform_points (const cairo_matrix_t *matrix,
+				const cairo_point_double_t *src,
+				cairo_point_double_t *dst,
+				int num_points)
+{
+    int i;
+#if defined(__SSE2__)
+    __m128d cx = _mm_setr_pd (matrix->xx, matrix->yx);
+    __m128d cy = _mm_setr_pd (matrix->xy, matrix->yy);
+    __m128d c0 = _mm_setr_pd (matrix->x0, matrix->y0);
+
+    for (i = 0; i < num_points; i++)
+	_mm_storeu_pd (&dst[i].x,
+		       _transform_xy_sse2 (_mm_loadu_pd (&src[i].x), cx, cy, c0));
+#else
+    for (i = 0; i < num_points; i++) {
+	double x = src[i].x, y = src[i].y;
+
+	dst[i].x = matrix->xx * x + matrix->xy * y + matrix->x0;
+	dst[i].y = matrix->yx * x + matrix->yy * y + matrix->y0;
+    }
+#endif
+}
+
+/**
+ * _cairo_matrix_transform_glyphs:
+ * @matrix: a #cairo_matrix_t
+ * @src: the glyphs to transform
+ * @dst: the transformed glyphs, may be the same array as @src
+ * @num_glyphs: the number of glyphs
+ *
+ * Copies the glyphs of @src to @dst, transforming their positions by
+ * @matrix.
+ **/
+void
+_cairo_matrix_transform_glyphs (const cairo_matrix_t *matrix,
+				const cairo_glyph_t *src,
+				cairo_glyph_t *dst,
+				int num_glyphs)
+{
+    int i;
+#if defined(__SSE2__)
+    __m128d cx = _mm_setr_pd (matrix->xx, matrix->yx);
+    __m128d cy = _mm_setr_pd (matrix->xy, matrix->yy);
+    __m128d c0 = _mm_setr_pd (matrix->x0, matrix->y0);
+
+    for (i = 0; i < num_glyphs; i++) {
+	dst[i].index = src[i].index;
+	_mm_storeu_pd (&dst[i].x,
+		       _transform_xy_sse2 (_mm_loadu_pd (&src[i].x), cx, cy, c0));
+    }
+#else
+    for (i = 0; i < num_glyphs; i++) {
+	double x = src[i].x, y = src[i].y;
+
+	dst[i].index = src[i].index;
+	dst[i].x = matrix->xx * x + matrix->xy * y + matrix->x0;
+	dst[i].y = matrix->yx * x + matrix->yy * y + matrix->y0;
+    }
+#endif
+}
+
+/**
+ * _cairo_matrix_transform_points_fixed:
+ * @matrix: a #cairo_matrix_t
+ * @points: the fixed point coordinates to transform in place
+ * @num_points: the number of points
+ *
+ * Transforms each point by @matrix, rounding the results back to fixed
+ * point as _cairo_fixed_from_double() does.
+ **/
+void
+_cairo_matrix_transform_points_fixed (const cairo_matrix_t *matrix,
+				      cairo_point_t *points,
+				      int num_points)
+{
+    int i;
+#if defined(__SSE2__) && CAIRO_FIXED_BITS == 32 && ! defined(FLOAT_WORDS_BIGENDIAN)
+    __m128d cx = _mm_setr_pd (matrix->xx, matrix->yx);
+    __m128d cy = _mm_setr_pd (matrix->xy, matrix->yy);
+    __m128d c0 = _mm_setr_pd (matrix->x0, matrix->y0);
+    __m128d unit = _mm_set1_pd (1. / CAIRO_FIXED_ONE_DOUBLE);
+    __m128d magic = _mm_set1_pd (CAIRO_MAGIC_NUMBER_FIXED);
+
+    for (i = 0; i < num_points; i++) {
+	__m128d p;
+
+	p = _mm_cvtepi32_pd (_mm_loadl_epi64 ((__m128i *) &points[i]));
+	p = _transform_xy_sse2 (_mm_mul_pd (p, unit), cx, cy, c0);
+
+	/* the low words of the biased doubles are the fixed values */
+	p = _mm_add_pd (p, magic);
+	_mm_storel_epi64 ((__m128i *) &points[i],
+			  _mm_shuffle_epi32 (_mm_castpd_si128 (p),
+					     _MM_SHUFFLE (3, 1, 2, 0)));
+    }
+#else
+    for (i = 0; i < num_points; i++) {
+	double x = _cairo_fixed_to_double (points[i].x);
+	double y = _cairo_fixed_to_double (points[i].y);
+
+	points[i].x = _cairo_fixed_from_double (matrix->xx * x + matrix->xy * y + matrix->x0);
+	points[i].y = _cairo_fixed_from_double (matrix->yx * x + matrix->yy * y + matrix->y0);
+    }
+#endif
+}
+
 void
 _cairo_matrix_transform_bounding_box (const cairo_matrix_t *matrix,
 				      double *x1, double *y1,
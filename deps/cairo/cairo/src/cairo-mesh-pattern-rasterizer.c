@@ -902,10 +902,10 @@ _cairo_mesh_pattern_rasterize (const cairo_mesh_pattern_t *mesh,
     n = _cairo_array_num_elements (&mesh->patches);
     patch = _cairo_array_index_const (&mesh->patches, 0);
     for (i = 0; i < n; i++) {
+	_cairo_matrix_transform_points (&p2u, &patch->points[0][0],
+					&nodes[0][0], 16);
 	for (j = 0; j < 4; j++) {
 	    for (k = 0; k < 4; k++) {
-		nodes[j][k] = patch->points[j][k];
-		cairo_matrix_transform_point (&p2u, &nodes[j][k].x, &nodes[j][k].y);
 		nodes[j][k].x += x_offset;
 		nodes[j][k].y += y_offset;
 	    }
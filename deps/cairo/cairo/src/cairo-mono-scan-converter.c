@@ -55,13 +55,14 @@ struct polygon {
     /* The vertical clip extents. */
     int32_t ymin, ymax;
 
-    int num_edges;
+    int num_edges, size_edges, keep_edges;
     struct edge *edges;
 
     /* Array of edges all starting in the same bucket.	An edge is put
      * into bucket EDGE_BUCKET_INDEX(edge->ytop, polygon->ymin) when
      * it is added to the polygon. */
     struct edge **y_buckets;
+    unsigned size_y_buckets, keep_y_buckets;
 
     struct edge *y_buckets_embedded[64];
     struct edge edges_embedded[32];
@@ -76,7 +77,7 @@ struct mono_scan_converter {
 
     cairo_half_open_span_t *spans;
     cairo_half_open_span_t spans_embedded[64];
-    int num_spans;
+    int num_spans, size_spans, keep_spans;
 
     /* Clip box. */
     int32_t xmin, xmax;
@@ -121,11 +122,17 @@ polygon_init (struct polygon *polygon, int ymin, int ymax)
 {
     unsigned h = ymax - ymin + 1;
 
-    polygon->y_buckets = polygon->y_buckets_embedded;
-    if (h > ARRAY_LENGTH (polygon->y_buckets_embedded)) {
+    if (h > polygon->size_y_buckets) {
+	if (polygon->y_buckets != polygon->y_buckets_embedded)
+	    free (polygon->y_buckets);
+
 	polygon->y_buckets = _cairo_malloc_ab (h, sizeof (struct edge *));
-	if (unlikely (NULL == polygon->y_buckets))
+	if (unlikely (NULL == polygon->y_buckets)) {
+	    polygon->y_buckets = polygon->y_buckets_embedded;
+	    polygon->size_y_buckets = ARRAY_LENGTH (polygon->y_buckets_embedded);
 	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	}
+	polygon->size_y_buckets = h;
     }
     memset (polygon->y_buckets, 0, h * sizeof (struct edge *));
     polygon->y_buckets[h-1] = (void *)-1;
@@ -145,6 +152,40 @@ polygon_fini (struct polygon *polygon)
 	free (polygon->edges);
 }
 
+/* Releases the memory the following fills are unlikely to need.  The
+ * arrays are kept as long as they are no larger than what recent fills
+ * needed, that amount decaying by a quarter with every smaller fill. */
+static void
+polygon_trim (struct polygon *polygon)
+{
+    unsigned h = polygon->ymax - polygon->ymin + 1;
+
+    polygon->keep_y_buckets -= polygon->keep_y_buckets / 4;
+    if (h > polygon->keep_y_buckets)
+	polygon->keep_y_buckets = h;
+
+    if (polygon->size_y_buckets > polygon->keep_y_buckets &&
+	polygon->y_buckets != polygon->y_buckets_embedded)
+    {
+	free (polygon->y_buckets);
+	polygon->y_buckets = polygon->y_buckets_embedded;
+	polygon->size_y_buckets = ARRAY_LENGTH (polygon->y_buckets_embedded);
+    }
+
+    polygon->keep_edges -= polygon->keep_edges / 4;
+    if (polygon->num_edges > polygon->keep_edges)
+	polygon->keep_edges = polygon->num_edges;
+
+    if (polygon->size_edges > polygon->keep_edges &&
+	polygon->edges != polygon->edges_embedded)
+    {
+	free (polygon->edges);
+	polygon->edges = polygon->edges_embedded;
+	polygon->size_edges = ARRAY_LENGTH (polygon->edges_embedded);
+    }
+    polygon->num_edges = 0;
+}
+
 static void
 _polygon_insert_edge_into_its_y_bucket(struct polygon *polygon,
 				       struct edge *e,
@@ -399,14 +440,19 @@ _mono_scan_converter_init(struct mono_scan_converter *c,
 	return status;
 
     max_num_spans = xmax - xmin + 1;
-    if (max_num_spans > ARRAY_LENGTH(c->spans_embedded)) {
+    if (max_num_spans > c->size_spans) {
+	if (c->spans != c->spans_embedded)
+	    free (c->spans);
+
 	c->spans = _cairo_malloc_ab (max_num_spans,
 				     sizeof (cairo_half_open_span_t));
 	if (unlikely (c->spans == NULL)) {
+	    c->spans = c->spans_embedded;
+	    c->size_spans = ARRAY_LENGTH (c->spans_embedded);
 	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
 	}
-    } else
-	c->spans = c->spans_embedded;
+	c->size_spans = max_num_spans;
+    }
 
     c->xmin = xmin;
     c->xmax = xmax;
@@ -428,6 +474,25 @@ _mono_scan_converter_init(struct mono_scan_converter *c,
     return CAIRO_STATUS_SUCCESS;
 }
 
+/* Sets up the arrays of a new converter, before its first use. */
+static void
+_mono_scan_converter_create(struct mono_scan_converter *c)
+{
+    c->polygon->num_edges = 0;
+    c->polygon->edges = c->polygon->edges_embedded;
+    c->polygon->size_edges = ARRAY_LENGTH (c->polygon->edges_embedded);
+    c->polygon->keep_edges = 0;
+    c->polygon->y_buckets = c->polygon->y_buckets_embedded;
+    c->polygon->size_y_buckets = ARRAY_LENGTH (c->polygon->y_buckets_embedded);
+    c->polygon->keep_y_buckets = 0;
+    c->polygon->ymin = c->polygon->ymax = 0;
+
+    c->spans = c->spans_embedded;
+    c->size_spans = ARRAY_LENGTH (c->spans_embedded);
+    c->keep_spans = 0;
+    c->xmin = c->xmax = 0;
+}
+
 static void
 _mono_scan_converter_fini(struct mono_scan_converter *self)
 {
@@ -437,17 +502,44 @@ _mono_scan_converter_fini(struct mono_scan_converter *self)
     polygon_fini(self->polygon);
 }
 
+/* Prepares a converter that has been used for reuse by a later fill. */
+static void
+_mono_scan_converter_trim(struct mono_scan_converter *self)
+{
+    int max_num_spans = self->xmax - self->xmin + 1;
+
+    self->keep_spans -= self->keep_spans / 4;
+    if (max_num_spans > self->keep_spans)
+	self->keep_spans = max_num_spans;
+
+    if (self->size_spans > self->keep_spans &&
+	self->spans != self->spans_embedded)
+    {
+	free (self->spans);
+	self->spans = self->spans_embedded;
+	self->size_spans = ARRAY_LENGTH (self->spans_embedded);
+    }
+
+    polygon_trim(self->polygon);
+}
+
 static cairo_status_t
 mono_scan_converter_allocate_edges(struct mono_scan_converter *c,
 				   int num_edges)
 
 {
     c->polygon->num_edges = 0;
-    c->polygon->edges = c->polygon->edges_embedded;
-    if (num_edges > ARRAY_LENGTH (c->polygon->edges_embedded)) {
+    if (num_edges > c->polygon->size_edges) {
+	if (c->polygon->edges != c->polygon->edges_embedded)
+	    free (c->polygon->edges);
+
 	c->polygon->edges = _cairo_malloc_ab (num_edges, sizeof (struct edge));
-	if (unlikely (c->polygon->edges == NULL))
+	if (unlikely (c->polygon->edges == NULL)) {
+	    c->polygon->edges = c->polygon->edges_embedded;
+	    c->polygon->size_edges = ARRAY_LENGTH (c->polygon->edges_embedded);
 	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	}
+	c->polygon->size_edges = num_edges;
     }
 
     return CAIRO_STATUS_SUCCESS;
@@ -532,14 +624,34 @@ struct _cairo_mono_scan_converter {
 
 typedef struct _cairo_mono_scan_converter cairo_mono_scan_converter_t;
 
+static cairo_scan_converter_stash_t converter_stash;
+
 static void
 _cairo_mono_scan_converter_destroy (void *converter)
 {
     cairo_mono_scan_converter_t *self = converter;
+
+    if (self->base.status == CAIRO_STATUS_SUCCESS) {
+	_mono_scan_converter_trim (self->converter);
+	if (_cairo_scan_converter_stash_put (&converter_stash, self))
+	    return;
+    }
+
     _mono_scan_converter_fini (self->converter);
     free(self);
 }
 
+void
+_cairo_mono_scan_converter_reset_static_data (void)
+{
+    cairo_mono_scan_converter_t *self;
+
+    while ((self = _cairo_scan_converter_stash_get (&converter_stash))) {
+	_mono_scan_converter_fini (self->converter);
+	free (self);
+    }
+}
+
 cairo_status_t
 _cairo_mono_scan_converter_add_polygon (void		*converter,
 				       const cairo_polygon_t *polygon)
@@ -586,14 +698,21 @@ _cairo_mono_scan_converter_create (int			xmin,
     cairo_mono_scan_converter_t *self;
     cairo_status_t status;
 
-    self = _cairo_malloc (sizeof(struct _cairo_mono_scan_converter));
-    if (unlikely (self == NULL)) {
-	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
-	goto bail_nomem;
+    /* Reuse the workspace of a previous fill when one is available */
+    self = _cairo_scan_converter_stash_get (&converter_stash);
+    if (self == NULL) {
+	self = _cairo_malloc (sizeof(struct _cairo_mono_scan_converter));
+	if (unlikely (self == NULL)) {
+	    status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	    goto bail_nomem;
+	}
+
+	_mono_scan_converter_create (self->converter);
     }
 
     self->base.destroy = _cairo_mono_scan_converter_destroy;
     self->base.generate = _cairo_mono_scan_converter_generate;
+    self->base.status = CAIRO_STATUS_SUCCESS;
 
     status = _mono_scan_converter_init (self->converter,
 					xmin, ymin, xmax, ymax);
@@ -605,6 +724,7 @@ _cairo_mono_scan_converter_create (int			xmin,
     return &self->base;
 
  bail:
+    self->base.status = status;
     self->base.destroy(&self->base);
  bail_nomem:
     return _cairo_scan_converter_create_in_error (status);
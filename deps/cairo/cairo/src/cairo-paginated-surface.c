@@ -49,6 +49,7 @@
 #include "cairo-paginated-surface-private.h"
 #include "cairo-recording-surface-private.h"
 #include "cairo-analysis-surface-private.h"
+#include "cairo-boxes-private.h"
 #include "cairo-error-private.h"
 #include "cairo-image-surface-private.h"
 #include "cairo-surface-subsurface-inline.h"
@@ -349,8 +350,9 @@ _paint_thumbnail_image (cairo_paginated_surface_t *surface,
 }
 
 static cairo_int_status_t
-_paint_fallback_image (cairo_paginated_surface_t *surface,
-		       cairo_rectangle_int_t     *rect)
+_paint_fallback_image (cairo_paginated_surface_t   *surface,
+		       const cairo_rectangle_int_t *rect,
+		       const cairo_clip_t	   *clip)
 {
     double x_scale = surface->base.x_fallback_resolution / surface->target->x_resolution;
     double y_scale = surface->base.y_fallback_resolution / surface->target->y_resolution;
@@ -358,7 +360,6 @@ _paint_fallback_image (cairo_paginated_surface_t *surface,
     cairo_status_t status;
     cairo_surface_t *image;
     cairo_surface_pattern_t pattern;
-    cairo_clip_t *clip;
 
     x = rect->x;
     y = rect->y;
@@ -383,11 +384,9 @@ _paint_fallback_image (cairo_paginated_surface_t *surface,
      * filtering (if possible) to avoid introducing potential artifacts. */
     pattern.base.filter = CAIRO_FILTER_NEAREST;
 
-    clip = _cairo_clip_intersect_rectangle (NULL, rect);
     status = _cairo_surface_paint (surface->target,
 				   CAIRO_OPERATOR_SOURCE,
 				   &pattern.base, clip);
-    _cairo_clip_destroy (clip);
     _cairo_pattern_fini (&pattern.base);
 
 CLEANUP_IMAGE:
@@ -396,6 +395,221 @@ CLEANUP_IMAGE:
     return status;
 }
 
+/* The cost of each fallback image, in fallback pixels, as it means
+ * another replay of the page and another image in the output. */
+#define FALLBACK_IMAGE_COST (64 * 64)
+
+/* How many of the following rectangles are tried as merge candidates
+ * for each rectangle of the unsupported region. */
+#define FALLBACK_MERGE_WINDOW 16
+
+typedef struct _cairo_paginated_fallback {
+    cairo_rectangle_int_t extents;
+    double cost;
+    double best_delta;
+    int best;
+    int prev_live;
+    int next_live;
+    int next;
+    int last;
+    cairo_bool_t merged;
+} cairo_paginated_fallback_t;
+
+static double
+_fallback_cost (cairo_paginated_surface_t   *surface,
+		const cairo_rectangle_int_t *rect)
+{
+    double x_scale = surface->base.x_fallback_resolution / surface->target->x_resolution;
+    double y_scale = surface->base.y_fallback_resolution / surface->target->y_resolution;
+
+    return ceil (rect->width * x_scale) * ceil (rect->height * y_scale) +
+	   FALLBACK_IMAGE_COST;
+}
+
+/* Finds the best merge for @i among the rectangles in its window */
+static void
+_fallback_find_best (cairo_paginated_surface_t  *surface,
+		     cairo_paginated_fallback_t *fallbacks,
+		     int			 i)
+{
+    cairo_paginated_fallback_t *fallback = &fallbacks[i];
+    int j, k;
+
+    fallback->best_delta = 0.;
+    fallback->best = -1;
+    for (j = fallback->next_live, k = 0;
+	 j >= 0 && k < FALLBACK_MERGE_WINDOW;
+	 j = fallbacks[j].next_live, k++)
+    {
+	cairo_rectangle_int_t extents;
+	double delta;
+
+	extents = fallback->extents;
+	_cairo_rectangle_union (&extents, &fallbacks[j].extents);
+	delta = _fallback_cost (surface, &extents) -
+		fallback->cost - fallbacks[j].cost;
+	if (delta < fallback->best_delta) {
+	    fallback->best_delta = delta;
+	    fallback->best = j;
+	}
+    }
+}
+
+/* The best merges are kept in a tournament tree, whose leaves are the
+ * rectangles and whose root is the rectangle with the best merge, the
+ * earliest one on a tie. */
+static int
+_fallback_better (const cairo_paginated_fallback_t *fallbacks,
+		  int a, int b)
+{
+    if (a < 0)
+	return b;
+    if (b < 0)
+	return a;
+    return fallbacks[b].best_delta < fallbacks[a].best_delta ? b : a;
+}
+
+static void
+_fallback_update (cairo_paginated_surface_t  *surface,
+		  cairo_paginated_fallback_t *fallbacks,
+		  int			     *tree,
+		  int			      size,
+		  int			      i)
+{
+    int n = size + i;
+
+    if (fallbacks[i].merged) {
+	tree[n] = -1;
+    } else {
+	_fallback_find_best (surface, fallbacks, i);
+	tree[n] = i;
+    }
+
+    for (n /= 2; n; n /= 2)
+	tree[n] = _fallback_better (fallbacks, tree[2*n], tree[2*n + 1]);
+}
+
+/* Rasterizes the unsupported region into fallback images. The
+ * rectangles of the region are first merged greedily, best merge
+ * first, as long as the pixels added by a merge cost less than the
+ * image it saves, and each image is then painted clipped to its own
+ * rectangles.
+ */
+static cairo_int_status_t
+_paint_fallback_images (cairo_paginated_surface_t *surface,
+			const cairo_region_t	  *region)
+{
+    cairo_paginated_fallback_t *fallbacks;
+    cairo_int_status_t status;
+    int num_rects, size, i, j, k, n;
+    int *tree;
+
+    num_rects = cairo_region_num_rectangles (region);
+    if (num_rects == 0)
+	return CAIRO_INT_STATUS_SUCCESS;
+
+    for (size = 1; size < num_rects; size *= 2)
+	;
+
+    fallbacks = _cairo_malloc_ab (num_rects, sizeof (cairo_paginated_fallback_t));
+    if (unlikely (fallbacks == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    tree = _cairo_malloc_ab (2 * size, sizeof (int));
+    if (unlikely (tree == NULL)) {
+	free (fallbacks);
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    for (i = 0; i < num_rects; i++) {
+	cairo_region_get_rectangle (region, i, &fallbacks[i].extents);
+	fallbacks[i].cost = _fallback_cost (surface, &fallbacks[i].extents);
+	fallbacks[i].prev_live = i - 1;
+	fallbacks[i].next_live = i + 1 < num_rects ? i + 1 : -1;
+	fallbacks[i].next = -1;
+	fallbacks[i].last = i;
+	fallbacks[i].merged = FALSE;
+    }
+
+    /* The rectangles are sorted by bands, so the best candidates for a
+     * merge are within a few places of each other. */
+    for (i = 0; i < size; i++) {
+	if (i < num_rects) {
+	    _fallback_find_best (surface, fallbacks, i);
+	    tree[size + i] = i;
+	} else {
+	    tree[size + i] = -1;
+	}
+    }
+    for (n = size - 1; n; n--)
+	tree[n] = _fallback_better (fallbacks, tree[2*n], tree[2*n + 1]);
+
+    /* Only the rectangles whose window held either of the merged ones
+     * need to find their best merge again. */
+    while ((i = tree[1]) >= 0 && (j = fallbacks[i].best) >= 0) {
+	_cairo_rectangle_union (&fallbacks[i].extents, &fallbacks[j].extents);
+	fallbacks[i].cost = _fallback_cost (surface, &fallbacks[i].extents);
+	fallbacks[fallbacks[i].last].next = j;
+	fallbacks[i].last = fallbacks[j].last;
+	fallbacks[j].merged = TRUE;
+
+	if (fallbacks[j].prev_live >= 0)
+	    fallbacks[fallbacks[j].prev_live].next_live = fallbacks[j].next_live;
+	if (fallbacks[j].next_live >= 0)
+	    fallbacks[fallbacks[j].next_live].prev_live = fallbacks[j].prev_live;
+
+	_fallback_update (surface, fallbacks, tree, size, j);
+	_fallback_update (surface, fallbacks, tree, size, i);
+	for (n = fallbacks[i].prev_live, k = 0;
+	     n >= 0 && k < FALLBACK_MERGE_WINDOW;
+	     n = fallbacks[n].prev_live, k++)
+	{
+	    _fallback_update (surface, fallbacks, tree, size, n);
+	}
+	for (n = fallbacks[j].prev_live, k = 0;
+	     n > i && k < FALLBACK_MERGE_WINDOW;
+	     n = fallbacks[n].prev_live, k++)
+	{
+	    _fallback_update (surface, fallbacks, tree, size, n);
+	}
+    }
+
+    status = CAIRO_INT_STATUS_SUCCESS;
+    for (i = 0; i < num_rects; i++) {
+	cairo_boxes_t boxes;
+	cairo_clip_t *clip;
+
+	if (fallbacks[i].merged)
+	    continue;
+
+	_cairo_boxes_init (&boxes);
+	for (j = i; j >= 0; j = fallbacks[j].next) {
+	    cairo_rectangle_int_t rect;
+	    cairo_box_t box;
+
+	    cairo_region_get_rectangle (region, j, &rect);
+	    _cairo_box_from_rectangle (&box, &rect);
+	    status = _cairo_boxes_add (&boxes, CAIRO_ANTIALIAS_DEFAULT, &box);
+	    if (unlikely (status))
+		break;
+	}
+
+	if (likely (status == CAIRO_INT_STATUS_SUCCESS)) {
+	    clip = _cairo_clip_intersect_boxes (NULL, &boxes);
+	    status = _paint_fallback_image (surface, &fallbacks[i].extents, clip);
+	    _cairo_clip_destroy (clip);
+	}
+	_cairo_boxes_fini (&boxes);
+	if (unlikely (status))
+	    break;
+    }
+
+    free (tree);
+    free (fallbacks);
+
+    return status;
+}
+
 static cairo_int_status_t
 _paint_page (cairo_paginated_surface_t *surface)
 {
@@ -486,6 +700,7 @@ _paint_page (cairo_paginated_surface_t *surface)
     if (has_page_fallback) {
 	cairo_rectangle_int_t extents;
 	cairo_bool_t is_bounded;
+	cairo_clip_t *clip;
 
 	status = surface->backend->set_paginated_mode (surface->target,
 						       CAIRO_PAGINATED_MODE_FALLBACK);
@@ -498,31 +713,23 @@ _paint_page (cairo_paginated_surface_t *surface)
 	    goto FAIL;
 	}
 
-	status = _paint_fallback_image (surface, &extents);
+	clip = _cairo_clip_intersect_rectangle (NULL, &extents);
+	status = _paint_fallback_image (surface, &extents, clip);
+	_cairo_clip_destroy (clip);
 	if (unlikely (status))
 	    goto FAIL;
     }
 
     if (has_finegrained_fallback) {
-        cairo_region_t *region;
-        int num_rects, i;
-
 	status = surface->backend->set_paginated_mode (surface->target,
 		                              CAIRO_PAGINATED_MODE_FALLBACK);
 	if (unlikely (status))
 	    goto FAIL;
 
-	region = _cairo_analysis_surface_get_unsupported (analysis);
-
-	num_rects = cairo_region_num_rectangles (region);
-	for (i = 0; i < num_rects; i++) {
-	    cairo_rectangle_int_t rect;
-
-	    cairo_region_get_rectangle (region, i, &rect);
-	    status = _paint_fallback_image (surface, &rect);
-	    if (unlikely (status))
-		goto FAIL;
-	}
+	status = _paint_fallback_images (surface,
+					 _cairo_analysis_surface_get_unsupported (analysis));
+	if (unlikely (status))
+	    goto FAIL;
     }
 
     if (surface->backend->requires_thumbnail_image) {
@@ -130,6 +130,24 @@ _cairo_filler_curve_to (void		*closure,
     return _cairo_spline_decompose (&spline, filler->tolerance);
 }
 
+static cairo_status_t
+_cairo_filler_quad_to (void		*closure,
+		       const cairo_point_t	*p1,
+		       const cairo_point_t	*p2)
+{
+    cairo_filler_t *filler = closure;
+    cairo_point_t p0 = filler->current_point;
+
+    /* The quadratic lies within the triangle of its control points */
+    if (filler->has_limits) {
+	if (! _cairo_spline_intersects (&p0, p1, p1, p2, &filler->limit))
+	    return _cairo_filler_line_to (filler, p2);
+    }
+
+    return _cairo_spline_decompose_quad (_cairo_filler_add_point, filler,
+					 &p0, p1, p2, filler->tolerance);
+}
+
 cairo_status_t
 _cairo_path_fixed_fill_to_polygon (const cairo_path_fixed_t *path,
 				   double tolerance,
@@ -152,12 +170,13 @@ _cairo_path_fixed_fill_to_polygon (const cairo_path_fixed_t *path,
     filler.current_point.y = 0;
     filler.last_move_to = filler.current_point;
 
-    status = _cairo_path_fixed_interpret (path,
-					  _cairo_filler_move_to,
-					  _cairo_filler_line_to,
-					  _cairo_filler_curve_to,
-					  _cairo_filler_close,
-					  &filler);
+    status = _cairo_path_fixed_interpret_quads (path,
+						_cairo_filler_move_to,
+						_cairo_filler_line_to,
+						_cairo_filler_curve_to,
+						_cairo_filler_quad_to,
+						_cairo_filler_close,
+						&filler);
     if (unlikely (status))
 	return status;
 
@@ -49,7 +49,8 @@ enum cairo_path_op {
     CAIRO_PATH_OP_MOVE_TO = 0,
     CAIRO_PATH_OP_LINE_TO = 1,
     CAIRO_PATH_OP_CURVE_TO = 2,
-    CAIRO_PATH_OP_CLOSE_PATH = 3
+    CAIRO_PATH_OP_CLOSE_PATH = 3,
+    CAIRO_PATH_OP_QUAD_TO = 4
 };
 
 /* we want to make sure a single byte is used for the enum */
@@ -113,6 +114,9 @@ struct _cairo_path_fixed {
     cairo_box_t extents;
 
     cairo_path_buf_fixed_t  buf;
+
+    /* Empty buffers kept by _cairo_path_fixed_reset() for reuse */
+    cairo_list_t spare_bufs;
 };
 
 cairo_private void
@@ -69,13 +69,9 @@ _cairo_path_buf_add_points (cairo_path_buf_t       *buf,
 			    const cairo_point_t    *points,
 			    int		            num_points);
 
-void
-_cairo_path_fixed_init (cairo_path_fixed_t *path)
+static void
+_cairo_path_fixed_clear (cairo_path_fixed_t *path)
 {
-    VG (VALGRIND_MAKE_MEM_UNDEFINED (path, sizeof (cairo_path_fixed_t)));
-
-    cairo_list_init (&path->buf.base.link);
-
     path->buf.base.num_ops = 0;
     path->buf.base.num_points = 0;
     path->buf.base.size_ops = ARRAY_LENGTH (path->buf.op);
@@ -100,6 +96,41 @@ _cairo_path_fixed_init (cairo_path_fixed_t *path)
     path->extents.p2.x = path->extents.p2.y = 0;
 }
 
+void
+_cairo_path_fixed_init (cairo_path_fixed_t *path)
+{
+    VG (VALGRIND_MAKE_MEM_UNDEFINED (path, sizeof (cairo_path_fixed_t)));
+
+    cairo_list_init (&path->buf.base.link);
+    cairo_list_init (&path->spare_bufs);
+
+    _cairo_path_fixed_clear (path);
+}
+
+/**
+ * _cairo_path_fixed_reset:
+ * @path: a path
+ *
+ * Empties @path like _cairo_path_fixed_fini() followed by
+ * _cairo_path_fixed_init(), but keeps its buffers so that the next
+ * path built in it does not have to allocate them again.
+ **/
+void
+_cairo_path_fixed_reset (cairo_path_fixed_t *path)
+{
+    cairo_path_buf_t *buf;
+
+    /* Move the buffers in reverse so that they are reused in the order
+     * in which they grew. */
+    while ((buf = cairo_path_tail (path)) != cairo_path_head (path)) {
+	buf->num_ops = 0;
+	buf->num_points = 0;
+	cairo_list_move (&buf->link, &path->spare_bufs);
+    }
+
+    _cairo_path_fixed_clear (path);
+}
+
 cairo_status_t
 _cairo_path_fixed_init_copy (cairo_path_fixed_t *path,
 			     const cairo_path_fixed_t *other)
@@ -110,6 +141,7 @@ _cairo_path_fixed_init_copy (cairo_path_fixed_t *path,
     VG (VALGRIND_MAKE_MEM_UNDEFINED (path, sizeof (cairo_path_fixed_t)));
 
     cairo_list_init (&path->buf.base.link);
+    cairo_list_init (&path->spare_bufs);
 
     path->buf.base.op = path->buf.op;
     path->buf.base.points = path->buf.points;
@@ -347,6 +379,12 @@ _cairo_path_fixed_fini (cairo_path_fixed_t *path)
 	_cairo_path_buf_destroy (this);
     }
 
+    while (! cairo_list_is_empty (&path->spare_bufs)) {
+	buf = cairo_list_first_entry (&path->spare_bufs, cairo_path_buf_t, link);
+	cairo_list_del (&buf->link);
+	_cairo_path_buf_destroy (buf);
+    }
+
     VG (VALGRIND_MAKE_MEM_UNDEFINED (path, sizeof (cairo_path_fixed_t)));
 }
 
@@ -643,6 +681,60 @@ _cairo_path_fixed_rel_curve_to (cairo_path_fixed_t *path,
 				       path->current_point.y + dy2);
 }
 
+cairo_status_t
+_cairo_path_fixed_quad_to (cairo_path_fixed_t	*path,
+			   cairo_fixed_t x1, cairo_fixed_t y1,
+			   cairo_fixed_t x2, cairo_fixed_t y2)
+{
+    cairo_status_t status;
+    cairo_point_t point[2];
+
+    /* make sure subpaths are started properly */
+    if (! path->has_current_point) {
+	status = _cairo_path_fixed_move_to (path, x1, y1);
+	assert (status == CAIRO_STATUS_SUCCESS);
+    }
+
+    /* A control point coincident with either end point cannot bend the
+     * curve away from its chord, so store it as a line-to.
+     */
+    if ((path->current_point.x == x1 && path->current_point.y == y1) ||
+	(x1 == x2 && y1 == y2))
+    {
+	return _cairo_path_fixed_line_to (path, x2, y2);
+    }
+
+    status = _cairo_path_fixed_move_to_apply (path);
+    if (unlikely (status))
+	return status;
+
+    /* If the previous op was a degenerate LINE_TO, drop it. */
+    if (_cairo_path_fixed_last_op (path) == CAIRO_PATH_OP_LINE_TO) {
+	const cairo_point_t *p;
+
+	p = _cairo_path_fixed_penultimate_point (path);
+	if (p->x == path->current_point.x && p->y == path->current_point.y) {
+	    /* previous line element was degenerate, replace */
+	    _cairo_path_fixed_drop_line_to (path);
+	}
+    }
+
+    point[0].x = x1; point[0].y = y1;
+    point[1].x = x2; point[1].y = y2;
+
+    _cairo_box_add_quad_to (&path->extents, &path->current_point,
+			    &point[0], &point[1]);
+
+    path->current_point = point[1];
+    path->has_curve_to = TRUE;
+    path->stroke_is_rectilinear = FALSE;
+    path->fill_is_rectilinear = FALSE;
+    path->fill_maybe_region = FALSE;
+    path->fill_is_empty = FALSE;
+
+    return _cairo_path_fixed_add (path, CAIRO_PATH_OP_QUAD_TO, point, 2);
+}
+
 cairo_status_t
 _cairo_path_fixed_close_path (cairo_path_fixed_t *path)
 {
@@ -700,9 +792,18 @@ _cairo_path_fixed_add (cairo_path_fixed_t   *path,
     if (buf->num_ops + 1 > buf->size_ops ||
 	buf->num_points + num_points > buf->size_points)
     {
-	buf = _cairo_path_buf_create (buf->num_ops * 2, buf->num_points * 2);
-	if (unlikely (buf == NULL))
-	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	if (! cairo_list_is_empty (&path->spare_bufs) &&
+	    cairo_list_first_entry (&path->spare_bufs, cairo_path_buf_t,
+				    link)->size_points >= num_points)
+	{
+	    buf = cairo_list_first_entry (&path->spare_bufs,
+					  cairo_path_buf_t, link);
+	    cairo_list_del (&buf->link);
+	} else {
+	    buf = _cairo_path_buf_create (buf->num_ops * 2, buf->num_points * 2);
+	    if (unlikely (buf == NULL))
+		return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	}
 
 	_cairo_path_fixed_add_buf (path, buf);
     }
@@ -713,6 +814,7 @@ _cairo_path_fixed_add (cairo_path_fixed_t   *path,
 	    "line-to",
 	    "curve-to",
 	    "close-path",
+	    "quad-to",
 	};
 	char buf[1024];
 	int len = 0;
@@ -806,15 +908,29 @@ _cairo_path_buf_add_points (cairo_path_buf_t       *buf,
     buf->num_points += num_points;
 }
 
+static inline cairo_fixed_t
+_quad_control_to_cubic (cairo_fixed_t end, cairo_fixed_t control)
+{
+    return _cairo_fixed_from_double ((_cairo_fixed_to_double (end) +
+				      2 * _cairo_fixed_to_double (control)) / 3);
+}
+
+/* Walks the path, handing quadratic segments to @quad_to when given.
+ * Otherwise they are degree-elevated and passed on to @curve_to, which
+ * describes exactly the same curve.
+ */
 cairo_status_t
-_cairo_path_fixed_interpret (const cairo_path_fixed_t		*path,
-			     cairo_path_fixed_move_to_func_t	*move_to,
-			     cairo_path_fixed_line_to_func_t	*line_to,
-			     cairo_path_fixed_curve_to_func_t	*curve_to,
-			     cairo_path_fixed_close_path_func_t	*close_path,
-			     void				*closure)
+_cairo_path_fixed_interpret_quads (const cairo_path_fixed_t		*path,
+				   cairo_path_fixed_move_to_func_t	*move_to,
+				   cairo_path_fixed_line_to_func_t	*line_to,
+				   cairo_path_fixed_curve_to_func_t	*curve_to,
+				   cairo_path_fixed_quad_to_func_t	*quad_to,
+				   cairo_path_fixed_close_path_func_t	*close_path,
+				   void					*closure)
 {
     const cairo_path_buf_t *buf;
+    cairo_point_t current = { 0, 0 }, last_move = { 0, 0 };
+    cairo_point_t cubic[2];
     cairo_status_t status;
 
     cairo_path_foreach_buf_start (buf, path) {
@@ -825,20 +941,37 @@ _cairo_path_fixed_interpret (const cairo_path_fixed_t		*path,
 	    switch (buf->op[i]) {
 	    case CAIRO_PATH_OP_MOVE_TO:
 		status = (*move_to) (closure, &points[0]);
+		last_move = current = points[0];
 		points += 1;
 		break;
 	    case CAIRO_PATH_OP_LINE_TO:
 		status = (*line_to) (closure, &points[0]);
+		current = points[0];
 		points += 1;
 		break;
 	    case CAIRO_PATH_OP_CURVE_TO:
 		status = (*curve_to) (closure, &points[0], &points[1], &points[2]);
+		current = points[2];
 		points += 3;
 		break;
+	    case CAIRO_PATH_OP_QUAD_TO:
+		if (quad_to) {
+		    status = (*quad_to) (closure, &points[0], &points[1]);
+		} else {
+		    cubic[0].x = _quad_control_to_cubic (current.x, points[0].x);
+		    cubic[0].y = _quad_control_to_cubic (current.y, points[0].y);
+		    cubic[1].x = _quad_control_to_cubic (points[1].x, points[0].x);
+		    cubic[1].y = _quad_control_to_cubic (points[1].y, points[0].y);
+		    status = (*curve_to) (closure, &cubic[0], &cubic[1], &points[1]);
+		}
+		current = points[1];
+		points += 2;
+		break;
 	    default:
 		ASSERT_NOT_REACHED;
 	    case CAIRO_PATH_OP_CLOSE_PATH:
 		status = (*close_path) (closure);
+		current = last_move;
 		break;
 	    }
 
@@ -853,6 +986,23 @@ _cairo_path_fixed_interpret (const cairo_path_fixed_t		*path,
     return CAIRO_STATUS_SUCCESS;
 }
 
+cairo_status_t
+_cairo_path_fixed_interpret (const cairo_path_fixed_t		*path,
+			     cairo_path_fixed_move_to_func_t	*move_to,
+			     cairo_path_fixed_line_to_func_t	*line_to,
+			     cairo_path_fixed_curve_to_func_t	*curve_to,
+			     cairo_path_fixed_close_path_func_t	*close_path,
+			     void				*closure)
+{
+    return _cairo_path_fixed_interpret_quads (path,
+					      move_to,
+					      line_to,
+					      curve_to,
+					      NULL,
+					      close_path,
+					      closure);
+}
+
 typedef struct _cairo_path_fixed_append_closure {
     cairo_point_t	    offset;
     cairo_path_fixed_t	    *path;
@@ -897,6 +1047,20 @@ _append_curve_to (void	  *abstract_closure,
 				       p2->y + closure->offset.y);
 }
 
+static cairo_status_t
+_append_quad_to (void	  *abstract_closure,
+		 const cairo_point_t *p1,
+		 const cairo_point_t *p2)
+{
+    cairo_path_fixed_append_closure_t	*closure = abstract_closure;
+
+    return _cairo_path_fixed_quad_to (closure->path,
+				      p1->x + closure->offset.x,
+				      p1->y + closure->offset.y,
+				      p2->x + closure->offset.x,
+				      p2->y + closure->offset.y);
+}
+
 static cairo_status_t
 _append_close_path (void *abstract_closure)
 {
@@ -917,12 +1081,13 @@ _cairo_path_fixed_append (cairo_path_fixed_t		    *path,
     closure.offset.x = tx;
     closure.offset.y = ty;
 
-    return _cairo_path_fixed_interpret (other,
-					_append_move_to,
-					_append_line_to,
-					_append_curve_to,
-					_append_close_path,
-					&closure);
+    return _cairo_path_fixed_interpret_quads (other,
+					      _append_move_to,
+					      _append_line_to,
+					      _append_curve_to,
+					      _append_quad_to,
+					      _append_close_path,
+					      &closure);
 }
 
 static void
@@ -1042,7 +1207,7 @@ _cairo_path_fixed_transform_point (cairo_point_t *p,
  *
  * Transform the fixed-point path according to the given matrix.
  * There is a fast path for the case where @matrix has no rotation
- * or shear.
+ * or shear and its scale factors are exact in fixed point.
  **/
 void
 _cairo_path_fixed_transform (cairo_path_fixed_t	*path,
@@ -1054,13 +1219,21 @@ _cairo_path_fixed_transform (cairo_path_fixed_t	*path,
     unsigned int i;
 
     if (matrix->yx == 0.0 && matrix->xy == 0.0) {
-	/* Fast path for the common case of scale+transform */
-	_cairo_path_fixed_offset_and_scale (path,
-					    _cairo_fixed_from_double (matrix->x0),
-					    _cairo_fixed_from_double (matrix->y0),
-					    _cairo_fixed_from_double (matrix->xx),
-					    _cairo_fixed_from_double (matrix->yy));
-	return;
+	cairo_fixed_t xx = _cairo_fixed_from_double (matrix->xx);
+	cairo_fixed_t yy = _cairo_fixed_from_double (matrix->yy);
+
+	/* Fast path for the common case of scale+transform.  Small or
+	 * fractional scale factors, such as font units to pixels, would
+	 * lose most of their precision as fixed point multipliers. */
+	if (_cairo_fixed_to_double (xx) == matrix->xx &&
+	    _cairo_fixed_to_double (yy) == matrix->yy)
+	{
+	    _cairo_path_fixed_offset_and_scale (path,
+						_cairo_fixed_from_double (matrix->x0),
+						_cairo_fixed_from_double (matrix->y0),
+						xx, yy);
+	    return;
+	}
     }
 
     _cairo_path_fixed_transform_point (&path->last_move_point, matrix);
@@ -1076,10 +1249,10 @@ _cairo_path_fixed_transform (cairo_path_fixed_t	*path,
     _cairo_box_set (&path->extents, &point, &point);
 
     cairo_path_foreach_buf_start (buf, path) {
-	for (i = 0; i < buf->num_points; i++) {
-	    _cairo_path_fixed_transform_point (&buf->points[i], matrix);
+	_cairo_matrix_transform_points_fixed (matrix,
+					      buf->points, buf->num_points);
+	for (i = 0; i < buf->num_points; i++)
 	    _cairo_box_add_point (&path->extents, &buf->points[i]);
-	}
     } cairo_path_foreach_buf_end (buf, path);
 
     if (path->has_curve_to) {
@@ -1166,6 +1339,18 @@ _cpf_curve_to (void		*closure,
     return _cairo_spline_decompose (&spline, cpf->tolerance);
 }
 
+static cairo_status_t
+_cpf_quad_to (void		*closure,
+	      const cairo_point_t	*p1,
+	      const cairo_point_t	*p2)
+{
+    cpf_t *cpf = closure;
+    cairo_point_t p0 = cpf->current_point;
+
+    return _cairo_spline_decompose_quad (_cpf_add_point, cpf,
+					 &p0, p1, p2, cpf->tolerance);
+}
+
 static cairo_status_t
 _cpf_close_path (void *closure)
 {
@@ -1198,12 +1383,13 @@ _cairo_path_fixed_interpret_flat (const cairo_path_fixed_t		*path,
     flattener.line_to = line_to;
     flattener.close_path = close_path;
     flattener.closure = closure;
-    return _cairo_path_fixed_interpret (path,
-					_cpf_move_to,
-					_cpf_line_to,
-					_cpf_curve_to,
-					_cpf_close_path,
-					&flattener);
+    return _cairo_path_fixed_interpret_quads (path,
+					      _cpf_move_to,
+					      _cpf_line_to,
+					      _cpf_curve_to,
+					      _cpf_quad_to,
+					      _cpf_close_path,
+					      &flattener);
 }
 
 static inline void
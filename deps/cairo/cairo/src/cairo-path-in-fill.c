@@ -235,6 +235,39 @@ _cairo_in_fill_curve_to (void *closure,
     return _cairo_spline_decompose (&spline, in_fill->tolerance);
 }
 
+static cairo_status_t
+_cairo_in_fill_quad_to (void *closure,
+			const cairo_point_t *b,
+			const cairo_point_t *c)
+{
+    cairo_in_fill_t *in_fill = closure;
+    cairo_point_t a = in_fill->current_point;
+    cairo_fixed_t top, bot, left;
+
+    /* first reject based on bbox, as for a cubic, so that the fill and
+     * the hit test flatten the same curves */
+    bot = top = a.y;
+    if (b->y < top) top = b->y;
+    if (b->y > bot) bot = b->y;
+    if (c->y < top) top = c->y;
+    if (c->y > bot) bot = c->y;
+    if (bot < in_fill->y || top > in_fill->y) {
+	in_fill->current_point = *c;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    left = a.x;
+    if (b->x < left) left = b->x;
+    if (c->x < left) left = c->x;
+    if (left > in_fill->x) {
+	in_fill->current_point = *c;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    return _cairo_spline_decompose_quad (_cairo_in_fill_add_point, in_fill,
+					 &a, b, c, in_fill->tolerance);
+}
+
 static cairo_status_t
 _cairo_in_fill_close_path (void *closure)
 {
@@ -267,12 +300,13 @@ _cairo_path_fixed_in_fill (const cairo_path_fixed_t	*path,
 
     _cairo_in_fill_init (&in_fill, tolerance, x, y);
 
-    status = _cairo_path_fixed_interpret (path,
-					  _cairo_in_fill_move_to,
-					  _cairo_in_fill_line_to,
-					  _cairo_in_fill_curve_to,
-					  _cairo_in_fill_close_path,
-					  &in_fill);
+    status = _cairo_path_fixed_interpret_quads (path,
+						_cairo_in_fill_move_to,
+						_cairo_in_fill_line_to,
+						_cairo_in_fill_curve_to,
+						_cairo_in_fill_quad_to,
+						_cairo_in_fill_close_path,
+						&in_fill);
     assert (status == CAIRO_STATUS_SUCCESS);
 
     _cairo_in_fill_close_path (&in_fill);
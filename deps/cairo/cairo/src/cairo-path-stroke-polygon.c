@@ -40,6 +40,7 @@
 #define _DEFAULT_SOURCE /* for hypot() */
 #include "cairoint.h"
 
+#include "cairo-array-private.h"
 #include "cairo-box-inline.h"
 #include "cairo-boxes-private.h"
 #include "cairo-contour-inline.h"
@@ -47,9 +48,22 @@
 #include "cairo-error-private.h"
 #include "cairo-path-fixed-private.h"
 #include "cairo-slope-private.h"
+#include "cairo-stroke-dash-private.h"
 
 #define DEBUG 0
 
+enum dash_op_type {
+    DASH_LINE_TO,
+    DASH_SPLINE_TO,
+    DASH_JOIN,
+};
+
+struct dash_op {
+    enum dash_op_type type;
+    cairo_point_t point;
+    cairo_slope_t slope;
+};
+
 struct stroker {
     cairo_stroke_style_t style;
 
@@ -85,6 +99,20 @@ struct stroker {
 
     cairo_bool_t has_bounds;
     cairo_box_t bounds;
+
+    cairo_stroker_dash_t dash;
+    cairo_point_t dash_first_point;
+    cairo_point_t dash_current_point;
+    cairo_slope_t dash_tangent;
+    cairo_bool_t dash_at_start;
+    cairo_bool_t dash_active;
+    cairo_bool_t dash_degenerate;
+
+    cairo_bool_t first_dash_pending;
+    cairo_bool_t has_first_dash;
+    cairo_point_t first_dash_point;
+    cairo_slope_t first_dash_slope;
+    cairo_array_t first_dash;
 };
 
 static inline double
@@ -1245,6 +1273,458 @@ close_path (void *closure)
     return CAIRO_STATUS_SUCCESS;
 }
 
+/*
+ * Dashed lines.  Each dash is stroked as a sub path of its own, started
+ * where the dash turns on and capped by the next move_to (or the final
+ * add_caps), so the dash pattern is walked once over the path segments.
+ * The points of a flattened curve are added to a dash with spline_to()
+ * like any other spline, that is without computing joins between them.
+ *
+ * The first dash of a sub path is only recorded until the sub path ends,
+ * as a closed sub path that ends with its dash on must join its final
+ * dash to the first one rather than cap both of them.
+ */
+
+static void
+dash_join (struct stroker *stroker,
+	   const cairo_slope_t *slope)
+{
+    cairo_stroke_face_t face;
+
+    compute_face (&stroker->current_face.point, slope, stroker, &face);
+    if (stroker->has_current_face) {
+	int clockwise = _cairo_slope_compare (&stroker->current_face.dev_vector,
+					      &face.dev_vector);
+
+	/* As in line_to(), faces that (nearly) continue one another
+	 * need no join; an inner join would pinch the stroke to its
+	 * centre line */
+	if (clockwise &&
+	    (! within_tolerance (&stroker->current_face.ccw, &face.ccw,
+				 stroker->contour_tolerance) ||
+	     ! within_tolerance (&stroker->current_face.cw, &face.cw,
+				 stroker->contour_tolerance)))
+	{
+	    clockwise = clockwise < 0;
+	    outer_join (stroker, &stroker->current_face, &face, clockwise);
+	    inner_join (stroker, &stroker->current_face, &face, clockwise);
+	}
+    }
+    stroker->current_face = face;
+}
+
+static cairo_status_t
+dash_emit (struct stroker *stroker,
+	   enum dash_op_type type,
+	   const cairo_point_t *point,
+	   const cairo_slope_t *slope)
+{
+    if (stroker->first_dash_pending) {
+	struct dash_op op;
+
+	op.type = type;
+	op.point = *point;
+	op.slope = *slope;
+	return _cairo_array_append (&stroker->first_dash, &op);
+    }
+
+    switch (type) {
+    case DASH_LINE_TO:
+	return line_to (stroker, point);
+    case DASH_SPLINE_TO:
+	return spline_to (stroker, point, slope);
+    case DASH_JOIN:
+    default:
+	dash_join (stroker, slope);
+	return CAIRO_STATUS_SUCCESS;
+    }
+}
+
+static void
+dash_begin (struct stroker *stroker,
+	    const cairo_point_t *point,
+	    const cairo_slope_t *slope)
+{
+    cairo_stroke_face_t face;
+
+    /* Cap the previous dash */
+    move_to (stroker, point);
+
+    compute_face (point, slope, stroker, &face);
+    stroker->has_initial_sub_path = TRUE;
+    stroker->first_face = face;
+    stroker->has_first_face = TRUE;
+    stroker->current_face = face;
+    stroker->has_current_face = TRUE;
+
+    contour_add_point (stroker, &stroker->cw, &face.cw);
+    contour_add_point (stroker, &stroker->ccw, &face.ccw);
+}
+
+static void
+dash_add_piece (struct stroker *stroker,
+		const cairo_stroke_face_t *face,
+		const cairo_point_t *from,
+		const cairo_point_t *to)
+{
+    cairo_stroke_face_t first, last;
+    cairo_point_t offset;
+
+    /* Cap the previous dash */
+    move_to (stroker, from);
+
+    first = *face;
+    offset.x = from->x - face->point.x;
+    offset.y = from->y - face->point.y;
+    translate_point (&first.point, &offset);
+    translate_point (&first.cw, &offset);
+    translate_point (&first.ccw, &offset);
+
+    last = *face;
+    offset.x = to->x - face->point.x;
+    offset.y = to->y - face->point.y;
+    translate_point (&last.point, &offset);
+    translate_point (&last.cw, &offset);
+    translate_point (&last.ccw, &offset);
+
+    /* A dash without joins is a single closed contour */
+    contour_add_point (stroker, &stroker->ccw, &first.ccw);
+    contour_add_point (stroker, &stroker->ccw, &last.ccw);
+    add_trailing_cap (stroker, &last, &stroker->ccw);
+    contour_add_point (stroker, &stroker->ccw, &first.cw);
+    add_leading_cap (stroker, &first, &stroker->ccw);
+
+    _cairo_polygon_add_contour (stroker->polygon, &stroker->ccw.contour);
+    _cairo_contour_reset (&stroker->ccw.contour);
+}
+
+static cairo_status_t
+dash_replay_first (struct stroker *stroker,
+		   cairo_bool_t continues)
+{
+    const struct dash_op *ops;
+    cairo_status_t status;
+    unsigned int i, num_ops;
+
+    stroker->first_dash_pending = FALSE;
+    stroker->has_first_dash = FALSE;
+
+    ops = _cairo_array_index_const (&stroker->first_dash, 0);
+    num_ops = _cairo_array_num_elements (&stroker->first_dash);
+
+    /* A line joins itself to the final dash, a curve does not */
+    if (! continues)
+	dash_begin (stroker, &stroker->first_dash_point, &stroker->first_dash_slope);
+    else if (num_ops && ops[0].type != DASH_LINE_TO)
+	dash_join (stroker, &stroker->first_dash_slope);
+
+    for (i = 0; i < num_ops; i++) {
+	status = dash_emit (stroker, ops[i].type, &ops[i].point, &ops[i].slope);
+	if (unlikely (status))
+	    return status;
+    }
+    _cairo_array_truncate (&stroker->first_dash, 0);
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+dash_end_sub_path (struct stroker *stroker)
+{
+    stroker->dash_active = FALSE;
+
+    if (stroker->has_first_dash)
+	return dash_replay_first (stroker, FALSE);
+
+    if (stroker->dash_degenerate) {
+	/* A sub path without length that starts on gets a round dot */
+	move_to (stroker, &stroker->dash_first_point);
+	stroker->has_initial_sub_path = TRUE;
+	stroker->dash_degenerate = FALSE;
+    }
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_bool_t
+dash_is_visible (struct stroker *stroker,
+		 const cairo_point_t *p1,
+		 const cairo_point_t *p2)
+{
+    cairo_line_t segment;
+
+    if (! stroker->has_bounds ||
+	(_cairo_box_contains_point (&stroker->bounds, p1) &&
+	 _cairo_box_contains_point (&stroker->bounds, p2)))
+	return TRUE;
+
+    segment.p1 = *p1;
+    segment.p2 = *p2;
+    return _cairo_box_intersects_line_segment (&stroker->bounds, &segment);
+}
+
+/* The tangent at @t along a flattened piece of a curve, blended from
+ * the tangents at either end of the piece. The chord of the piece is
+ * only parallel to the curve somewhere in its middle, so it would skew
+ * the face of a dash that starts or ends elsewhere. */
+static void
+dash_curve_tangent (const cairo_slope_t *t0,
+		    const cairo_slope_t *t1,
+		    double t,
+		    const cairo_slope_t *chord,
+		    cairo_slope_t *slope)
+{
+    double x0 = _cairo_fixed_to_double (t0->dx);
+    double y0 = _cairo_fixed_to_double (t0->dy);
+    double x1 = _cairo_fixed_to_double (t1->dx);
+    double y1 = _cairo_fixed_to_double (t1->dy);
+    double m0 = hypot (x0, y0), m1 = hypot (x1, y1);
+    double x, y, m;
+
+    *slope = *chord;
+    if (m0 == 0. || m1 == 0.)
+	return;
+
+    x = (1 - t) * x0 / m0 + t * x1 / m1;
+    y = (1 - t) * y0 / m0 + t * y1 / m1;
+    m = hypot (x, y);
+    if (m < 1e-3)
+	return;
+
+    slope->dx = _cairo_fixed_from_double (x / m * 1024);
+    slope->dy = _cairo_fixed_from_double (y / m * 1024);
+}
+
+static cairo_status_t
+dash_segment (struct stroker *stroker,
+	      enum dash_op_type type,
+	      const cairo_point_t *point,
+	      const cairo_slope_t *tangent)
+{
+    cairo_point_t p1 = stroker->dash_current_point;
+    cairo_slope_t t0 = stroker->dash_tangent;
+    cairo_point_t from, to;
+    cairo_slope_t dev_slope, slope;
+    cairo_stroke_face_t face;
+    cairo_bool_t has_face = FALSE;
+    double dx, dy, udx, udy;
+    double mag, remain, step, t, t_from;
+    cairo_status_t status;
+
+    if (type == DASH_SPLINE_TO)
+	stroker->dash_tangent = *tangent;
+
+    if (p1.x == point->x && p1.y == point->y) {
+	if (stroker->dash_at_start && stroker->dash.dash_on)
+	    stroker->dash_degenerate = TRUE;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    stroker->dash_current_point = *point;
+    stroker->dash_degenerate = FALSE;
+
+    _cairo_slope_init (&dev_slope, &p1, point);
+    if (tangent == NULL)
+	tangent = &dev_slope;
+
+    /* The dash pattern is measured in user space */
+    udx = dx = _cairo_fixed_to_double (dev_slope.dx);
+    udy = dy = _cairo_fixed_to_double (dev_slope.dy);
+    cairo_matrix_transform_distance (stroker->ctm_inverse, &udx, &udy);
+    mag = hypot (udx, udy);
+    if (mag == 0.)
+	return CAIRO_STATUS_SUCCESS;
+
+    from = p1;
+    t_from = 0.;
+    remain = mag;
+    while (remain) {
+	step = MIN (stroker->dash.dash_remain, remain);
+	remain -= step;
+	if (remain) {
+	    t = (mag - remain) / mag;
+
+	    to.x = p1.x + _cairo_fixed_from_double (dx * t);
+	    to.y = p1.y + _cairo_fixed_from_double (dy * t);
+	} else {
+	    t = 1.;
+	    to = *point;
+	}
+
+	if (stroker->dash.dash_on) {
+	    if (type == DASH_LINE_TO && ! stroker->first_dash_pending &&
+		! dash_is_visible (stroker, &from, &to))
+	    {
+		/* nothing of this piece can be seen, so the dash can be
+		 * cut short and restarted by the next visible piece */
+		stroker->dash_active = FALSE;
+	    }
+	    else
+	    {
+		if (type == DASH_LINE_TO && remain &&
+		    ! stroker->dash_active && ! stroker->dash_at_start)
+		{
+		    /* The whole dash lies within this line, so it is
+		     * offset by the face of the line */
+		    if (! has_face)
+			compute_face (&p1, &dev_slope, stroker, &face);
+		    has_face = TRUE;
+
+		    dash_add_piece (stroker, &face, &from, &to);
+		    goto step;
+		}
+
+		if (! stroker->dash_active) {
+		    /* Start a line with the exact slope that line_to()
+		     * will find, so that it does not add a join, and a
+		     * curve with its tangent */
+		    slope = dev_slope;
+		    if (type == DASH_SPLINE_TO)
+			dash_curve_tangent (&t0, tangent, t_from, &dev_slope, &slope);
+		    else if (from.x != to.x || from.y != to.y)
+			_cairo_slope_init (&slope, &from, &to);
+
+		    stroker->dash_active = TRUE;
+		    if (stroker->dash_at_start) {
+			stroker->first_dash_pending = TRUE;
+			stroker->has_first_dash = TRUE;
+			stroker->first_dash_point = from;
+			stroker->first_dash_slope = slope;
+		    } else {
+			dash_begin (stroker, &from, &slope);
+		    }
+		}
+
+		slope = *tangent;
+		if (remain && type == DASH_SPLINE_TO)
+		    dash_curve_tangent (&t0, tangent, t, &dev_slope, &slope);
+		status = dash_emit (stroker, type, &to, &slope);
+		if (unlikely (status))
+		    return status;
+	    }
+	} else {
+	    stroker->dash_active = FALSE;
+	    stroker->first_dash_pending = FALSE;
+	}
+
+step:
+	_cairo_stroker_dash_step (&stroker->dash, step);
+	stroker->dash_at_start = FALSE;
+
+	/* A dash that ends with the segment is only cut by the next
+	 * one, so it is joined to a dash starting with that segment, and
+	 * a dash that starts with the end of the segment is capped along
+	 * it and joined to the next one, as for any other dash continuing
+	 * around a corner.
+	 */
+	if (remain == 0. && stroker->dash.dash_on && ! stroker->dash_active) {
+	    stroker->dash_active = TRUE;
+	    dash_begin (stroker, &to,
+			(tangent->dx | tangent->dy) ? tangent : &dev_slope);
+	}
+
+	from = to;
+	t_from = t;
+    }
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+dash_move_to (void *closure,
+	      const cairo_point_t *point)
+{
+    struct stroker *stroker = closure;
+    cairo_status_t status;
+
+    status = dash_end_sub_path (stroker);
+    if (unlikely (status))
+	return status;
+
+    /* Cap the last dash of the previous sub path */
+    move_to (stroker, point);
+
+    _cairo_stroker_dash_start (&stroker->dash);
+    stroker->dash_first_point = *point;
+    stroker->dash_current_point = *point;
+    stroker->dash_at_start = TRUE;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+dash_line_to (void *closure,
+	      const cairo_point_t *point)
+{
+    return dash_segment (closure, DASH_LINE_TO, point, NULL);
+}
+
+static cairo_status_t
+dash_spline_to (void *closure,
+		const cairo_point_t *point,
+		const cairo_slope_t *tangent)
+{
+    return dash_segment (closure, DASH_SPLINE_TO, point, tangent);
+}
+
+static cairo_status_t
+dash_curve_to (void *closure,
+	       const cairo_point_t *b,
+	       const cairo_point_t *c,
+	       const cairo_point_t *d)
+{
+    struct stroker *stroker = closure;
+    cairo_spline_t spline;
+    cairo_status_t status;
+
+    if (! _cairo_spline_init (&spline, dash_spline_to, stroker,
+			      &stroker->dash_current_point, b, c, d))
+	return dash_line_to (closure, d);
+
+    stroker->dash_tangent = spline.initial_slope;
+
+    /* Join with a dash that continues into the curve */
+    if (stroker->dash_active) {
+	status = dash_emit (stroker, DASH_JOIN,
+			    &stroker->dash_current_point,
+			    &spline.initial_slope);
+	if (unlikely (status))
+	    return status;
+    }
+
+    return _cairo_spline_decompose (&spline, stroker->tolerance);
+}
+
+static cairo_status_t
+dash_close_path (void *closure)
+{
+    struct stroker *stroker = closure;
+    cairo_status_t status;
+
+    status = dash_line_to (stroker, &stroker->dash_first_point);
+    if (unlikely (status))
+	return status;
+
+    if (stroker->first_dash_pending) {
+	/* The dash is on all around, so stroke it as a closed path */
+	status = dash_replay_first (stroker, FALSE);
+	if (unlikely (status))
+	    return status;
+
+	status = close_path (stroker);
+    } else if (stroker->dash_active && stroker->has_first_dash) {
+	/* The final dash continues into the first one */
+	status = dash_replay_first (stroker, TRUE);
+    } else {
+	status = dash_end_sub_path (stroker);
+    }
+
+    stroker->dash_active = FALSE;
+    stroker->dash_degenerate = FALSE;
+
+    return status;
+}
+
 cairo_status_t
 _cairo_path_fixed_stroke_to_polygon (const cairo_path_fixed_t	*path,
 				     const cairo_stroke_style_t	*style,
@@ -1256,15 +1736,6 @@ _cairo_path_fixed_stroke_to_polygon (const cairo_path_fixed_t	*path,
     struct stroker stroker;
     cairo_status_t status;
 
-    if (style->num_dashes) {
-	return _cairo_path_fixed_stroke_dashed_to_polygon (path,
-							   style,
-							   ctm,
-							   ctm_inverse,
-							   tolerance,
-							   polygon);
-    }
-
     stroker.has_bounds = polygon->num_limits;
     if (stroker.has_bounds) {
 	/* Extend the bounds in each direction to account for the maximum area
@@ -1396,12 +1867,33 @@ _cairo_path_fixed_stroke_to_polygon (const cairo_path_fixed_t	*path,
     stroker.contour_tolerance = tolerance;
     stroker.polygon = polygon;
 
-    status = _cairo_path_fixed_interpret (path,
-					  move_to,
-					  line_to,
-					  curve_to,
-					  close_path,
-					  &stroker);
+    _cairo_stroker_dash_init (&stroker.dash, style);
+    if (stroker.dash.dashed) {
+	stroker.dash_at_start = FALSE;
+	stroker.dash_active = FALSE;
+	stroker.dash_degenerate = FALSE;
+	stroker.first_dash_pending = FALSE;
+	stroker.has_first_dash = FALSE;
+	_cairo_array_init (&stroker.first_dash, sizeof (struct dash_op));
+
+	status = _cairo_path_fixed_interpret (path,
+					      dash_move_to,
+					      dash_line_to,
+					      dash_curve_to,
+					      dash_close_path,
+					      &stroker);
+	if (likely (status == CAIRO_STATUS_SUCCESS))
+	    status = dash_end_sub_path (&stroker);
+
+	_cairo_array_fini (&stroker.first_dash);
+    } else {
+	status = _cairo_path_fixed_interpret (path,
+					      move_to,
+					      line_to,
+					      curve_to,
+					      close_path,
+					      &stroker);
+    }
     /* Cap the start and end of the final sub path as needed */
     if (likely (status == CAIRO_STATUS_SUCCESS))
 	add_caps (&stroker);
@@ -175,6 +175,8 @@ typedef struct _cairo_mesh_pattern {
     cairo_bool_t has_color[4];
 } cairo_mesh_pattern_t;
 
+typedef struct _cairo_raster_source_tiles cairo_raster_source_tiles_t;
+
 typedef struct _cairo_raster_source_pattern {
     cairo_pattern_t base;
 
@@ -189,6 +191,13 @@ typedef struct _cairo_raster_source_pattern {
 
     /* an explicit pre-allocated member in preference to the general user-data */
     void *user_data;
+
+    /* Pixels are acquired in tiles of this size and cached under
+     * tiles, or all at once if the size is 0. Copies share the tiles
+     * of the pattern they were made from, and the last of them to be
+     * finished drops them. */
+    int tile_width, tile_height;
+    cairo_raster_source_tiles_t *tiles;
 } cairo_raster_source_pattern_t;
 
 typedef union {
@@ -377,6 +386,15 @@ _cairo_raster_source_pattern_init_copy (cairo_pattern_t *pattern,
 cairo_private void
 _cairo_raster_source_pattern_finish (cairo_pattern_t *abstract_pattern);
 
+cairo_private cairo_status_t
+_cairo_raster_source_pattern_acquire_tile (const cairo_pattern_t *abstract_pattern,
+					   cairo_surface_t *target,
+					   int col, int row,
+					   cairo_image_surface_t **image_out);
+
+cairo_private void
+_cairo_raster_source_pattern_reset_static_data (void);
+
 cairo_private void
 _cairo_debug_print_pattern (FILE *file, const cairo_pattern_t *pattern);
 
@@ -45,6 +45,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <png.h>
+#include <zlib.h>
 
 /**
  * SECTION:cairo-png
@@ -571,6 +572,596 @@ cairo_surface_write_to_png_stream (cairo_surface_t	*surface,
 }
 slim_hidden_def (cairo_surface_write_to_png_stream);
 
+/* Rows are filtered and compressed by PNG encoders in independent
+ * segments of roughly this many bytes of filtered image data. */
+#define PNG_ENCODER_SEGMENT_SIZE (256 * 1024)
+
+typedef struct _cairo_png_segment {
+    cairo_status_t status;
+    cairo_bool_t encoded;
+
+    unsigned char *data;
+    size_t length;
+
+    /* checksum and length of the uncompressed, filtered rows */
+    uLong adler;
+    uLong raw_length;
+} cairo_png_segment_t;
+
+struct _cairo_png_encoder {
+    cairo_status_t status;
+
+    int width;
+    int height;
+    int color_type;
+    int channels;
+
+    /* A private copy of the pixels of the surface */
+    cairo_format_t format;
+    unsigned char *data;
+    int stride;
+
+    int rows_per_segment;
+    int num_segments;
+    cairo_png_segment_t *segments;
+};
+
+static const cairo_png_encoder_t _cairo_png_encoder_nil = {
+    CAIRO_STATUS_NO_MEMORY,	/* status */
+};
+
+static cairo_png_encoder_t *
+_cairo_png_encoder_create_in_error (cairo_status_t status)
+{
+    cairo_png_encoder_t *encoder;
+
+    if (status == CAIRO_STATUS_NO_MEMORY)
+	return (cairo_png_encoder_t *) &_cairo_png_encoder_nil;
+
+    encoder = _cairo_malloc (sizeof (cairo_png_encoder_t));
+    if (unlikely (encoder == NULL)) {
+	_cairo_error_throw (CAIRO_STATUS_NO_MEMORY);
+	return (cairo_png_encoder_t *) &_cairo_png_encoder_nil;
+    }
+
+    *encoder = _cairo_png_encoder_nil;
+    encoder->status = status;
+
+    return encoder;
+}
+
+/**
+ * cairo_png_encoder_create:
+ * @surface: a #cairo_surface_t with pixel contents
+ *
+ * Creates an encoder for writing the current contents of @surface as
+ * a PNG image. The pixels are copied here, so @surface can be drawn
+ * to, or destroyed, as soon as this function returns.
+ *
+ * Unlike cairo_surface_write_to_png_stream(), the expensive work of
+ * filtering and compressing the image is deferred. The image is split
+ * into horizontal segments that are compressed independently of each
+ * other by cairo_png_encoder_encode_segment(). The encoder does not
+ * reference any cairo object, so that function may be called from
+ * other threads, and concurrently for different segments.
+ * cairo_png_encoder_write_to_stream() then writes the PNG image,
+ * compressing any segment that has not been compressed yet.
+ *
+ * Only 8 bits per channel are written, surfaces with deeper formats
+ * are converted first.
+ *
+ * Return value: a newly created #cairo_png_encoder_t. Free with
+ * cairo_png_encoder_destroy(). This function always returns a valid
+ * pointer; if memory cannot be allocated, or @surface has no pixel
+ * contents or is in an error state, a special error object is returned
+ * whose status can be checked with cairo_png_encoder_status().
+ *
+ * Since: 1.18
+ **/
+cairo_png_encoder_t *
+cairo_png_encoder_create (cairo_surface_t *surface)
+{
+    cairo_png_encoder_t *encoder;
+    cairo_image_surface_t *image, *clone;
+    void *image_extra;
+    cairo_int_status_t status;
+    int y, rowbytes;
+
+    if (surface->status)
+	return _cairo_png_encoder_create_in_error (surface->status);
+
+    if (surface->finished)
+	return _cairo_png_encoder_create_in_error (_cairo_error (CAIRO_STATUS_SURFACE_FINISHED));
+
+    status = _cairo_surface_acquire_source_image (surface,
+						  &image,
+						  &image_extra);
+    if (status == CAIRO_INT_STATUS_UNSUPPORTED)
+	return _cairo_png_encoder_create_in_error (_cairo_error (CAIRO_STATUS_SURFACE_TYPE_MISMATCH));
+    else if (unlikely (status))
+	return _cairo_png_encoder_create_in_error (status);
+
+    /* PNG complains about "Image width or height is zero in IHDR" */
+    if (image->width == 0 || image->height == 0) {
+	status = _cairo_error (CAIRO_STATUS_WRITE_ERROR);
+	goto BAIL1;
+    }
+
+    clone = _cairo_image_surface_coerce (image);
+    status = clone->base.status;
+    if (unlikely (status))
+	goto BAIL2;
+
+    encoder = _cairo_malloc (sizeof (cairo_png_encoder_t));
+    if (unlikely (encoder == NULL)) {
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto BAIL2;
+    }
+
+    encoder->status = CAIRO_STATUS_SUCCESS;
+    encoder->width = clone->width;
+    encoder->height = clone->height;
+    encoder->format = clone->format;
+
+    switch (clone->format) {
+    case CAIRO_FORMAT_ARGB32:
+	if (_cairo_image_analyze_transparency (clone) == CAIRO_IMAGE_IS_OPAQUE) {
+	    encoder->color_type = PNG_COLOR_TYPE_RGB;
+	    encoder->channels = 3;
+	} else {
+	    encoder->color_type = PNG_COLOR_TYPE_RGB_ALPHA;
+	    encoder->channels = 4;
+	}
+	encoder->stride = clone->width * 4;
+	break;
+    case CAIRO_FORMAT_RGB24:
+	encoder->color_type = PNG_COLOR_TYPE_RGB;
+	encoder->channels = 3;
+	encoder->stride = clone->width * 4;
+	break;
+    case CAIRO_FORMAT_A8:
+	encoder->color_type = PNG_COLOR_TYPE_GRAY;
+	encoder->channels = 1;
+	encoder->stride = clone->width;
+	break;
+    case CAIRO_FORMAT_INVALID:
+    case CAIRO_FORMAT_A1:
+    case CAIRO_FORMAT_RGB16_565:
+    case CAIRO_FORMAT_RGB30:
+    case CAIRO_FORMAT_RGB96F:
+    case CAIRO_FORMAT_RGBA128F:
+    default:
+	free (encoder);
+	status = _cairo_error (CAIRO_STATUS_INVALID_FORMAT);
+	goto BAIL2;
+    }
+
+    rowbytes = 1 + encoder->width * encoder->channels;
+    encoder->rows_per_segment = MAX (1, PNG_ENCODER_SEGMENT_SIZE / rowbytes);
+    encoder->num_segments = (encoder->height + encoder->rows_per_segment - 1) /
+			    encoder->rows_per_segment;
+
+    encoder->data = _cairo_malloc_ab (encoder->height, encoder->stride);
+    encoder->segments = _cairo_malloc_ab (encoder->num_segments,
+					  sizeof (cairo_png_segment_t));
+    if (unlikely (encoder->data == NULL || encoder->segments == NULL)) {
+	free (encoder->data);
+	free (encoder->segments);
+	free (encoder);
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto BAIL2;
+    }
+    memset (encoder->segments, 0,
+	    encoder->num_segments * sizeof (cairo_png_segment_t));
+
+    for (y = 0; y < encoder->height; y++) {
+	memcpy (encoder->data + y * encoder->stride,
+		clone->data + y * clone->stride,
+		encoder->stride);
+    }
+
+    cairo_surface_destroy (&clone->base);
+    _cairo_surface_release_source_image (surface, image, image_extra);
+
+    return encoder;
+
+BAIL2:
+    cairo_surface_destroy (&clone->base);
+BAIL1:
+    _cairo_surface_release_source_image (surface, image, image_extra);
+
+    return _cairo_png_encoder_create_in_error (status);
+}
+
+/**
+ * cairo_png_encoder_status:
+ * @encoder: a #cairo_png_encoder_t
+ *
+ * Checks whether an error has previously occurred for this encoder.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS, or the error that prevented
+ * the creation of @encoder, see cairo_surface_write_to_png_stream().
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_png_encoder_status (cairo_png_encoder_t *encoder)
+{
+    return encoder->status;
+}
+
+/**
+ * cairo_png_encoder_get_num_segments:
+ * @encoder: a #cairo_png_encoder_t
+ *
+ * Returns the number of segments that the image of @encoder is split
+ * into for compression, see cairo_png_encoder_encode_segment().
+ *
+ * Return value: the number of segments, or 0 if @encoder is in an
+ * error state.
+ *
+ * Since: 1.18
+ **/
+int
+cairo_png_encoder_get_num_segments (cairo_png_encoder_t *encoder)
+{
+    if (encoder->status)
+	return 0;
+
+    return encoder->num_segments;
+}
+
+/* Converts a row of the private copy to PNG pixels, unpremultiplying
+ * and converting native endian ARGB => RGB(A) bytes */
+static void
+_cairo_png_encoder_convert_row (const cairo_png_encoder_t *encoder,
+				int y,
+				uint8_t *row)
+{
+    const uint8_t *src = encoder->data + y * encoder->stride;
+    int x;
+
+    switch (encoder->color_type) {
+    case PNG_COLOR_TYPE_RGB_ALPHA:
+	for (x = 0; x < encoder->width; x++, src += 4, row += 4) {
+	    uint32_t pixel;
+	    uint8_t  alpha;
+
+	    memcpy (&pixel, src, sizeof (uint32_t));
+	    alpha = (pixel & 0xff000000) >> 24;
+	    if (alpha == 0) {
+		row[0] = row[1] = row[2] = row[3] = 0;
+	    } else {
+		row[0] = (((pixel & 0xff0000) >> 16) * 255 + alpha / 2) / alpha;
+		row[1] = (((pixel & 0x00ff00) >>  8) * 255 + alpha / 2) / alpha;
+		row[2] = (((pixel & 0x0000ff) >>  0) * 255 + alpha / 2) / alpha;
+		row[3] = alpha;
+	    }
+	}
+	break;
+
+    case PNG_COLOR_TYPE_RGB:
+	for (x = 0; x < encoder->width; x++, src += 4, row += 3) {
+	    uint32_t pixel;
+
+	    memcpy (&pixel, src, sizeof (uint32_t));
+	    row[0] = (pixel & 0xff0000) >> 16;
+	    row[1] = (pixel & 0x00ff00) >>  8;
+	    row[2] = (pixel & 0x0000ff) >>  0;
+	}
+	break;
+
+    default:
+	memcpy (row, src, encoder->width);
+	break;
+    }
+}
+
+/* Runs deflate() until it has consumed all of its input and completed
+ * @flush, growing the output buffer of @segment as needed. */
+static cairo_status_t
+_cairo_png_segment_deflate (cairo_png_segment_t *segment,
+			    z_stream *zs,
+			    size_t *capacity,
+			    int flush)
+{
+    int ret;
+
+    do {
+	if (zs->avail_out == 0) {
+	    unsigned char *data;
+
+	    data = _cairo_realloc_ab (segment->data, *capacity, 2);
+	    if (unlikely (data == NULL))
+		return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+	    segment->data = data;
+	    zs->next_out = data + *capacity;
+	    zs->avail_out = *capacity;
+	    *capacity *= 2;
+	}
+
+	ret = deflate (zs, flush);
+	if (unlikely (ret == Z_STREAM_ERROR))
+	    return _cairo_error (CAIRO_STATUS_PNG_ERROR);
+    } while (zs->avail_in != 0 || zs->avail_out == 0 ||
+	     (flush == Z_FINISH && ret != Z_STREAM_END));
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * cairo_png_encoder_encode_segment:
+ * @encoder: a #cairo_png_encoder_t
+ * @segment: the index of the segment to compress, between 0 and the
+ *   value returned by cairo_png_encoder_get_num_segments() minus 1
+ *
+ * Filters and compresses the rows of the given segment of the image.
+ * Each segment is compressed as an independent part of the PNG data
+ * stream, which is ended by a flush, so that the compressed segments
+ * can simply be written one after the other.
+ *
+ * This function can be called from any thread, and concurrently for
+ * different segments of the same encoder. It must not be called
+ * concurrently with cairo_png_encoder_write_to_stream() or
+ * cairo_png_encoder_destroy().
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS if the segment was compressed
+ * successfully. Otherwise, %CAIRO_STATUS_NO_MEMORY if memory could
+ * not be allocated, %CAIRO_STATUS_INVALID_INDEX if @segment is out of
+ * range, or the error status of @encoder.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_png_encoder_encode_segment (cairo_png_encoder_t	*encoder,
+				  int			 segment)
+{
+    cairo_png_segment_t *seg;
+    cairo_status_t status;
+    uint8_t *scratch, *prev, *row, *filtered;
+    size_t capacity;
+    z_stream zs;
+    int rowbytes, y, y1, i;
+
+    if (encoder->status)
+	return encoder->status;
+
+    if (unlikely (segment < 0 || segment >= encoder->num_segments))
+	return _cairo_error (CAIRO_STATUS_INVALID_INDEX);
+
+    seg = &encoder->segments[segment];
+    if (seg->encoded)
+	return seg->status;
+
+    rowbytes = encoder->width * encoder->channels;
+    y = segment * encoder->rows_per_segment;
+    y1 = MIN (y + encoder->rows_per_segment, encoder->height);
+
+    scratch = _cairo_malloc_ab (3, rowbytes + 1);
+    if (unlikely (scratch == NULL)) {
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto DONE;
+    }
+    prev = scratch;
+    row = prev + rowbytes + 1;
+    filtered = row + rowbytes + 1;
+
+    /* Every row uses the Up filter, which for the first row of the
+     * image is the same as no filter at all. */
+    if (y > 0)
+	_cairo_png_encoder_convert_row (encoder, y - 1, prev);
+    else
+	memset (prev, 0, rowbytes);
+
+    memset (&zs, 0, sizeof (zs));
+    if (deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+		      -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+	free (scratch);
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto DONE;
+    }
+
+    seg->raw_length = (uLong) (y1 - y) * (rowbytes + 1);
+    seg->adler = adler32 (0, NULL, 0);
+
+    /* room for the flush marker on top of the worst case expansion */
+    capacity = deflateBound (&zs, seg->raw_length) + 16;
+    seg->data = _cairo_malloc (capacity);
+    if (unlikely (seg->data == NULL)) {
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto CLEANUP;
+    }
+    zs.next_out = seg->data;
+    zs.avail_out = capacity;
+
+    status = CAIRO_STATUS_SUCCESS;
+    for (; y < y1; y++) {
+	uint8_t *tmp;
+
+	_cairo_png_encoder_convert_row (encoder, y, row);
+
+	filtered[0] = 2; /* PNG_FILTER_VALUE_UP */
+	for (i = 0; i < rowbytes; i++)
+	    filtered[i + 1] = row[i] - prev[i];
+
+	seg->adler = adler32 (seg->adler, filtered, rowbytes + 1);
+
+	zs.next_in = filtered;
+	zs.avail_in = rowbytes + 1;
+	status = _cairo_png_segment_deflate (seg, &zs, &capacity, Z_NO_FLUSH);
+	if (unlikely (status))
+	    goto CLEANUP;
+
+	tmp = prev;
+	prev = row;
+	row = tmp;
+    }
+
+    /* Only the final segment terminates the stream, the others end on
+     * a byte boundary so that the next one can directly follow. */
+    status = _cairo_png_segment_deflate (seg, &zs, &capacity,
+					 segment == encoder->num_segments - 1 ?
+					 Z_FINISH : Z_SYNC_FLUSH);
+    seg->length = zs.total_out;
+
+CLEANUP:
+    deflateEnd (&zs);
+    free (scratch);
+DONE:
+    if (unlikely (status)) {
+	free (seg->data);
+	seg->data = NULL;
+    }
+    seg->status = status;
+    seg->encoded = TRUE;
+
+    return status;
+}
+
+/**
+ * cairo_png_encoder_write_to_stream:
+ * @encoder: a #cairo_png_encoder_t
+ * @write_func: a #cairo_write_func_t
+ * @closure: closure data for the write function
+ *
+ * Writes the image of @encoder as a PNG image to the write function.
+ * Each segment is written as soon as it is compressed; segments that
+ * have not been compressed by cairo_png_encoder_encode_segment() yet
+ * are compressed here.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS if the PNG image was written
+ * successfully. Otherwise, %CAIRO_STATUS_NO_MEMORY if memory could not
+ * be allocated, the error returned by @write_func, or
+ * %CAIRO_STATUS_PNG_ERROR if libpng returned an error.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_png_encoder_write_to_stream (cairo_png_encoder_t	*encoder,
+				   cairo_write_func_t	 write_func,
+				   void			*closure)
+{
+    static const png_byte zlib_header[2] = { 0x78, 0x9c };
+    struct png_write_closure_t png_closure;
+    cairo_status_t status;
+    png_struct *png;
+    png_info *info;
+    png_color_16 white;
+    png_byte zlib_trailer[4];
+    uLong adler;
+    int i;
+
+    if (encoder->status)
+	return encoder->status;
+
+    status = CAIRO_STATUS_SUCCESS;
+    png = png_create_write_struct (PNG_LIBPNG_VER_STRING, &status,
+	                           png_simple_error_callback,
+	                           png_simple_warning_callback);
+    if (unlikely (png == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    info = png_create_info_struct (png);
+    if (unlikely (info == NULL)) {
+	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	goto BAIL;
+    }
+
+#ifdef PNG_SETJMP_SUPPORTED
+    if (setjmp (png_jmpbuf (png)))
+	goto BAIL;
+#endif
+
+    png_closure.write_func = write_func;
+    png_closure.closure = closure;
+    png_set_write_fn (png, &png_closure,
+		      stream_write_func, png_simple_output_flush_fn);
+
+    png_set_IHDR (png, info,
+		  encoder->width,
+		  encoder->height, 8,
+		  encoder->color_type,
+		  PNG_INTERLACE_NONE,
+		  PNG_COMPRESSION_TYPE_DEFAULT,
+		  PNG_FILTER_TYPE_DEFAULT);
+
+    white.gray = 0xff;
+    white.red = white.blue = white.green = white.gray;
+    png_set_bKGD (png, info, &white);
+
+    png_write_info (png, info);
+
+    /* The segments are written as one IDAT chunk each, and together
+     * form a single zlib stream: its header precedes the first one and
+     * the checksum of all of them follows the last one. */
+    adler = adler32 (0, NULL, 0);
+    for (i = 0; i < encoder->num_segments; i++) {
+	cairo_png_segment_t *seg = &encoder->segments[i];
+	cairo_bool_t is_first = i == 0;
+	cairo_bool_t is_last = i == encoder->num_segments - 1;
+	png_uint_32 length;
+
+	status = cairo_png_encoder_encode_segment (encoder, i);
+	if (unlikely (status))
+	    goto BAIL;
+
+	adler = adler32_combine (adler, seg->adler, seg->raw_length);
+
+	length = seg->length;
+	if (is_first)
+	    length += sizeof (zlib_header);
+	if (is_last)
+	    length += sizeof (zlib_trailer);
+
+	png_write_chunk_start (png, (png_const_bytep) "IDAT", length);
+	if (is_first)
+	    png_write_chunk_data (png, zlib_header, sizeof (zlib_header));
+	png_write_chunk_data (png, seg->data, seg->length);
+	if (is_last) {
+	    zlib_trailer[0] = adler >> 24;
+	    zlib_trailer[1] = adler >> 16;
+	    zlib_trailer[2] = adler >> 8;
+	    zlib_trailer[3] = adler;
+	    png_write_chunk_data (png, zlib_trailer, sizeof (zlib_trailer));
+	}
+	png_write_chunk_end (png);
+    }
+
+    png_write_chunk (png, (png_const_bytep) "IEND", NULL, 0);
+
+BAIL:
+    png_destroy_write_struct (&png, &info);
+
+    return status;
+}
+
+/**
+ * cairo_png_encoder_destroy:
+ * @encoder: a #cairo_png_encoder_t
+ *
+ * Frees @encoder and its copy of the image.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_png_encoder_destroy (cairo_png_encoder_t *encoder)
+{
+    int i;
+
+    if (encoder == NULL || encoder == &_cairo_png_encoder_nil)
+	return;
+
+    if (encoder->segments != NULL) {
+	for (i = 0; i < encoder->num_segments; i++)
+	    free (encoder->segments[i].data);
+	free (encoder->segments);
+    }
+    free (encoder->data);
+    free (encoder);
+}
+
 static inline int
 multiply_alpha (int alpha, int color)
 {
@@ -781,6 +781,7 @@ _cairo_quartz_scaled_font_get_ct_font (cairo_scaled_font_t *abstract_font)
 	case CAIRO_ANTIALIAS_GRAY:
 	case CAIRO_ANTIALIAS_GOOD:
 	case CAIRO_ANTIALIAS_FAST:
+	case CAIRO_ANTIALIAS_ADAPTIVE:
 	    CGContextSetShouldAntialias (cgContext, TRUE);
 	    CGContextSetShouldSmoothFonts (cgContext, FALSE);
 	    break;
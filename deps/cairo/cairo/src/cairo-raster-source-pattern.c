@@ -36,6 +36,8 @@
 
 #include "cairoint.h"
 #include "cairo-error-private.h"
+#include "cairo-image-surface-private.h"
+#include "cairo-list-inline.h"
 #include "cairo-pattern-private.h"
 
 /**
@@ -57,7 +59,347 @@
  * Other callbacks are provided for when the pattern is copied temporarily
  * during rasterisation, or more permanently as a snapshot in order to keep
  * the pixel data available for printing.
+ *
+ * Very large sources can be split into tiles with
+ * cairo_raster_source_pattern_set_tile_size(). The acquire callback is then
+ * only asked for the tiles that a rendering operation samples, and the
+ * tiles are kept in a cache of bounded size shared by all operations, so
+ * the source never has to be provided in full.
+ **/
+
+/* Tiles acquired from tiled raster sources, most recently used first. */
+typedef struct _cairo_raster_source_tile {
+    cairo_hash_entry_t hash_entry;
+    cairo_list_t link;
+
+    unsigned int id;
+    int col, row;
+
+    cairo_image_surface_t *image;
+} cairo_raster_source_tile_t;
+
+/* The cached tiles of a pattern and its copies. */
+struct _cairo_raster_source_tiles {
+    cairo_reference_count_t ref_count;
+    unsigned int id;
+};
+
+#define MAX_TILE_CACHE_SIZE (32 << 20)
+
+static struct {
+    cairo_hash_table_t *hash_table;
+    cairo_list_t lru;
+    size_t size;
+} tile_cache;
+
+/* Tiles are charged against the memory budget of
+ * cairo_cache_set_memory_budget(); they are cheaper to recreate than
+ * glyphs, as the application only has to provide the pixels again. */
+static void
+_cairo_raster_source_tiles_shrink (size_t size);
+
+static cairo_cache_budget_client_t tile_budget =
+    CAIRO_CACHE_BUDGET_CLIENT_INIT (2, _cairo_raster_source_tiles_shrink);
+
+static unsigned int
+_cairo_raster_source_tile_allocate_id (void)
+{
+    static cairo_atomic_int_t unique_id;
+
+#if CAIRO_NO_MUTEX
+    if (++unique_id == 0)
+	unique_id = 1;
+    return unique_id;
+#else
+    cairo_atomic_int_t old, id;
+
+    do {
+	old = _cairo_atomic_uint_get (&unique_id);
+	id = old + 1;
+	if (id == 0)
+	    id = 1;
+    } while (! _cairo_atomic_uint_cmpxchg (&unique_id, old, id));
+
+    return id;
+#endif
+}
+
+static uintptr_t
+_cairo_raster_source_tile_hash (unsigned int id, int col, int row)
+{
+    return ((uintptr_t) id * 0x9e3779b1) ^ ((uintptr_t) row << 16) ^ col;
+}
+
+static cairo_bool_t
+_cairo_raster_source_tile_keys_equal (const void *key_a, const void *key_b)
+{
+    const cairo_raster_source_tile_t *a = key_a, *b = key_b;
+
+    return a->id == b->id && a->col == b->col && a->row == b->row;
+}
+
+static size_t
+_cairo_raster_source_tile_size (const cairo_raster_source_tile_t *tile)
+{
+    return (size_t) tile->image->stride * tile->image->height + sizeof (*tile);
+}
+
+static void
+_cairo_raster_source_tile_destroy (cairo_raster_source_tile_t *tile)
+{
+    _cairo_hash_table_remove (tile_cache.hash_table, &tile->hash_entry);
+    cairo_list_del (&tile->link);
+    tile_cache.size -= _cairo_raster_source_tile_size (tile);
+    _cairo_cache_budget_release (&tile_budget,
+				 _cairo_raster_source_tile_size (tile));
+
+    cairo_surface_destroy (&tile->image->base);
+    free (tile);
+}
+
+static void
+_cairo_raster_source_tiles_purge (unsigned int id)
+{
+    cairo_raster_source_tile_t *tile, *next;
+
+    CAIRO_MUTEX_LOCK (_cairo_raster_source_tile_mutex);
+    if (tile_cache.hash_table != NULL) {
+	cairo_list_foreach_entry_safe (tile, next, cairo_raster_source_tile_t,
+				       &tile_cache.lru, link)
+	{
+	    if (tile->id == id)
+		_cairo_raster_source_tile_destroy (tile);
+	}
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+}
+
+static void
+_cairo_raster_source_tiles_shrink (size_t size)
+{
+    size_t freed = 0;
+
+    CAIRO_MUTEX_LOCK (_cairo_raster_source_tile_mutex);
+    if (tile_cache.hash_table != NULL) {
+	while (freed < size && ! cairo_list_is_empty (&tile_cache.lru)) {
+	    cairo_raster_source_tile_t *tile;
+
+	    tile = cairo_list_last_entry (&tile_cache.lru,
+					  cairo_raster_source_tile_t,
+					  link);
+	    freed += _cairo_raster_source_tile_size (tile);
+	    _cairo_raster_source_tile_destroy (tile);
+	}
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+}
+
+static void
+_cairo_raster_source_tiles_destroy (cairo_raster_source_tiles_t *tiles)
+{
+    if (tiles == NULL)
+	return;
+
+    assert (CAIRO_REFERENCE_COUNT_HAS_REFERENCE (&tiles->ref_count));
+    if (! _cairo_reference_count_dec_and_test (&tiles->ref_count))
+	return;
+
+    _cairo_raster_source_tiles_purge (tiles->id);
+    free (tiles);
+}
+
+/* Forget the tiles of @pattern, as they no longer match its pixels.
+ * If the new tiles cannot be allocated, acquiring them reports the
+ * error instead. */
+static void
+_cairo_raster_source_pattern_reset_tiles (cairo_raster_source_pattern_t *pattern)
+{
+    _cairo_raster_source_tiles_destroy (pattern->tiles);
+    pattern->tiles = NULL;
+
+    if (pattern->tile_width == 0)
+	return;
+
+    pattern->tiles = _cairo_malloc (sizeof (cairo_raster_source_tiles_t));
+    if (unlikely (pattern->tiles == NULL))
+	return;
+
+    CAIRO_REFERENCE_COUNT_INIT (&pattern->tiles->ref_count, 1);
+    pattern->tiles->id = _cairo_raster_source_tile_allocate_id ();
+}
+
+static cairo_status_t
+_cairo_raster_source_tile_create (const cairo_raster_source_pattern_t *pattern,
+				  cairo_surface_t *target,
+				  int col, int row,
+				  cairo_image_surface_t **image_out)
+{
+    cairo_rectangle_int_t rect;
+    cairo_surface_pattern_t source;
+    cairo_surface_t *surface, *image;
+    cairo_status_t status;
+
+    rect.x = col * pattern->tile_width;
+    rect.y = row * pattern->tile_height;
+    rect.width = pattern->tile_width;
+    rect.height = pattern->tile_height;
+    if (! _cairo_rectangle_intersect (&rect, &pattern->extents))
+	return _cairo_error (CAIRO_STATUS_INVALID_SIZE);
+
+    surface = _cairo_raster_source_pattern_acquire (&pattern->base,
+						    target, &rect);
+    if (unlikely (surface == NULL))
+	return _cairo_error (CAIRO_STATUS_NULL_POINTER);
+    if (unlikely (surface->status)) {
+	status = surface->status;
+	_cairo_raster_source_pattern_release (&pattern->base, surface);
+	return status;
+    }
+
+    /* Keep a copy of the tile, as the surface is released at once. The
+     * surface may cover just the tile, positioned by its device offset. */
+    image = cairo_image_surface_create (_cairo_format_from_content (pattern->content),
+					rect.width, rect.height);
+    _cairo_pattern_init_for_surface (&source, surface);
+    cairo_matrix_init_translate (&source.base.matrix, rect.x, rect.y);
+    cairo_matrix_multiply (&source.base.matrix,
+			   &source.base.matrix, &surface->device_transform);
+    status = _cairo_surface_paint (image, CAIRO_OPERATOR_SOURCE,
+				   &source.base, NULL);
+    _cairo_pattern_fini (&source.base);
+
+    _cairo_raster_source_pattern_release (&pattern->base, surface);
+
+    if (unlikely (status)) {
+	cairo_surface_destroy (image);
+	return status;
+    }
+
+    *image_out = (cairo_image_surface_t *) image;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * _cairo_raster_source_pattern_acquire_tile:
+ * @abstract_pattern: a tiled raster source pattern
+ * @target: the surface being drawn to, passed on to the acquire callback
+ * @col: column of the tile, in units of the tile width
+ * @row: row of the tile, in units of the tile height
+ * @image_out: return location for a new reference to the tile
+ *
+ * Looks up a tile of @abstract_pattern in the tile cache, acquiring it
+ * from the pattern when missing. The tile covers the pattern extents
+ * from (@col * tile_width, @row * tile_height); tiles along the right and
+ * bottom edges are smaller when the tile size does not divide the extents.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS or the error from acquiring the tile.
  **/
+cairo_status_t
+_cairo_raster_source_pattern_acquire_tile (const cairo_pattern_t *abstract_pattern,
+					   cairo_surface_t *target,
+					   int col, int row,
+					   cairo_image_surface_t **image_out)
+{
+    const cairo_raster_source_pattern_t *pattern =
+	(const cairo_raster_source_pattern_t *) abstract_pattern;
+    cairo_raster_source_tile_t key, *tile;
+    cairo_image_surface_t *image = NULL;
+    cairo_status_t status;
+
+    assert (pattern->tile_width && pattern->tile_height);
+
+    if (unlikely (pattern->tiles == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    key.id = pattern->tiles->id;
+    key.col = col;
+    key.row = row;
+    key.hash_entry.hash = _cairo_raster_source_tile_hash (key.id, col, row);
+
+    CAIRO_MUTEX_LOCK (_cairo_raster_source_tile_mutex);
+    if (tile_cache.hash_table != NULL) {
+	tile = _cairo_hash_table_lookup (tile_cache.hash_table, &key.hash_entry);
+	if (tile != NULL) {
+	    cairo_list_move (&tile->link, &tile_cache.lru);
+	    *image_out = (cairo_image_surface_t *)
+		cairo_surface_reference (&tile->image->base);
+	    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+	    return CAIRO_STATUS_SUCCESS;
+	}
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+
+    /* Call back into the user without holding the lock. */
+    status = _cairo_raster_source_tile_create (pattern, target, col, row, &image);
+    if (unlikely (status))
+	return status;
+
+    *image_out = image;
+
+    tile = _cairo_malloc (sizeof (cairo_raster_source_tile_t));
+    if (unlikely (tile == NULL))
+	return CAIRO_STATUS_SUCCESS;
+
+    tile->hash_entry.hash = key.hash_entry.hash;
+    tile->id = key.id;
+    tile->col = col;
+    tile->row = row;
+    tile->image = (cairo_image_surface_t *) cairo_surface_reference (&image->base);
+
+    CAIRO_MUTEX_LOCK (_cairo_raster_source_tile_mutex);
+    if (tile_cache.hash_table == NULL) {
+	tile_cache.hash_table =
+	    _cairo_hash_table_create (_cairo_raster_source_tile_keys_equal);
+	cairo_list_init (&tile_cache.lru);
+	tile_cache.size = 0;
+    }
+
+    if (tile_cache.hash_table == NULL ||
+	_cairo_hash_table_lookup (tile_cache.hash_table, &key.hash_entry) ||
+	_cairo_hash_table_insert (tile_cache.hash_table, &tile->hash_entry))
+    {
+	/* Out of memory, or another thread cached the tile first. */
+	CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+	cairo_surface_destroy (&tile->image->base);
+	free (tile);
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    cairo_list_add (&tile->link, &tile_cache.lru);
+    tile_cache.size += _cairo_raster_source_tile_size (tile);
+    _cairo_cache_budget_charge (&tile_budget,
+				_cairo_raster_source_tile_size (tile));
+
+    while (tile_cache.size > MAX_TILE_CACHE_SIZE &&
+	   ! cairo_list_is_singular (&tile_cache.lru))
+    {
+	_cairo_raster_source_tile_destroy (cairo_list_last_entry (&tile_cache.lru,
+								  cairo_raster_source_tile_t,
+								  link));
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+
+    _cairo_cache_budget_enforce ();
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+void
+_cairo_raster_source_pattern_reset_static_data (void)
+{
+    CAIRO_MUTEX_LOCK (_cairo_raster_source_tile_mutex);
+    if (tile_cache.hash_table != NULL) {
+	while (! cairo_list_is_empty (&tile_cache.lru)) {
+	    _cairo_raster_source_tile_destroy (cairo_list_first_entry (&tile_cache.lru,
+								       cairo_raster_source_tile_t,
+								       link));
+	}
+
+	_cairo_hash_table_destroy (tile_cache.hash_table);
+	tile_cache.hash_table = NULL;
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_raster_source_tile_mutex);
+}
 
 cairo_surface_t *
 _cairo_raster_source_pattern_acquire (const cairo_pattern_t *abstract_pattern,
@@ -96,15 +438,23 @@ _cairo_raster_source_pattern_init_copy (cairo_pattern_t *abstract_pattern,
 {
     cairo_raster_source_pattern_t *pattern =
 	(cairo_raster_source_pattern_t *) abstract_pattern;
+    cairo_raster_source_tiles_t *other_tiles =
+	((const cairo_raster_source_pattern_t *) other)->tiles;
     cairo_status_t status;
 
     VG (VALGRIND_MAKE_MEM_UNDEFINED (pattern, sizeof (cairo_raster_source_pattern_t)));
     memcpy(pattern, other, sizeof (cairo_raster_source_pattern_t));
+    pattern->tiles = NULL;
 
     status = CAIRO_STATUS_SUCCESS;
     if (pattern->copy)
 	status = pattern->copy (&pattern->base, pattern->user_data, other);
 
+    if (likely (status == CAIRO_STATUS_SUCCESS) && other_tiles != NULL) {
+	_cairo_reference_count_inc (&other_tiles->ref_count);
+	pattern->tiles = other_tiles;
+    }
+
     return status;
 }
 
@@ -126,6 +476,8 @@ _cairo_raster_source_pattern_finish (cairo_pattern_t *abstract_pattern)
     cairo_raster_source_pattern_t *pattern =
 	(cairo_raster_source_pattern_t *) abstract_pattern;
 
+    _cairo_raster_source_tiles_destroy (pattern->tiles);
+
     if (pattern->finish == NULL)
 	return;
 
@@ -208,6 +560,7 @@ cairo_raster_source_pattern_set_callback_data (cairo_pattern_t *abstract_pattern
 
     pattern = (cairo_raster_source_pattern_t *) abstract_pattern;
     pattern->user_data = data;
+    _cairo_raster_source_pattern_reset_tiles (pattern);
 }
 
 /**
@@ -264,6 +617,7 @@ cairo_raster_source_pattern_set_acquire (cairo_pattern_t *abstract_pattern,
     pattern = (cairo_raster_source_pattern_t *) abstract_pattern;
     pattern->acquire = acquire;
     pattern->release = release;
+    _cairo_raster_source_pattern_reset_tiles (pattern);
 }
 
 /**
@@ -428,3 +782,71 @@ cairo_raster_source_pattern_get_finish (cairo_pattern_t *abstract_pattern)
     pattern = (cairo_raster_source_pattern_t *) abstract_pattern;
     return pattern->finish;
 }
+
+/**
+ * cairo_raster_source_pattern_set_tile_size:
+ * @pattern: the pattern to update
+ * @width: width of a tile, or 0
+ * @height: height of a tile, or 0
+ *
+ * Splits the pixel data of the pattern into tiles of @width by @height
+ * pixels, aligned to the origin of the sample area. The acquire callback
+ * is then invoked with the extents of a single tile, and only for the
+ * tiles that a rendering operation samples, instead of once for every
+ * operation. Tiles are kept in a cache of bounded size that is shared
+ * by all rendering operations, so they must not change while the
+ * pattern is in use; the cache is discarded whenever the callback data
+ * or the acquire callback are changed, and when the pattern is destroyed.
+ *
+ * Passing 0 for either dimension disables tiling, which is the default.
+ * Backends that do not support tiling still acquire the whole sample area.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_raster_source_pattern_set_tile_size (cairo_pattern_t *abstract_pattern,
+					   int width, int height)
+{
+    cairo_raster_source_pattern_t *pattern;
+
+    if (abstract_pattern->type != CAIRO_PATTERN_TYPE_RASTER_SOURCE)
+	return;
+
+    if (width < 0 || height < 0)
+	return;
+
+    if (width == 0 || height == 0)
+	width = height = 0;
+
+    pattern = (cairo_raster_source_pattern_t *) abstract_pattern;
+    pattern->tile_width = width;
+    pattern->tile_height = height;
+    _cairo_raster_source_pattern_reset_tiles (pattern);
+}
+
+/**
+ * cairo_raster_source_pattern_get_tile_size:
+ * @pattern: the pattern to query
+ * @width: return value for the tile width, or %NULL
+ * @height: return value for the tile height, or %NULL
+ *
+ * Queries the tile size set with cairo_raster_source_pattern_set_tile_size().
+ * Both are 0 if the pattern is not tiled.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_raster_source_pattern_get_tile_size (cairo_pattern_t *abstract_pattern,
+					   int *width, int *height)
+{
+    cairo_raster_source_pattern_t *pattern;
+
+    if (abstract_pattern->type != CAIRO_PATTERN_TYPE_RASTER_SOURCE)
+	return;
+
+    pattern = (cairo_raster_source_pattern_t *) abstract_pattern;
+    if (width)
+	*width = pattern->tile_width;
+    if (height)
+	*height = pattern->tile_height;
+}
@@ -67,6 +67,10 @@ typedef enum {
     CAIRO_RECORDING_REPLAY_REGION
 } cairo_recording_replay_type_t;
 
+/* The patterns, paths and clips referenced by commands are interned in
+ * the recording surface and shared between commands; they must not be
+ * modified once recorded.
+ */
 typedef struct _cairo_command_header {
     cairo_command_type_t	 type;
     cairo_operator_t		 op;
@@ -79,19 +83,19 @@ typedef struct _cairo_command_header {
 
 typedef struct _cairo_command_paint {
     cairo_command_header_t       header;
-    cairo_pattern_union_t	 source;
+    cairo_pattern_t		*source;
 } cairo_command_paint_t;
 
 typedef struct _cairo_command_mask {
     cairo_command_header_t       header;
-    cairo_pattern_union_t	 source;
-    cairo_pattern_union_t	 mask;
+    cairo_pattern_t		*source;
+    cairo_pattern_t		*mask;
 } cairo_command_mask_t;
 
 typedef struct _cairo_command_stroke {
     cairo_command_header_t       header;
-    cairo_pattern_union_t	 source;
-    cairo_path_fixed_t		 path;
+    cairo_pattern_t		*source;
+    cairo_path_fixed_t		*path;
     cairo_stroke_style_t	 style;
     cairo_matrix_t		 ctm;
     cairo_matrix_t		 ctm_inverse;
@@ -101,8 +105,8 @@ typedef struct _cairo_command_stroke {
 
 typedef struct _cairo_command_fill {
     cairo_command_header_t       header;
-    cairo_pattern_union_t	 source;
-    cairo_path_fixed_t		 path;
+    cairo_pattern_t		*source;
+    cairo_path_fixed_t		*path;
     cairo_fill_rule_t		 fill_rule;
     double			 tolerance;
     cairo_antialias_t		 antialias;
@@ -110,7 +114,7 @@ typedef struct _cairo_command_fill {
 
 typedef struct _cairo_command_show_text_glyphs {
     cairo_command_header_t       header;
-    cairo_pattern_union_t	 source;
+    cairo_pattern_t		*source;
     char			*utf8;
     int				 utf8_len;
     cairo_glyph_t		*glyphs;
@@ -150,6 +154,7 @@ typedef struct _cairo_recording_surface {
     cairo_bool_t unbounded;
 
     cairo_array_t commands;
+    cairo_hash_table_t *interned;
     unsigned int *indices;
     unsigned int num_indices;
     cairo_bool_t optimize_clears;
@@ -80,6 +80,7 @@
 
 #include "cairo-array-private.h"
 #include "cairo-analysis-surface-private.h"
+#include "cairo-clip-inline.h"
 #include "cairo-clip-private.h"
 #include "cairo-combsort-inline.h"
 #include "cairo-composite-rectangles-private.h"
@@ -88,6 +89,7 @@
 #include "cairo-image-surface-private.h"
 #include "cairo-list-inline.h"
 #include "cairo-recording-surface-inline.h"
+#include "cairo-region-private.h"
 #include "cairo-surface-snapshot-inline.h"
 #include "cairo-surface-wrapper-private.h"
 #include "cairo-traps-private.h"
@@ -422,6 +424,7 @@ cairo_recording_surface_create (cairo_content_t		 content,
     }
 
     _cairo_array_init (&surface->commands, sizeof (cairo_command_t *));
+    surface->interned = NULL;
 
     surface->base.is_clear = TRUE;
 
@@ -485,24 +488,24 @@ _cairo_recording_surface_region_array_destroy (cairo_recording_surface_t       *
 
 	switch (command->header.type) {
 	    case CAIRO_COMMAND_PAINT:
-		destroy_pattern_region_array (&command->paint.source.base, region_element->source_id);
+		destroy_pattern_region_array (command->paint.source, region_element->source_id);
 		break;
 
 	    case CAIRO_COMMAND_MASK:
-		destroy_pattern_region_array (&command->mask.source.base, region_element->source_id);
-		destroy_pattern_region_array (&command->mask.mask.base, region_element->mask_id);
+		destroy_pattern_region_array (command->mask.source, region_element->source_id);
+		destroy_pattern_region_array (command->mask.mask, region_element->mask_id);
 		break;
 
 	    case CAIRO_COMMAND_STROKE:
-		destroy_pattern_region_array (&command->stroke.source.base, region_element->source_id);
+		destroy_pattern_region_array (command->stroke.source, region_element->source_id);
 		break;
 
 	    case CAIRO_COMMAND_FILL:
-		destroy_pattern_region_array (&command->fill.source.base, region_element->source_id);
+		destroy_pattern_region_array (command->fill.source, region_element->source_id);
 		break;
 
 	    case CAIRO_COMMAND_SHOW_TEXT_GLYPHS:
-		destroy_pattern_region_array (&command->show_text_glyphs.source.base, region_element->source_id);
+		destroy_pattern_region_array (command->show_text_glyphs.source, region_element->source_id);
 		break;
 
 	    case CAIRO_COMMAND_TAG:
@@ -517,6 +520,297 @@ _cairo_recording_surface_region_array_destroy (cairo_recording_surface_t       *
     free (region_array);
 }
 
+/* Commands do not own their patterns, paths and clips. These are
+ * interned in a table per recording surface instead, so that commands
+ * drawing with equal objects share a single copy, and are never
+ * modified once recorded, so that snapshots of the recording can share
+ * them too. Every table holding an object owns a reference to it.
+ */
+typedef enum {
+    CAIRO_RECORDING_INTERNED_PATTERN,
+    CAIRO_RECORDING_INTERNED_PATH,
+    CAIRO_RECORDING_INTERNED_CLIP
+} cairo_recording_interned_type_t;
+
+typedef struct _cairo_recording_interned {
+    cairo_hash_entry_t hash_entry;
+    cairo_reference_count_t ref_count;
+    cairo_recording_interned_type_t type;
+    void *object;
+} cairo_recording_interned_t;
+
+typedef struct _cairo_recording_pattern {
+    cairo_recording_interned_t base;
+    cairo_pattern_union_t pattern;
+} cairo_recording_pattern_t;
+
+typedef struct _cairo_recording_path {
+    cairo_recording_interned_t base;
+    cairo_path_fixed_t path;
+} cairo_recording_path_t;
+
+static cairo_bool_t
+_cairo_recording_interned_equal (const void *key_a, const void *key_b)
+{
+    const cairo_recording_interned_t *a = key_a;
+    const cairo_recording_interned_t *b = key_b;
+
+    if (a->type != b->type)
+	return FALSE;
+
+    switch (a->type) {
+    case CAIRO_RECORDING_INTERNED_PATTERN:
+    {
+	const cairo_pattern_t *pa = a->object;
+	const cairo_pattern_t *pb = b->object;
+
+	/* Raster sources may produce different pixels on every use */
+	if (pa->type == CAIRO_PATTERN_TYPE_RASTER_SOURCE)
+	    return FALSE;
+
+	return pa->is_foreground_marker == pb->is_foreground_marker &&
+	       pa->opacity == pb->opacity &&
+	       _cairo_pattern_equal (pa, pb);
+    }
+
+    case CAIRO_RECORDING_INTERNED_PATH:
+	return _cairo_path_fixed_equal (a->object, b->object);
+
+    case CAIRO_RECORDING_INTERNED_CLIP:
+	return _cairo_clip_equal (a->object, b->object);
+
+    default:
+	ASSERT_NOT_REACHED;
+	return FALSE;
+    }
+}
+
+static void
+_cairo_recording_interned_destroy (cairo_recording_interned_t *interned)
+{
+    assert (CAIRO_REFERENCE_COUNT_HAS_REFERENCE (&interned->ref_count));
+
+    if (! _cairo_reference_count_dec_and_test (&interned->ref_count))
+	return;
+
+    switch (interned->type) {
+    case CAIRO_RECORDING_INTERNED_PATTERN:
+	_cairo_pattern_fini (interned->object);
+	break;
+    case CAIRO_RECORDING_INTERNED_PATH:
+	_cairo_path_fixed_fini (interned->object);
+	break;
+    case CAIRO_RECORDING_INTERNED_CLIP:
+	_cairo_clip_destroy (interned->object);
+	break;
+    }
+
+    free (interned);
+}
+
+static void
+_cairo_recording_interned_pluck (void *entry, void *closure)
+{
+    cairo_hash_table_t *interned = closure;
+
+    _cairo_hash_table_remove (interned, entry);
+    _cairo_recording_interned_destroy (entry);
+}
+
+static cairo_status_t
+_cairo_recording_surface_intern (cairo_recording_surface_t *surface,
+				 cairo_recording_interned_t *interned)
+{
+    cairo_status_t status;
+
+    if (surface->interned == NULL) {
+	surface->interned =
+	    _cairo_hash_table_create (_cairo_recording_interned_equal);
+	if (unlikely (surface->interned == NULL))
+	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    status = _cairo_hash_table_insert (surface->interned,
+				       &interned->hash_entry);
+    if (unlikely (status))
+	return status;
+
+    _cairo_reference_count_inc (&interned->ref_count);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_recording_interned_t *
+_cairo_recording_surface_lookup (cairo_recording_surface_t *surface,
+				 cairo_recording_interned_t *key)
+{
+    if (surface->interned == NULL)
+	return NULL;
+
+    return _cairo_hash_table_lookup (surface->interned, &key->hash_entry);
+}
+
+static cairo_status_t
+_cairo_recording_surface_intern_pattern (cairo_recording_surface_t *surface,
+					 const cairo_pattern_t *pattern,
+					 cairo_pattern_t **pattern_out)
+{
+    cairo_recording_interned_t key, *interned;
+    cairo_recording_pattern_t *recorded;
+    cairo_status_t status;
+
+    /* Surface patterns are compared by the snapshots of their surfaces,
+     * so can only be looked up once snapshotted.
+     */
+    if (pattern->type != CAIRO_PATTERN_TYPE_SURFACE) {
+	key.hash_entry.hash = _cairo_pattern_hash (pattern);
+	key.type = CAIRO_RECORDING_INTERNED_PATTERN;
+	key.object = (cairo_pattern_t *) pattern;
+
+	interned = _cairo_recording_surface_lookup (surface, &key);
+	if (interned != NULL) {
+	    *pattern_out = interned->object;
+	    return CAIRO_STATUS_SUCCESS;
+	}
+    }
+
+    recorded = _cairo_malloc (sizeof (cairo_recording_pattern_t));
+    if (unlikely (recorded == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    status = _cairo_pattern_init_snapshot (&recorded->pattern.base, pattern);
+    if (unlikely (status)) {
+	free (recorded);
+	return status;
+    }
+
+    recorded->base.hash_entry.hash = _cairo_pattern_hash (&recorded->pattern.base);
+    recorded->base.type = CAIRO_RECORDING_INTERNED_PATTERN;
+    recorded->base.object = &recorded->pattern.base;
+    CAIRO_REFERENCE_COUNT_INIT (&recorded->base.ref_count, 0);
+
+    if (pattern->type == CAIRO_PATTERN_TYPE_SURFACE) {
+	interned = _cairo_recording_surface_lookup (surface, &recorded->base);
+	if (interned != NULL) {
+	    _cairo_pattern_fini (&recorded->pattern.base);
+	    free (recorded);
+	    *pattern_out = interned->object;
+	    return CAIRO_STATUS_SUCCESS;
+	}
+    }
+
+    status = _cairo_recording_surface_intern (surface, &recorded->base);
+    if (unlikely (status)) {
+	_cairo_pattern_fini (&recorded->pattern.base);
+	free (recorded);
+	return status;
+    }
+
+    *pattern_out = &recorded->pattern.base;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t
+_cairo_recording_surface_intern_path (cairo_recording_surface_t *surface,
+				      const cairo_path_fixed_t *path,
+				      cairo_path_fixed_t **path_out)
+{
+    cairo_recording_interned_t key, *interned;
+    cairo_recording_path_t *recorded;
+    cairo_status_t status;
+
+    key.hash_entry.hash = _cairo_path_fixed_hash (path);
+    key.type = CAIRO_RECORDING_INTERNED_PATH;
+    key.object = (cairo_path_fixed_t *) path;
+
+    interned = _cairo_recording_surface_lookup (surface, &key);
+    if (interned != NULL) {
+	*path_out = interned->object;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    recorded = _cairo_malloc (sizeof (cairo_recording_path_t));
+    if (unlikely (recorded == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    status = _cairo_path_fixed_init_copy (&recorded->path, path);
+    if (unlikely (status)) {
+	free (recorded);
+	return status;
+    }
+
+    recorded->base = key;
+    recorded->base.object = &recorded->path;
+    CAIRO_REFERENCE_COUNT_INIT (&recorded->base.ref_count, 0);
+
+    status = _cairo_recording_surface_intern (surface, &recorded->base);
+    if (unlikely (status)) {
+	_cairo_path_fixed_fini (&recorded->path);
+	free (recorded);
+	return status;
+    }
+
+    *path_out = &recorded->path;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/* Takes ownership of @clip */
+static cairo_status_t
+_cairo_recording_surface_intern_clip (cairo_recording_surface_t *surface,
+				      cairo_clip_t *clip,
+				      cairo_clip_t **clip_out)
+{
+    cairo_recording_interned_t key, *interned;
+    cairo_status_t status;
+
+    *clip_out = NULL;
+    if (clip == NULL)
+	return CAIRO_STATUS_SUCCESS;
+
+    key.hash_entry.hash = _cairo_clip_hash (clip);
+    key.type = CAIRO_RECORDING_INTERNED_CLIP;
+    key.object = clip;
+
+    interned = _cairo_recording_surface_lookup (surface, &key);
+    if (interned != NULL) {
+	_cairo_clip_destroy (clip);
+	*clip_out = interned->object;
+	return CAIRO_STATUS_SUCCESS;
+    }
+
+    interned = _cairo_malloc (sizeof (cairo_recording_interned_t));
+    if (unlikely (interned == NULL)) {
+	_cairo_clip_destroy (clip);
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+    }
+
+    *interned = key;
+    CAIRO_REFERENCE_COUNT_INIT (&interned->ref_count, 0);
+
+    status = _cairo_recording_surface_intern (surface, interned);
+    if (unlikely (status)) {
+	_cairo_clip_destroy (clip);
+	free (interned);
+	return status;
+    }
+
+    *clip_out = clip;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+typedef struct _cairo_recording_share_closure {
+    cairo_recording_surface_t *dst;
+    cairo_status_t status;
+} cairo_recording_share_closure_t;
+
+static void
+_cairo_recording_interned_share (void *entry, void *closure)
+{
+    cairo_recording_share_closure_t *share = closure;
+
+    if (share->status == CAIRO_STATUS_SUCCESS)
+	share->status = _cairo_recording_surface_intern (share->dst, entry);
+}
+
 static cairo_status_t
 _cairo_recording_surface_finish (void *abstract_surface)
 {
@@ -545,27 +839,15 @@ _cairo_recording_surface_finish (void *abstract_surface)
 
 	switch (command->header.type) {
 	case CAIRO_COMMAND_PAINT:
-	    _cairo_pattern_fini (&command->paint.source.base);
-	    break;
-
 	case CAIRO_COMMAND_MASK:
-	    _cairo_pattern_fini (&command->mask.source.base);
-	    _cairo_pattern_fini (&command->mask.mask.base);
+	case CAIRO_COMMAND_FILL:
 	    break;
 
 	case CAIRO_COMMAND_STROKE:
-	    _cairo_pattern_fini (&command->stroke.source.base);
-	    _cairo_path_fixed_fini (&command->stroke.path);
 	    _cairo_stroke_style_fini (&command->stroke.style);
 	    break;
 
-	case CAIRO_COMMAND_FILL:
-	    _cairo_pattern_fini (&command->fill.source.base);
-	    _cairo_path_fixed_fini (&command->fill.path);
-	    break;
-
 	case CAIRO_COMMAND_SHOW_TEXT_GLYPHS:
-	    _cairo_pattern_fini (&command->show_text_glyphs.source.base);
 	    free (command->show_text_glyphs.utf8);
 	    free (command->show_text_glyphs.glyphs);
 	    free (command->show_text_glyphs.clusters);
@@ -583,12 +865,19 @@ _cairo_recording_surface_finish (void *abstract_surface)
 	    ASSERT_NOT_REACHED;
 	}
 
-	_cairo_clip_destroy (command->header.clip);
 	free (command);
     }
 
     _cairo_array_fini (&surface->commands);
 
+    if (surface->interned) {
+	_cairo_hash_table_foreach (surface->interned,
+				   _cairo_recording_interned_pluck,
+				   surface->interned);
+	_cairo_hash_table_destroy (surface->interned);
+	surface->interned = NULL;
+    }
+
     if (surface->bbtree.left)
 	bbtree_del (surface->bbtree.left);
     if (surface->bbtree.right)
@@ -747,7 +1036,9 @@ _command_init (cairo_recording_surface_t *surface,
     if (composite && ! _cairo_composite_rectangles_can_reduce_clip (composite,
 								    composite->clip))
     {
-	command->clip = composite->clip;
+	status = _cairo_recording_surface_intern_clip (surface,
+						       composite->clip,
+						       &command->clip);
 	composite->clip = NULL;
     }
 
@@ -830,23 +1121,21 @@ _cairo_recording_surface_paint (void			  *abstract_surface,
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->source.base, source);
+    status = _cairo_recording_surface_intern_pattern (surface, source,
+						      &command->source);
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto CLEANUP_SOURCE;
+	goto CLEANUP_COMMAND;
 
     _cairo_recording_surface_destroy_bbtree (surface);
 
     _cairo_composite_rectangles_fini (&composite);
     return CAIRO_STATUS_SUCCESS;
 
-  CLEANUP_SOURCE:
-    _cairo_pattern_fini (&command->source.base);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
 CLEANUP_COMPOSITE:
     _cairo_composite_rectangles_fini (&composite);
@@ -886,29 +1175,26 @@ _cairo_recording_surface_mask (void			*abstract_surface,
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->source.base, source);
+    status = _cairo_recording_surface_intern_pattern (surface, source,
+						      &command->source);
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->mask.base, mask);
+    status = _cairo_recording_surface_intern_pattern (surface, mask,
+						      &command->mask);
     if (unlikely (status))
-	goto CLEANUP_SOURCE;
+	goto CLEANUP_COMMAND;
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto CLEANUP_MASK;
+	goto CLEANUP_COMMAND;
 
     _cairo_recording_surface_destroy_bbtree (surface);
 
     _cairo_composite_rectangles_fini (&composite);
     return CAIRO_STATUS_SUCCESS;
 
-  CLEANUP_MASK:
-    _cairo_pattern_fini (&command->mask.base);
-  CLEANUP_SOURCE:
-    _cairo_pattern_fini (&command->source.base);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
 CLEANUP_COMPOSITE:
     _cairo_composite_rectangles_fini (&composite);
@@ -954,17 +1240,19 @@ _cairo_recording_surface_stroke (void			*abstract_surface,
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->source.base, source);
+    status = _cairo_recording_surface_intern_pattern (surface, source,
+						      &command->source);
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_path_fixed_init_copy (&command->path, path);
+    status = _cairo_recording_surface_intern_path (surface, path,
+						   &command->path);
     if (unlikely (status))
-	goto CLEANUP_SOURCE;
+	goto CLEANUP_COMMAND;
 
     status = _cairo_stroke_style_init_copy (&command->style, style);
     if (unlikely (status))
-	goto CLEANUP_PATH;
+	goto CLEANUP_COMMAND;
 
     command->ctm = *ctm;
     command->ctm_inverse = *ctm_inverse;
@@ -982,12 +1270,7 @@ _cairo_recording_surface_stroke (void			*abstract_surface,
 
   CLEANUP_STYLE:
     _cairo_stroke_style_fini (&command->style);
-  CLEANUP_PATH:
-    _cairo_path_fixed_fini (&command->path);
-  CLEANUP_SOURCE:
-    _cairo_pattern_fini (&command->source.base);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
 CLEANUP_COMPOSITE:
     _cairo_composite_rectangles_fini (&composite);
@@ -1030,13 +1313,15 @@ _cairo_recording_surface_fill (void			*abstract_surface,
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->source.base, source);
+    status = _cairo_recording_surface_intern_pattern (surface, source,
+						      &command->source);
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_path_fixed_init_copy (&command->path, path);
+    status = _cairo_recording_surface_intern_path (surface, path,
+						   &command->path);
     if (unlikely (status))
-	goto CLEANUP_SOURCE;
+	goto CLEANUP_COMMAND;
 
     command->fill_rule = fill_rule;
     command->tolerance = tolerance;
@@ -1044,19 +1329,14 @@ _cairo_recording_surface_fill (void			*abstract_surface,
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto CLEANUP_PATH;
+	goto CLEANUP_COMMAND;
 
     _cairo_recording_surface_destroy_bbtree (surface);
 
     _cairo_composite_rectangles_fini (&composite);
     return CAIRO_STATUS_SUCCESS;
 
-  CLEANUP_PATH:
-    _cairo_path_fixed_fini (&command->path);
-  CLEANUP_SOURCE:
-    _cairo_pattern_fini (&command->source.base);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
 CLEANUP_COMPOSITE:
     _cairo_composite_rectangles_fini (&composite);
@@ -1112,7 +1392,8 @@ _cairo_recording_surface_show_text_glyphs (void				*abstract_surface,
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
-    status = _cairo_pattern_init_snapshot (&command->source.base, source);
+    status = _cairo_recording_surface_intern_pattern (surface, source,
+						      &command->source);
     if (unlikely (status))
 	goto CLEANUP_COMMAND;
 
@@ -1165,10 +1446,7 @@ _cairo_recording_surface_show_text_glyphs (void				*abstract_surface,
     free (command->utf8);
     free (command->glyphs);
     free (command->clusters);
-
-    _cairo_pattern_fini (&command->source.base);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
 CLEANUP_COMPOSITE:
     _cairo_composite_rectangles_fini (&composite);
@@ -1226,7 +1504,6 @@ _cairo_recording_surface_tag (void			 *abstract_surface,
     free (command->tag_name);
     free (command->attributes);
   CLEANUP_COMMAND:
-    _cairo_clip_destroy (command->header.clip);
     free (command);
     return status;
 }
@@ -1243,7 +1520,7 @@ _command_init_copy (cairo_recording_surface_t *surface,
     dst->chain = NULL;
     dst->index = surface->commands.num_elements;
 
-    dst->clip = _cairo_clip_copy (src->clip);
+    dst->clip = src->clip;
 }
 
 static cairo_status_t
@@ -1261,19 +1538,14 @@ _cairo_recording_surface_copy__paint (cairo_recording_surface_t *surface,
 
     _command_init_copy (surface, &command->header, &src->header);
 
-    status = _cairo_pattern_init_copy (&command->source.base,
-				       &src->paint.source.base);
-    if (unlikely (status))
-	goto err_command;
+    command->source = src->paint.source;
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto err_source;
+	goto err_command;
 
     return CAIRO_STATUS_SUCCESS;
 
-err_source:
-    _cairo_pattern_fini (&command->source.base);
 err_command:
     free(command);
 err:
@@ -1295,26 +1567,15 @@ _cairo_recording_surface_copy__mask (cairo_recording_surface_t *surface,
 
     _command_init_copy (surface, &command->header, &src->header);
 
-    status = _cairo_pattern_init_copy (&command->source.base,
-				       &src->mask.source.base);
-    if (unlikely (status))
-	goto err_command;
-
-    status = _cairo_pattern_init_copy (&command->mask.base,
-				       &src->mask.mask.base);
-    if (unlikely (status))
-	goto err_source;
+    command->source = src->mask.source;
+    command->mask = src->mask.mask;
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto err_mask;
+	goto err_command;
 
     return CAIRO_STATUS_SUCCESS;
 
-err_mask:
-    _cairo_pattern_fini (&command->mask.base);
-err_source:
-    _cairo_pattern_fini (&command->source.base);
 err_command:
     free(command);
 err:
@@ -1336,19 +1597,13 @@ _cairo_recording_surface_copy__stroke (cairo_recording_surface_t *surface,
 
     _command_init_copy (surface, &command->header, &src->header);
 
-    status = _cairo_pattern_init_copy (&command->source.base,
-				       &src->stroke.source.base);
-    if (unlikely (status))
-	goto err_command;
-
-    status = _cairo_path_fixed_init_copy (&command->path, &src->stroke.path);
-    if (unlikely (status))
-	goto err_source;
+    command->source = src->stroke.source;
+    command->path = src->stroke.path;
 
     status = _cairo_stroke_style_init_copy (&command->style,
 					    &src->stroke.style);
     if (unlikely (status))
-	goto err_path;
+	goto err_command;
 
     command->ctm = src->stroke.ctm;
     command->ctm_inverse = src->stroke.ctm_inverse;
@@ -1363,10 +1618,6 @@ _cairo_recording_surface_copy__stroke (cairo_recording_surface_t *surface,
 
 err_style:
     _cairo_stroke_style_fini (&command->style);
-err_path:
-    _cairo_path_fixed_fini (&command->path);
-err_source:
-    _cairo_pattern_fini (&command->source.base);
 err_command:
     free(command);
 err:
@@ -1388,29 +1639,18 @@ _cairo_recording_surface_copy__fill (cairo_recording_surface_t *surface,
 
     _command_init_copy (surface, &command->header, &src->header);
 
-    status = _cairo_pattern_init_copy (&command->source.base,
-				       &src->fill.source.base);
-    if (unlikely (status))
-	goto err_command;
-
-    status = _cairo_path_fixed_init_copy (&command->path, &src->fill.path);
-    if (unlikely (status))
-	goto err_source;
-
+    command->source = src->fill.source;
+    command->path = src->fill.path;
     command->fill_rule = src->fill.fill_rule;
     command->tolerance = src->fill.tolerance;
     command->antialias = src->fill.antialias;
 
     status = _cairo_recording_surface_commit (surface, &command->header);
     if (unlikely (status))
-	goto err_path;
+	goto err_command;
 
     return CAIRO_STATUS_SUCCESS;
 
-err_path:
-    _cairo_path_fixed_fini (&command->path);
-err_source:
-    _cairo_pattern_fini (&command->source.base);
 err_command:
     free(command);
 err:
@@ -1432,10 +1672,7 @@ _cairo_recording_surface_copy__glyphs (cairo_recording_surface_t *surface,
 
     _command_init_copy (surface, &command->header, &src->header);
 
-    status = _cairo_pattern_init_copy (&command->source.base,
-				       &src->show_text_glyphs.source.base);
-    if (unlikely (status))
-	goto err_command;
+    command->source = src->show_text_glyphs.source;
 
     command->utf8 = NULL;
     command->utf8_len = src->show_text_glyphs.utf8_len;
@@ -1488,8 +1725,6 @@ err_arrays:
     free (command->utf8);
     free (command->glyphs);
     free (command->clusters);
-    _cairo_pattern_fini (&command->source.base);
-err_command:
     free(command);
 err:
     return status;
@@ -1548,6 +1783,19 @@ _cairo_recording_surface_copy (cairo_recording_surface_t *dst,
     int i, num_elements;
     cairo_status_t status;
 
+    /* The commands of both surfaces share the interned objects */
+    if (src->interned != NULL) {
+	cairo_recording_share_closure_t share;
+
+	share.dst = dst;
+	share.status = CAIRO_STATUS_SUCCESS;
+	_cairo_hash_table_foreach (src->interned,
+				   _cairo_recording_interned_share,
+				   &share);
+	if (unlikely (share.status))
+	    return share.status;
+    }
+
     elements = _cairo_array_index (&src->commands, 0);
     num_elements = src->commands.num_elements;
     for (i = 0; i < num_elements; i++) {
@@ -1641,6 +1889,7 @@ _cairo_recording_surface_snapshot (void *abstract_other)
     cairo_list_init (&surface->region_array_list);
 
     _cairo_array_init (&surface->commands, sizeof (cairo_command_t *));
+    surface->interned = NULL;
     status = _cairo_recording_surface_copy (surface, other);
     if (unlikely (status)) {
 	cairo_surface_destroy (&surface->base);
@@ -1855,7 +2104,7 @@ _cairo_recording_surface_get_path (cairo_surface_t    *abstract_surface,
 	    _cairo_traps_init (&traps);
 
 	    /* XXX call cairo_stroke_to_path() when that is implemented */
-	    status = _cairo_path_fixed_stroke_polygon_to_traps (&command->stroke.path,
+	    status = _cairo_path_fixed_stroke_polygon_to_traps (command->stroke.path,
 								&command->stroke.style,
 								&command->stroke.ctm,
 								&command->stroke.ctm_inverse,
@@ -1871,7 +2120,7 @@ _cairo_recording_surface_get_path (cairo_surface_t    *abstract_surface,
 	case CAIRO_COMMAND_FILL:
 	{
 	    status = _cairo_path_fixed_append (path,
-					       &command->fill.path,
+					       command->fill.path,
 					       0, 0);
 	    break;
 	}
@@ -2101,13 +2350,13 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 
 	    status = _cairo_surface_wrapper_paint (&wrapper,
 						   command->header.op,
-						   &command->paint.source.base,
+						   command->paint.source,
 						   source_region_id,
 						   command->header.clip);
 	    if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 		_cairo_recording_surface_merge_source_attributes (surface,
 								  command->header.op,
-								  &command->paint.source.base);
+								  command->paint.source);
 		if (region_element && target_is_analysis)
 		    region_element->source_id = _cairo_analysis_surface_get_source_region_id (params->target);
 	    }
@@ -2121,18 +2370,18 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 
 	    status = _cairo_surface_wrapper_mask (&wrapper,
 						  command->header.op,
-						  &command->mask.source.base,
+						  command->mask.source,
 						  source_region_id,
-						  &command->mask.mask.base,
+						  command->mask.mask,
 						  mask_region_id,
 						  command->header.clip);
 	    if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 		_cairo_recording_surface_merge_source_attributes (surface,
 								  command->header.op,
-								  &command->mask.source.base);
+								  command->mask.source);
 		_cairo_recording_surface_merge_source_attributes (surface,
 								  command->header.op,
-								  &command->mask.mask.base);
+								  command->mask.mask);
 		if (region_element && target_is_analysis) {
 		    region_element->source_id = _cairo_analysis_surface_get_source_region_id (params->target);
 		    region_element->mask_id = _cairo_analysis_surface_get_mask_region_id (params->target);
@@ -2146,9 +2395,9 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 
 	    status = _cairo_surface_wrapper_stroke (&wrapper,
 						    command->header.op,
-						    &command->stroke.source.base,
+						    command->stroke.source,
 						    source_region_id,
-						    &command->stroke.path,
+						    command->stroke.path,
 						    &command->stroke.style,
 						    &command->stroke.ctm,
 						    &command->stroke.ctm_inverse,
@@ -2158,7 +2407,7 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 	    if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 		_cairo_recording_surface_merge_source_attributes (surface,
 								  command->header.op,
-								  &command->stroke.source.base);
+								  command->stroke.source);
 		if (region_element && target_is_analysis)
 		    region_element->source_id = _cairo_analysis_surface_get_source_region_id (params->target);
 	    }
@@ -2197,21 +2446,21 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 
 		if (stroke_command != NULL &&
 		    stroke_command->header.type == CAIRO_COMMAND_STROKE &&
-		    _cairo_path_fixed_equal (&command->fill.path,
-					     &stroke_command->stroke.path) &&
+		    _cairo_path_fixed_equal (command->fill.path,
+					     stroke_command->stroke.path) &&
 		    _cairo_clip_equal (command->header.clip,
 				       stroke_command->header.clip))
 		{
 		    status = _cairo_surface_wrapper_fill_stroke (&wrapper,
 								 command->header.op,
-								 &command->fill.source.base,
+								 command->fill.source,
 								 source_region_id,
 								 command->fill.fill_rule,
 								 command->fill.tolerance,
 								 command->fill.antialias,
-								 &command->fill.path,
+								 command->fill.path,
 								 stroke_command->header.op,
-								 &stroke_command->stroke.source.base,
+								 stroke_command->stroke.source,
 								 stroke_region_id,
 								 &stroke_command->stroke.style,
 								 &stroke_command->stroke.ctm,
@@ -2222,10 +2471,10 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 		    if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 			_cairo_recording_surface_merge_source_attributes (surface,
 									  command->header.op,
-									  &command->fill.source.base);
+									  command->fill.source);
 			_cairo_recording_surface_merge_source_attributes (surface,
 									  command->header.op,
-									  &command->stroke.source.base);
+									  command->stroke.source);
 		    }
 		    i++;
 		}
@@ -2233,9 +2482,9 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 	    if (status == CAIRO_INT_STATUS_UNSUPPORTED) {
 		status = _cairo_surface_wrapper_fill (&wrapper,
 						      command->header.op,
-						      &command->fill.source.base,
+						      command->fill.source,
 						      source_region_id,
-						      &command->fill.path,
+						      command->fill.path,
 						      command->fill.fill_rule,
 						      command->fill.tolerance,
 						      command->fill.antialias,
@@ -2243,7 +2492,7 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 		if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 		    _cairo_recording_surface_merge_source_attributes (surface,
 								      command->header.op,
-								      &command->fill.source.base);
+								      command->fill.source);
 		if (region_element && target_is_analysis)
 		    region_element->source_id = _cairo_analysis_surface_get_source_region_id (params->target);
 		}
@@ -2256,7 +2505,7 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 
 	    status = _cairo_surface_wrapper_show_text_glyphs (&wrapper,
 							      command->header.op,
-							      &command->show_text_glyphs.source.base,
+							      command->show_text_glyphs.source,
 							      source_region_id,
 							      command->show_text_glyphs.utf8, command->show_text_glyphs.utf8_len,
 							      command->show_text_glyphs.glyphs, command->show_text_glyphs.num_glyphs,
@@ -2267,7 +2516,7 @@ _cairo_recording_surface_replay_internal (cairo_recording_surface_t	*surface,
 	    if (params->type == CAIRO_RECORDING_CREATE_REGIONS) {
 		_cairo_recording_surface_merge_source_attributes (surface,
 								  command->header.op,
-								  &command->show_text_glyphs.source.base);
+								  command->show_text_glyphs.source);
 		if (region_element && target_is_analysis)
 		    region_element->source_id = _cairo_analysis_surface_get_source_region_id (params->target);
 
@@ -2350,7 +2599,7 @@ _cairo_recording_surface_replay_one (cairo_recording_surface_t	*surface,
     case CAIRO_COMMAND_PAINT:
 	status = _cairo_surface_wrapper_paint (&wrapper,
 					       command->header.op,
-					       &command->paint.source.base,
+					       command->paint.source,
 					       0,
 					       command->header.clip);
 	break;
@@ -2358,9 +2607,9 @@ _cairo_recording_surface_replay_one (cairo_recording_surface_t	*surface,
     case CAIRO_COMMAND_MASK:
 	status = _cairo_surface_wrapper_mask (&wrapper,
 					      command->header.op,
-					      &command->mask.source.base,
+					      command->mask.source,
 					      0,
-					      &command->mask.mask.base,
+					      command->mask.mask,
 					      0,
 					      command->header.clip);
 	break;
@@ -2368,9 +2617,9 @@ _cairo_recording_surface_replay_one (cairo_recording_surface_t	*surface,
     case CAIRO_COMMAND_STROKE:
 	status = _cairo_surface_wrapper_stroke (&wrapper,
 						command->header.op,
-						&command->stroke.source.base,
+						command->stroke.source,
 						0,
-						&command->stroke.path,
+						command->stroke.path,
 						&command->stroke.style,
 						&command->stroke.ctm,
 						&command->stroke.ctm_inverse,
@@ -2382,9 +2631,9 @@ _cairo_recording_surface_replay_one (cairo_recording_surface_t	*surface,
     case CAIRO_COMMAND_FILL:
 	status = _cairo_surface_wrapper_fill (&wrapper,
 					      command->header.op,
-					      &command->fill.source.base,
+					      command->fill.source,
 					      0,
-					      &command->fill.path,
+					      command->fill.path,
 					      command->fill.fill_rule,
 					      command->fill.tolerance,
 					      command->fill.antialias,
@@ -2394,7 +2643,7 @@ _cairo_recording_surface_replay_one (cairo_recording_surface_t	*surface,
     case CAIRO_COMMAND_SHOW_TEXT_GLYPHS:
 	status = _cairo_surface_wrapper_show_text_glyphs (&wrapper,
 							  command->header.op,
-							  &command->show_text_glyphs.source.base,
+							  command->show_text_glyphs.source,
 							  0,
 							  command->show_text_glyphs.utf8, command->show_text_glyphs.utf8_len,
 							  command->show_text_glyphs.glyphs, command->show_text_glyphs.num_glyphs,
@@ -2678,6 +2927,139 @@ cairo_recording_surface_get_extents (cairo_surface_t *surface,
     return TRUE;
 }
 
+/**
+ * cairo_recording_surface_replay_damage:
+ * @surface: a #cairo_recording_surface_t
+ * @target: the surface to replay onto
+ * @damage: the area of @target to repaint
+ *
+ * Replays the operations recorded in @surface onto @target, without
+ * any transformation, but only within the rectangles of @damage. Each
+ * rectangle is replayed separately, clipped to that rectangle, and only
+ * the operations whose extents intersect it are replayed, so the cost
+ * of a repaint is proportional to the size of the damage rather than
+ * to the size of the recording.
+ *
+ * The damaged area of @target is not cleared beforehand; callers that
+ * repaint onto previous content should clear it first, for example by
+ * filling @damage with %CAIRO_OPERATOR_CLEAR.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS, or the error that stopped the
+ * replay.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_recording_surface_replay_damage (cairo_surface_t      *surface,
+				       cairo_surface_t      *target,
+				       const cairo_region_t *damage)
+{
+    cairo_recording_surface_replay_params_t params;
+    cairo_status_t status = CAIRO_STATUS_SUCCESS;
+    int i, num_rects;
+
+    if (unlikely (surface->status))
+	return surface->status;
+
+    if (! _cairo_surface_is_recording (surface))
+	return _cairo_error (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+
+    if (unlikely (damage->status))
+	return damage->status;
+
+    params.surface_extents = NULL;
+    params.surface_transform = NULL;
+    params.target = target;
+    params.surface_is_unbounded = FALSE;
+    params.type = CAIRO_RECORDING_REPLAY;
+    params.region = CAIRO_RECORDING_REGION_ALL;
+    params.regions_id = 0;
+    params.foreground_color = NULL;
+
+    /* The rectangles of a region never overlap, so replaying each one
+     * clipped to itself repaints every damaged pixel exactly once,
+     * whatever the operators. */
+    num_rects = cairo_region_num_rectangles (damage);
+    for (i = 0; i < num_rects; i++) {
+	cairo_rectangle_int_t rect;
+	cairo_clip_t *clip;
+
+	cairo_region_get_rectangle (damage, i, &rect);
+	clip = _cairo_clip_intersect_rectangle (NULL, &rect);
+	if (_cairo_clip_is_all_clipped (clip))
+	    continue;
+
+	params.target_clip = clip;
+	status = _cairo_recording_surface_replay_internal ((cairo_recording_surface_t *) surface, &params);
+	_cairo_clip_destroy (clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    return status;
+}
+
+/**
+ * cairo_recording_surface_get_num_commands:
+ * @surface: a #cairo_recording_surface_t
+ *
+ * Returns the number of drawing operations recorded so far.
+ *
+ * Return value: the number of commands, or 0 if @surface is not a
+ * recording surface or is in an error state.
+ *
+ * Since: 1.18
+ **/
+unsigned int
+cairo_recording_surface_get_num_commands (cairo_surface_t *surface)
+{
+    if (surface->status || ! _cairo_surface_is_recording (surface)) {
+	_cairo_error_throw (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+	return 0;
+    }
+
+    return ((cairo_recording_surface_t *) surface)->commands.num_elements;
+}
+
+/**
+ * cairo_recording_surface_get_command_extents:
+ * @surface: a #cairo_recording_surface_t
+ * @index: the index of a recorded command, in recording order
+ * @extents: return location for the extents of the command
+ *
+ * Gets the device-space extents that the command at @index may
+ * affect, as used to select the commands replayed by
+ * cairo_recording_surface_replay_damage(). Comparing the extents of
+ * the commands of two recordings lets a caller compute the damage
+ * between them.
+ *
+ * Return value: %TRUE if @index is valid and @extents was set,
+ * otherwise %FALSE
+ *
+ * Since: 1.18
+ **/
+cairo_bool_t
+cairo_recording_surface_get_command_extents (cairo_surface_t       *surface,
+					     unsigned int           index,
+					     cairo_rectangle_int_t *extents)
+{
+    cairo_recording_surface_t *recording;
+    cairo_command_t **elements;
+
+    if (surface->status || ! _cairo_surface_is_recording (surface)) {
+	_cairo_error_throw (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+	return FALSE;
+    }
+
+    recording = (cairo_recording_surface_t *) surface;
+    if (index >= recording->commands.num_elements)
+	return FALSE;
+
+    elements = _cairo_array_index (&recording->commands, 0);
+    *extents = elements[index]->header.extents;
+    return TRUE;
+}
+
 cairo_bool_t
 _cairo_recording_surface_has_only_bilevel_alpha (cairo_recording_surface_t *surface)
 {
@@ -2817,7 +3199,7 @@ _cairo_debug_print_recording_surface (FILE            *file,
 	    case CAIRO_COMMAND_PAINT:
 		print_indent (file, indent);
 		fprintf(file, "%d PAINT %s source: ", i, common);
-		print_pattern (file, &command->paint.source.base, source_region_id, indent + 1, recurse);
+		print_pattern (file, command->paint.source, source_region_id, indent + 1, recurse);
 		break;
 
 	    case CAIRO_COMMAND_MASK:
@@ -2825,22 +3207,22 @@ _cairo_debug_print_recording_surface (FILE            *file,
 		fprintf(file, "%d MASK %s\n", i, common);
 		print_indent (file, indent + 1);
 		fprintf(file, "source: ");
-		print_pattern (file, &command->mask.source.base, source_region_id, indent + 1, recurse);
+		print_pattern (file, command->mask.source, source_region_id, indent + 1, recurse);
 		print_indent (file, indent + 1);
 		fprintf(file, "mask: ");
-		print_pattern (file, &command->mask.mask.base, mask_region_id, indent + 1, recurse);
+		print_pattern (file, command->mask.mask, mask_region_id, indent + 1, recurse);
 		break;
 
 	    case CAIRO_COMMAND_STROKE:
 		print_indent (file, indent);
 		fprintf(file, "%d STROKE %s source:", i, common);
-		print_pattern (file, &command->stroke.source.base, source_region_id, indent + 1, recurse);
+		print_pattern (file, command->stroke.source, source_region_id, indent + 1, recurse);
 		break;
 
 	    case CAIRO_COMMAND_FILL:
 		print_indent (file, indent);
 		fprintf(file, "%d FILL %s source: ", i, common);
-		print_pattern (file, &command->fill.source.base, source_region_id, indent + 1, recurse);
+		print_pattern (file, command->fill.source, source_region_id, indent + 1, recurse);
 		break;
 
 	    case CAIRO_COMMAND_SHOW_TEXT_GLYPHS:
@@ -2858,7 +3240,7 @@ _cairo_debug_print_recording_surface (FILE            *file,
 		for (unsigned j = 0; j < command->show_text_glyphs.num_glyphs; j++)
 		    fprintf (file, " %ld", command->show_text_glyphs.glyphs[j].index);
 		fprintf (file, " source:");
-		print_pattern (file, &command->show_text_glyphs.source.base, source_region_id, indent + 1, recurse);
+		print_pattern (file, command->show_text_glyphs.source, source_region_id, indent + 1, recurse);
 		break;
 
 	    case CAIRO_COMMAND_TAG:
@@ -288,6 +288,44 @@ _cairo_box_add_curve_to (cairo_box_t *extents,
     }
 }
 
+static cairo_fixed_t
+_quad_extremum (cairo_fixed_t a, cairo_fixed_t b, cairo_fixed_t c)
+{
+    double fa = _cairo_fixed_to_double (a);
+    double fb = _cairo_fixed_to_double (b);
+    double fc = _cairo_fixed_to_double (c);
+    double d = fa - 2 * fb + fc;
+    double t;
+
+    /* the derivative 2 ((b - a) + t (a - 2b + c)) vanishes here */
+    if (d == 0)
+	return a;
+    t = (fa - fb) / d;
+    if (! (t > 0 && t < 1))
+	return a;
+
+    return _cairo_fixed_from_double ((1 - t) * (1 - t) * fa +
+				     2 * t * (1 - t) * fb +
+				     t * t * fc);
+}
+
+/* assumes a has been previously added */
+void
+_cairo_box_add_quad_to (cairo_box_t *extents,
+			const cairo_point_t *a,
+			const cairo_point_t *b,
+			const cairo_point_t *c)
+{
+    _cairo_box_add_point (extents, c);
+    if (! _cairo_box_contains_point (extents, b)) {
+	cairo_point_t p;
+
+	p.x = _quad_extremum (a->x, b->x, c->x);
+	p.y = _quad_extremum (a->y, b->y, c->y);
+	_cairo_box_add_point (extents, &p);
+    }
+}
+
 void
 _cairo_rectangle_int_from_double (cairo_rectangle_int_t *recti,
 				  const cairo_rectangle_t *rectf)
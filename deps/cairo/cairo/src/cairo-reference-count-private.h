@@ -44,9 +44,17 @@ typedef struct {
     cairo_atomic_int_t ref_count;
 } cairo_reference_count_t;
 
-#define _cairo_reference_count_inc(RC) _cairo_atomic_int_inc (&(RC)->ref_count)
+#if CAIRO_NO_MUTEX
+/* Without mutexes an object is only ever used by one thread at a time,
+ * so its reference count can be updated without atomic operations. */
+#define _cairo_reference_count_inc(RC) ((void) ++(RC)->ref_count)
+#define _cairo_reference_count_dec(RC) ((void) --(RC)->ref_count)
+#define _cairo_reference_count_dec_and_test(RC) (--(RC)->ref_count == 0)
+#else
+#define _cairo_reference_count_inc(RC) _cairo_atomic_int_inc_relaxed (&(RC)->ref_count)
 #define _cairo_reference_count_dec(RC) _cairo_atomic_int_dec (&(RC)->ref_count)
-#define _cairo_reference_count_dec_and_test(RC) _cairo_atomic_int_dec_and_test (&(RC)->ref_count)
+#define _cairo_reference_count_dec_and_test(RC) _cairo_atomic_int_dec_and_test_release (&(RC)->ref_count)
+#endif
 
 #define CAIRO_REFERENCE_COUNT_INIT(RC, VALUE) ((RC)->ref_count = (VALUE))
 
@@ -148,6 +148,8 @@ struct _cairo_scaled_glyph {
     void		   *dev_private;
     cairo_list_t            dev_privates;
 
+    size_t                  budget_size;	/* bytes charged to the cache budget */
+
     cairo_color_t           foreground_color;   /* only used for color glyphs */
 
     /* TRUE if the recording_surface used the foreground_source to render. */
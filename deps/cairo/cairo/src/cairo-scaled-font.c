@@ -43,7 +43,9 @@
 #include "cairo-error-private.h"
 #include "cairo-image-surface-private.h"
 #include "cairo-list-inline.h"
+#include "cairo-path-fixed-private.h"
 #include "cairo-pattern-private.h"
+#include "cairo-recording-surface-inline.h"
 #include "cairo-scaled-font-private.h"
 #include "cairo-surface-backend-private.h"
 
@@ -87,6 +89,84 @@ struct _cairo_scaled_glyph_page {
     cairo_scaled_glyph_t glyphs[CAIRO_SCALED_GLYPH_PAGE_SIZE];
 };
 
+/* The glyph pages are charged against the memory budget of
+ * cairo_cache_set_memory_budget(), together with the images, paths and
+ * recordings of their glyphs. Glyphs are expensive to rasterise again,
+ * so their cost is only exceeded by that of the scaled fonts kept as
+ * holdovers (see below), which lose all of their glyphs at once. */
+static void
+_cairo_scaled_glyph_page_cache_shrink (size_t size);
+
+static cairo_cache_budget_client_t _cairo_scaled_glyph_budget =
+    CAIRO_CACHE_BUDGET_CLIENT_INIT (4, _cairo_scaled_glyph_page_cache_shrink);
+
+static size_t
+_cairo_scaled_glyph_image_size (cairo_image_surface_t *image)
+{
+    if (image == NULL)
+	return 0;
+
+    return sizeof (cairo_image_surface_t) + (size_t) image->stride * image->height;
+}
+
+static size_t
+_cairo_scaled_glyph_path_size (cairo_path_fixed_t *path)
+{
+    cairo_path_buf_t *buf;
+    size_t size;
+
+    if (path == NULL)
+	return 0;
+
+    /* The first buffer is embedded in the path itself. */
+    size = sizeof (cairo_path_fixed_t);
+    buf = cairo_path_head (path);
+    while ((buf = cairo_path_buf_next (buf)) != cairo_path_head (path)) {
+	size += sizeof (cairo_path_buf_t) +
+		buf->size_ops * sizeof (cairo_path_op_t) +
+		buf->size_points * sizeof (cairo_point_t);
+    }
+
+    return size;
+}
+
+static size_t
+_cairo_scaled_glyph_recording_size (cairo_surface_t *surface)
+{
+    cairo_recording_surface_t *recording;
+
+    if (surface == NULL || ! _cairo_surface_is_recording (surface))
+	return 0;
+
+    /* The commands are allocated separately with sizes depending on
+     * their type; count each as the largest of them. */
+    recording = (cairo_recording_surface_t *) surface;
+    return sizeof (cairo_recording_surface_t) +
+	   _cairo_array_num_elements (&recording->commands) * sizeof (cairo_command_t);
+}
+
+/* Charge or release the difference after one of the representations of
+ * @scaled_glyph was replaced. */
+static void
+_cairo_scaled_glyph_update_budget (cairo_scaled_glyph_t *scaled_glyph)
+{
+    size_t size;
+
+    size = _cairo_scaled_glyph_image_size (scaled_glyph->surface) +
+	   _cairo_scaled_glyph_path_size (scaled_glyph->path) +
+	   _cairo_scaled_glyph_recording_size (scaled_glyph->recording_surface) +
+	   _cairo_scaled_glyph_image_size (scaled_glyph->color_surface);
+
+    if (size > scaled_glyph->budget_size)
+	_cairo_cache_budget_charge (&_cairo_scaled_glyph_budget,
+				    size - scaled_glyph->budget_size);
+    else if (size < scaled_glyph->budget_size)
+	_cairo_cache_budget_release (&_cairo_scaled_glyph_budget,
+				     scaled_glyph->budget_size - size);
+
+    scaled_glyph->budget_size = size;
+}
+
 /*
  *  Notes:
  *
@@ -199,6 +279,10 @@ static void
 _cairo_scaled_glyph_fini (cairo_scaled_font_t *scaled_font,
 			  cairo_scaled_glyph_t *scaled_glyph)
 {
+    _cairo_cache_budget_release (&_cairo_scaled_glyph_budget,
+				 scaled_glyph->budget_size);
+    scaled_glyph->budget_size = 0;
+
     while (! cairo_list_is_empty (&scaled_glyph->dev_privates)) {
 	cairo_scaled_glyph_private_t *private =
 	    cairo_list_first_entry (&scaled_glyph->dev_privates,
@@ -207,8 +291,6 @@ _cairo_scaled_glyph_fini (cairo_scaled_font_t *scaled_font,
 	private->destroy (private, scaled_glyph, scaled_font);
     }
 
-    _cairo_image_scaled_glyph_fini (scaled_font, scaled_glyph);
-
     if (scaled_glyph->surface != NULL)
 	cairo_surface_destroy (&scaled_glyph->surface->base);
 
@@ -370,6 +452,14 @@ typedef struct _cairo_scaled_font_map {
 
 static cairo_scaled_font_map_t *cairo_scaled_font_map;
 
+/* Each holdover is charged for itself only, as its glyphs are charged
+ * to the glyph page cache. */
+static void
+_cairo_scaled_font_holdovers_shrink (size_t size);
+
+static cairo_cache_budget_client_t _cairo_scaled_font_holdover_budget =
+    CAIRO_CACHE_BUDGET_CLIENT_INIT (8, _cairo_scaled_font_holdovers_shrink);
+
 static int
 _cairo_scaled_font_keys_equal (const void *abstract_key_a, const void *abstract_key_b);
 
@@ -439,6 +529,8 @@ _cairo_scaled_font_map_destroy (void)
 				  &scaled_font->hash_entry);
 
 	font_map->num_holdovers--;
+	_cairo_cache_budget_release (&_cairo_scaled_font_holdover_budget,
+				     sizeof (cairo_scaled_font_t));
 
 	/* This releases the font_map lock to avoid the possibility of a
 	 * recursive deadlock when the scaled font destroy closure gets
@@ -458,6 +550,44 @@ _cairo_scaled_font_map_destroy (void)
     CAIRO_MUTEX_UNLOCK (_cairo_scaled_font_map_mutex);
 }
 
+static void
+_cairo_scaled_font_holdovers_shrink (size_t size)
+{
+    cairo_scaled_font_map_t *font_map;
+    cairo_scaled_font_t *lru[CAIRO_SCALED_FONT_MAX_HOLDOVERS];
+    int i, n = 0;
+
+    CAIRO_MUTEX_LOCK (_cairo_scaled_font_map_mutex);
+    font_map = cairo_scaled_font_map;
+    if (font_map != NULL) {
+	while (n < font_map->num_holdovers &&
+	       n * sizeof (cairo_scaled_font_t) < size)
+	{
+	    lru[n] = font_map->holdovers[n];
+	    assert (! CAIRO_REFERENCE_COUNT_HAS_REFERENCE (&lru[n]->ref_count));
+	    _cairo_hash_table_remove (font_map->hash_table,
+				      &lru[n]->hash_entry);
+	    n++;
+	}
+
+	font_map->num_holdovers -= n;
+	memmove (&font_map->holdovers[0],
+		 &font_map->holdovers[n],
+		 font_map->num_holdovers * sizeof (cairo_scaled_font_t*));
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_scaled_font_map_mutex);
+
+    _cairo_cache_budget_release (&_cairo_scaled_font_holdover_budget,
+				 n * sizeof (cairo_scaled_font_t));
+
+    /* As in cairo_scaled_font_destroy(), nobody else can reach these
+     * fonts any more, so finish them without holding any lock. */
+    for (i = 0; i < n; i++) {
+	_cairo_scaled_font_fini_internal (lru[i]);
+	free (lru[i]);
+    }
+}
+
 static void
 _cairo_scaled_glyph_page_destroy (cairo_scaled_font_t *scaled_font,
 				  cairo_scaled_glyph_page_t *page)
@@ -475,6 +605,8 @@ _cairo_scaled_glyph_page_destroy (cairo_scaled_font_t *scaled_font,
 
     cairo_list_del (&page->link);
     free (page);
+
+    _cairo_cache_budget_release (&_cairo_scaled_glyph_budget, sizeof (*page));
 }
 
 static void
@@ -492,6 +624,25 @@ _cairo_scaled_glyph_page_pluck (void *closure)
     CAIRO_MUTEX_UNLOCK (scaled_font->mutex);
 }
 
+static void
+_cairo_scaled_glyph_page_cache_shrink (size_t size)
+{
+    size_t held, target;
+
+    held = _cairo_cache_budget_get_size (&_cairo_scaled_glyph_budget);
+    target = size < held ? held - size : 0;
+
+    /* Pages of fonts that are in use are skipped, as they are when
+     * making room for a new page. */
+    CAIRO_MUTEX_LOCK (_cairo_scaled_glyph_page_cache_mutex);
+    if (cairo_scaled_glyph_page_cache.hash_table != NULL) {
+	while (_cairo_cache_budget_get_size (&_cairo_scaled_glyph_budget) > target &&
+	       _cairo_cache_evict_one (&cairo_scaled_glyph_page_cache))
+	    ;
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_scaled_glyph_page_cache_mutex);
+}
+
 /* If a scaled font wants to unlock the font map while still being
  * created (needed for user-fonts), we need to take extra care not
  * ending up with multiple identical scaled fonts being created.
@@ -824,8 +975,8 @@ _cairo_scaled_font_freeze_cache (cairo_scaled_font_t *scaled_font)
     scaled_font->cache_frozen = TRUE;
 }
 
-void
-_cairo_scaled_font_thaw_cache (cairo_scaled_font_t *scaled_font)
+static void
+_cairo_scaled_font_thaw_cache_internal (cairo_scaled_font_t *scaled_font)
 {
     assert (scaled_font->cache_frozen);
 
@@ -842,6 +993,16 @@ _cairo_scaled_font_thaw_cache (cairo_scaled_font_t *scaled_font)
     CAIRO_MUTEX_UNLOCK (scaled_font->mutex);
 }
 
+void
+_cairo_scaled_font_thaw_cache (cairo_scaled_font_t *scaled_font)
+{
+    _cairo_scaled_font_thaw_cache_internal (scaled_font);
+
+    /* The glyphs looked up while the cache was frozen may have taken
+     * the caches over their memory budget. */
+    _cairo_cache_budget_enforce ();
+}
+
 void
 _cairo_scaled_font_reset_cache (cairo_scaled_font_t *scaled_font)
 {
@@ -1123,6 +1284,8 @@ cairo_scaled_font_create (cairo_font_face_t          *font_face,
 			memmove (&font_map->holdovers[i],
 				 &font_map->holdovers[i+1],
 				 (font_map->num_holdovers - i) * sizeof (cairo_scaled_font_t*));
+			_cairo_cache_budget_release (&_cairo_scaled_font_holdover_budget,
+						     sizeof (cairo_scaled_font_t));
 			break;
 		    }
 		}
@@ -1387,6 +1550,9 @@ cairo_scaled_font_destroy (cairo_scaled_font_t *scaled_font)
 		memmove (&font_map->holdovers[0],
 			 &font_map->holdovers[1],
 			 font_map->num_holdovers * sizeof (cairo_scaled_font_t*));
+	    } else {
+		_cairo_cache_budget_charge (&_cairo_scaled_font_holdover_budget,
+					    sizeof (cairo_scaled_font_t));
 	    }
 
 	    font_map->holdovers[font_map->num_holdovers++] = scaled_font;
@@ -1408,6 +1574,8 @@ cairo_scaled_font_destroy (cairo_scaled_font_t *scaled_font)
 	_cairo_scaled_font_fini_internal (lru);
 	free (lru);
     }
+
+    _cairo_cache_budget_enforce ();
 }
 slim_hidden_def (cairo_scaled_font_destroy);
 
@@ -1745,7 +1913,12 @@ cairo_scaled_font_text_to_glyphs_internal_cached (cairo_scaled_font_t		 *scaled_
 	cairo_scaled_glyph_t *scaled_glyph;
 	struct glyph_lut_elt *glyph_slot;
 
-	num_bytes = _cairo_utf8_get_char_validated (p, &unicode);
+	if ((unsigned char) *p < 0x80) {
+	    unicode = (unsigned char) *p;
+	    num_bytes = 1;
+	} else {
+	    num_bytes = _cairo_utf8_get_char_validated (p, &unicode);
+	}
 	p += num_bytes;
 
 	glyphs[i].x = x;
@@ -1809,7 +1982,12 @@ cairo_scaled_font_text_to_glyphs_internal_uncached (cairo_scaled_font_t	 *scaled
 	cairo_scaled_glyph_t *scaled_glyph;
 	cairo_status_t status;
 
-	num_bytes = _cairo_utf8_get_char_validated (p, &unicode);
+	if ((unsigned char) *p < 0x80) {
+	    unicode = (unsigned char) *p;
+	    num_bytes = 1;
+	} else {
+	    num_bytes = _cairo_utf8_get_char_validated (p, &unicode);
+	}
 	p += num_bytes;
 
 	glyphs[i].x = x;
@@ -2238,14 +2416,15 @@ _cairo_scaled_font_single_glyph_device_extents (cairo_scaled_font_t	 *scaled_fon
 }
 
 /*
- * Compute a device-space bounding box for the glyphs.
+ * Compute the unrounded device-space bounding box of the glyphs, and
+ * whether any two of them overlap.
  */
 cairo_status_t
-_cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
-					 const cairo_glyph_t	 *glyphs,
-					 int                      num_glyphs,
-					 cairo_rectangle_int_t   *extents,
-					 cairo_bool_t *overlap_out)
+_cairo_scaled_font_glyph_device_box (cairo_scaled_font_t	 *scaled_font,
+				     const cairo_glyph_t	 *glyphs,
+				     int			  num_glyphs,
+				     cairo_box_t		 *box_out,
+				     cairo_bool_t		 *overlap_out)
 {
     cairo_status_t status = CAIRO_STATUS_SUCCESS;
     cairo_box_t box = { { INT_MAX, INT_MAX }, { INT_MIN, INT_MIN }};
@@ -2257,14 +2436,6 @@ _cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
     if (unlikely (scaled_font->status))
 	return scaled_font->status;
 
-    if (num_glyphs == 1) {
-	if (overlap_out)
-	    *overlap_out = FALSE;
-	return _cairo_scaled_font_single_glyph_device_extents (scaled_font,
-							       glyphs,
-							       extents);
-    }
-
     _cairo_scaled_font_freeze_cache (scaled_font);
 
     memset (glyph_cache, 0, sizeof (glyph_cache));
@@ -2316,6 +2487,43 @@ _cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
     if (unlikely (status))
 	return _cairo_scaled_font_set_error (scaled_font, status);
 
+    *box_out = box;
+    if (overlap_out != NULL)
+	*overlap_out = overlap;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/*
+ * Compute a device-space bounding box for the glyphs.
+ */
+cairo_status_t
+_cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
+					 const cairo_glyph_t	 *glyphs,
+					 int                      num_glyphs,
+					 cairo_rectangle_int_t   *extents,
+					 cairo_bool_t *overlap_out)
+{
+    cairo_status_t status;
+    cairo_box_t box;
+
+    if (unlikely (scaled_font->status))
+	return scaled_font->status;
+
+    if (num_glyphs == 1) {
+	if (overlap_out)
+	    *overlap_out = FALSE;
+	return _cairo_scaled_font_single_glyph_device_extents (scaled_font,
+							       glyphs,
+							       extents);
+    }
+
+    status = _cairo_scaled_font_glyph_device_box (scaled_font,
+						  glyphs, num_glyphs,
+						  &box, overlap_out);
+    if (unlikely (status))
+	return status;
+
     if (box.p1.x < box.p2.x) {
 	_cairo_box_round_to_rectangle (&box, extents);
     } else {
@@ -2323,9 +2531,6 @@ _cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
 	extents->width = extents->height = 0;
     }
 
-    if (overlap_out != NULL)
-	*overlap_out = overlap;
-
     return CAIRO_STATUS_SUCCESS;
 }
 
@@ -2635,6 +2840,8 @@ _cairo_scaled_glyph_set_surface (cairo_scaled_glyph_t *scaled_glyph,
 	scaled_glyph->has_info |= CAIRO_SCALED_GLYPH_INFO_SURFACE;
     else
 	scaled_glyph->has_info &= ~CAIRO_SCALED_GLYPH_INFO_SURFACE;
+
+    _cairo_scaled_glyph_update_budget (scaled_glyph);
 }
 
 void
@@ -2651,6 +2858,8 @@ _cairo_scaled_glyph_set_path (cairo_scaled_glyph_t *scaled_glyph,
 	scaled_glyph->has_info |= CAIRO_SCALED_GLYPH_INFO_PATH;
     else
 	scaled_glyph->has_info &= ~CAIRO_SCALED_GLYPH_INFO_PATH;
+
+    _cairo_scaled_glyph_update_budget (scaled_glyph);
 }
 
 /**
@@ -2681,6 +2890,8 @@ _cairo_scaled_glyph_set_recording_surface (cairo_scaled_glyph_t *scaled_glyph,
 	scaled_glyph->has_info |= CAIRO_SCALED_GLYPH_INFO_RECORDING_SURFACE;
     else
 	scaled_glyph->has_info &= ~CAIRO_SCALED_GLYPH_INFO_RECORDING_SURFACE;
+
+    _cairo_scaled_glyph_update_budget (scaled_glyph);
 }
 
 /**
@@ -2712,6 +2923,8 @@ _cairo_scaled_glyph_set_color_surface (cairo_scaled_glyph_t  *scaled_glyph,
 	scaled_glyph->has_info |= CAIRO_SCALED_GLYPH_INFO_COLOR_SURFACE;
     else
 	scaled_glyph->has_info &= ~CAIRO_SCALED_GLYPH_INFO_COLOR_SURFACE;
+
+    _cairo_scaled_glyph_update_budget (scaled_glyph);
 }
 
 /* _cairo_hash_table_random_entry () predicate. To avoid race conditions,
@@ -2792,6 +3005,7 @@ _cairo_scaled_font_allocate_glyph (cairo_scaled_font_t *scaled_font,
 	return status;
     }
 
+    _cairo_cache_budget_charge (&_cairo_scaled_glyph_budget, sizeof (*page));
     cairo_list_add_tail (&page->link, &scaled_font->glyph_pages);
 
     *scaled_glyph = &page->glyphs[page->num_glyphs++];
@@ -2814,7 +3028,8 @@ _cairo_scaled_font_free_last_glyph (cairo_scaled_font_t *scaled_font,
     _cairo_scaled_glyph_fini (scaled_font, scaled_glyph);
 
     if (--page->num_glyphs == 0) {
-	_cairo_scaled_font_thaw_cache (scaled_font);
+	/* Without enforcing the budget, which could evict the page. */
+	_cairo_scaled_font_thaw_cache_internal (scaled_font);
 	CAIRO_MUTEX_LOCK (scaled_font->mutex);
 
 	CAIRO_MUTEX_LOCK (_cairo_scaled_glyph_page_cache_mutex);
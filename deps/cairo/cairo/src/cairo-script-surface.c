@@ -391,7 +391,8 @@ _antialias_to_string (cairo_antialias_t antialias)
 	"ANTIALIAS_SUBPIXEL",	/* CAIRO_ANTIALIAS_SUBPIXEL */
 	"ANTIALIAS_FAST",	/* CAIRO_ANTIALIAS_FAST */
 	"ANTIALIAS_GOOD",	/* CAIRO_ANTIALIAS_GOOD */
-	"ANTIALIAS_BEST"	/* CAIRO_ANTIALIAS_BEST */
+	"ANTIALIAS_BEST",	/* CAIRO_ANTIALIAS_BEST */
+	"ANTIALIAS_ADAPTIVE"	/* CAIRO_ANTIALIAS_ADAPTIVE */
     };
     assert (antialias < ARRAY_LENGTH (names));
     return names[antialias];
@@ -746,6 +746,78 @@ cleanup_converter:
     return status;
 }
 
+/* CAIRO_ANTIALIAS_ADAPTIVE renders on tor's fine grid unless the
+ * polygon is large and its edges touch only a small fraction of the
+ * pixels it covers. The coarser 4x4 grid of tor22 then changes the
+ * coverage of at most that fraction of the pixels, by at most a
+ * quarter each. The decision is made on the device space polygon, so
+ * it already accounts for the scale of the transformation. */
+#define ADAPTIVE_MIN_SIZE 64
+#define ADAPTIVE_MAX_EDGE_FRACTION 16
+
+static cairo_antialias_t
+adaptive_antialias (const cairo_polygon_t *polygon)
+{
+    int64_t width, height, boundary = 0;
+    int i;
+
+    width = _cairo_fixed_integer_ceil (polygon->extents.p2.x) -
+	    _cairo_fixed_integer_floor (polygon->extents.p1.x);
+    height = _cairo_fixed_integer_ceil (polygon->extents.p2.y) -
+	     _cairo_fixed_integer_floor (polygon->extents.p1.y);
+    if (width < ADAPTIVE_MIN_SIZE || height < ADAPTIVE_MIN_SIZE)
+	return CAIRO_ANTIALIAS_BEST;
+
+    /* Count the pixels crossed by each edge along its major axis. */
+    for (i = 0; i < polygon->num_edges; i++) {
+	const cairo_edge_t *edge = &polygon->edges[i];
+	int64_t dy = edge->bottom - edge->top;
+	int64_t dx = edge->line.p2.x - edge->line.p1.x;
+	int64_t ldy = edge->line.p2.y - edge->line.p1.y;
+
+	if (dx < 0)
+	    dx = -dx;
+	if (dy < ldy)
+	    dx = (double) dx * dy / ldy;
+
+	boundary += _cairo_fixed_integer_ceil (MAX (dx, dy)) + 1;
+	if (boundary * ADAPTIVE_MAX_EDGE_FRACTION > width * height)
+	    return CAIRO_ANTIALIAS_BEST;
+    }
+
+    return CAIRO_ANTIALIAS_FAST;
+}
+
+/* The active edge table converter only pays for its batched edge
+ * stepping once many edges cross each row; sparse polygons and those
+ * made mostly of vertical edges, which tor never steps, are better
+ * left to tor. */
+#define AET_MIN_ACTIVE_EDGES 32
+
+static cairo_bool_t
+polygon_is_complex (const cairo_polygon_t *polygon)
+{
+    int64_t height, covered = 0;
+    int i, vertical = 0;
+
+    if (polygon->num_edges < 2 * AET_MIN_ACTIVE_EDGES)
+	return FALSE;
+
+    height = polygon->extents.p2.y - polygon->extents.p1.y;
+    if (height <= 0)
+	return FALSE;
+
+    for (i = 0; i < polygon->num_edges; i++) {
+	const cairo_edge_t *edge = &polygon->edges[i];
+
+	covered += edge->bottom - edge->top;
+	vertical += edge->line.p1.x == edge->line.p2.x;
+    }
+
+    return 2 * vertical < polygon->num_edges &&
+	   covered >= AET_MIN_ACTIVE_EDGES * height;
+}
+
 static cairo_int_status_t
 composite_polygon (const cairo_spans_compositor_t	*compositor,
 		   cairo_composite_rectangles_t		 *extents,
@@ -772,6 +844,9 @@ composite_polygon (const cairo_spans_compositor_t	*compositor,
     } else {
 	const cairo_rectangle_int_t *r = &extents->unbounded;
 
+	if (antialias == CAIRO_ANTIALIAS_ADAPTIVE)
+	    antialias = adaptive_antialias (polygon);
+
 	if (antialias == CAIRO_ANTIALIAS_FAST) {
 	    converter = _cairo_tor22_scan_converter_create (r->x, r->y,
 							    r->x + r->width,
@@ -784,6 +859,12 @@ composite_polygon (const cairo_spans_compositor_t	*compositor,
 							   r->y + r->height,
 							   fill_rule);
 	    status = _cairo_mono_scan_converter_add_polygon (converter, polygon);
+	} else if (polygon_is_complex (polygon)) {
+	    converter = _cairo_aet_scan_converter_create (r->x, r->y,
+							  r->x + r->width,
+							  r->y + r->height,
+							  fill_rule, antialias);
+	    status = _cairo_aet_scan_converter_add_polygon (converter, polygon);
 	} else {
 	    converter = _cairo_tor_scan_converter_create (r->x, r->y,
 							  r->x + r->width,
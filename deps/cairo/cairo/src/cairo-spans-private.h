@@ -81,6 +81,16 @@ struct _cairo_scan_converter {
     cairo_status_t status;
 };
 
+/* The workspaces of destroyed scan converters, kept so that the
+ * following fills reuse their allocations.  A workspace is owned by a
+ * single converter while it is in use. */
+#define CAIRO_SCAN_CONVERTER_STASH_SIZE 4
+
+typedef struct _cairo_scan_converter_stash {
+    void *workspaces[CAIRO_SCAN_CONVERTER_STASH_SIZE];
+    int num_workspaces;
+} cairo_scan_converter_stash_t;
+
 /* Scan converter constructors. */
 
 cairo_private cairo_scan_converter_t *
@@ -94,6 +104,23 @@ cairo_private cairo_status_t
 _cairo_tor_scan_converter_add_polygon (void		*converter,
 				       const cairo_polygon_t *polygon);
 
+cairo_private void
+_cairo_tor_scan_converter_reset_static_data (void);
+
+cairo_private cairo_scan_converter_t *
+_cairo_aet_scan_converter_create (int			xmin,
+				  int			ymin,
+				  int			xmax,
+				  int			ymax,
+				  cairo_fill_rule_t	fill_rule,
+				  cairo_antialias_t	antialias);
+cairo_private cairo_status_t
+_cairo_aet_scan_converter_add_polygon (void		*converter,
+				       const cairo_polygon_t *polygon);
+
+cairo_private void
+_cairo_aet_scan_converter_reset_static_data (void);
+
 cairo_private cairo_scan_converter_t *
 _cairo_tor22_scan_converter_create (int			xmin,
 				    int			ymin,
@@ -105,6 +132,9 @@ cairo_private cairo_status_t
 _cairo_tor22_scan_converter_add_polygon (void		*converter,
 					 const cairo_polygon_t *polygon);
 
+cairo_private void
+_cairo_tor22_scan_converter_reset_static_data (void);
+
 cairo_private cairo_scan_converter_t *
 _cairo_mono_scan_converter_create (int			xmin,
 				   int			ymin,
@@ -115,6 +145,9 @@ cairo_private cairo_status_t
 _cairo_mono_scan_converter_add_polygon (void		*converter,
 					const cairo_polygon_t *polygon);
 
+cairo_private void
+_cairo_mono_scan_converter_reset_static_data (void);
+
 cairo_private cairo_scan_converter_t *
 _cairo_clip_tor_scan_converter_create (cairo_clip_t *clip,
 				       cairo_polygon_t *polygon,
@@ -177,6 +210,13 @@ _cairo_botor_scan_converter_add_polygon (cairo_botor_scan_converter_t *converter
 cairo_private cairo_scan_converter_t *
 _cairo_scan_converter_create_in_error (cairo_status_t error);
 
+cairo_private void *
+_cairo_scan_converter_stash_get (cairo_scan_converter_stash_t *stash);
+
+cairo_private cairo_bool_t
+_cairo_scan_converter_stash_put (cairo_scan_converter_stash_t *stash,
+				 void *workspace);
+
 cairo_private cairo_status_t
 _cairo_scan_converter_status (void *abstract_converter);
 
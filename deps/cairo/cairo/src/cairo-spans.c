@@ -68,6 +68,38 @@ _cairo_scan_converter_set_error (void *abstract_converter,
     return converter->status;
 }
 
+/* Takes a workspace out of @stash, or returns %NULL if it is empty. */
+void *
+_cairo_scan_converter_stash_get (cairo_scan_converter_stash_t *stash)
+{
+    void *workspace = NULL;
+
+    CAIRO_MUTEX_LOCK (_cairo_scan_converter_stash_mutex);
+    if (stash->num_workspaces)
+	workspace = stash->workspaces[--stash->num_workspaces];
+    CAIRO_MUTEX_UNLOCK (_cairo_scan_converter_stash_mutex);
+
+    return workspace;
+}
+
+/* Returns %FALSE if @stash is full, in which case the caller still
+ * owns @workspace. */
+cairo_bool_t
+_cairo_scan_converter_stash_put (cairo_scan_converter_stash_t *stash,
+				 void *workspace)
+{
+    cairo_bool_t stashed = FALSE;
+
+    CAIRO_MUTEX_LOCK (_cairo_scan_converter_stash_mutex);
+    if (stash->num_workspaces < ARRAY_LENGTH (stash->workspaces)) {
+	stash->workspaces[stash->num_workspaces++] = workspace;
+	stashed = TRUE;
+    }
+    CAIRO_MUTEX_UNLOCK (_cairo_scan_converter_stash_mutex);
+
+    return stashed;
+}
+
 static void
 _cairo_nil_scan_converter_init (cairo_scan_converter_t *converter,
 				cairo_status_t status)
@@ -272,6 +272,79 @@ _cairo_spline_decompose (cairo_spline_t *spline, double tolerance)
 				   &spline->knots.d, &spline->final_slope);
 }
 
+/* Decomposes the quadratic from @p0 to @p2 with control point @p1,
+ * handing every point after @p0 to @add_point_func. The second
+ * derivative of a quadratic is the constant 2 (p0 - 2 p1 + p2), so n
+ * uniform steps stray at most |p0 - 2 p1 + p2| / (4 n^2) from the curve
+ * and the number of segments needed for the tolerance is known up
+ * front, unlike for the subdivision of a cubic.
+ */
+cairo_status_t
+_cairo_spline_decompose_quad (cairo_spline_add_point_func_t add_point_func,
+			      void *closure,
+			      const cairo_point_t *p0,
+			      const cairo_point_t *p1,
+			      const cairo_point_t *p2,
+			      double tolerance)
+{
+    cairo_point_t point, last;
+    cairo_slope_t slope;
+    double x, y, dx, dy, ddx, ddy, h, segments;
+    cairo_fixed_t ax, ay, bx, by;
+    cairo_status_t status;
+    int i, n;
+
+    ax = p1->x - p0->x;
+    ay = p1->y - p0->y;
+    bx = p2->x - p1->x;
+    by = p2->y - p1->y;
+
+    x = _cairo_fixed_to_double (p0->x);
+    y = _cairo_fixed_to_double (p0->y);
+    ddx = _cairo_fixed_to_double (bx - ax);
+    ddy = _cairo_fixed_to_double (by - ay);
+
+    segments = ceil (sqrt (hypot (ddx, ddy) / (4 * tolerance)));
+    n = 1;
+    if (segments > 1)
+	n = segments < 1 << 16 ? segments : 1 << 16;
+
+    /* Forward differences of B(t) = p0 + 2t (p1 - p0) + t^2 (p0 - 2 p1 + p2) */
+    h = 1. / n;
+    dx = 2 * h * _cairo_fixed_to_double (ax) + h * h * ddx;
+    dy = 2 * h * _cairo_fixed_to_double (ay) + h * h * ddy;
+    ddx *= 2 * h * h;
+    ddy *= 2 * h * h;
+
+    last = *p0;
+    for (i = 1; i < n; i++) {
+	double t = i * h;
+
+	x += dx; dx += ddx;
+	y += dy; dy += ddy;
+
+	point.x = _cairo_fixed_from_double (x);
+	point.y = _cairo_fixed_from_double (y);
+	if (point.x == last.x && point.y == last.y)
+	    continue;
+
+	/* The tangent is (1 - t) (p1 - p0) + t (p2 - p1) */
+	slope.dx = _cairo_lround ((1 - t) * ax + t * bx);
+	slope.dy = _cairo_lround ((1 - t) * ay + t * by);
+	status = add_point_func (closure, &point, &slope);
+	if (unlikely (status))
+	    return status;
+
+	last = point;
+    }
+
+    if (bx || by)
+	_cairo_slope_init (&slope, p1, p2);
+    else
+	_cairo_slope_init (&slope, p0, p2);
+    return add_point_func (closure, p2, &slope);
+}
+
 /* Note: this function is only good for computing bounds in device space. */
 cairo_status_t
 _cairo_spline_bound (cairo_spline_add_point_func_t add_point_func,
@@ -53,7 +53,7 @@ struct stat {
 #define NUM_OPERATORS (CAIRO_OPERATOR_HSL_LUMINOSITY+1)
 #define NUM_CAPS (CAIRO_LINE_CAP_SQUARE+1)
 #define NUM_JOINS (CAIRO_LINE_JOIN_BEVEL+1)
-#define NUM_ANTIALIAS (CAIRO_ANTIALIAS_BEST+1)
+#define NUM_ANTIALIAS (CAIRO_ANTIALIAS_ADAPTIVE+1)
 #define NUM_FILL_RULE (CAIRO_FILL_RULE_EVEN_ODD+1)
 
 struct extents {
@@ -1682,7 +1682,8 @@ static const char *antialias_names[] = {
     "subpixel",
     "fast",
     "good",
-    "best"
+    "best",
+    "adaptive"
 };
 static void
 print_antialias (cairo_output_stream_t *stream, unsigned int *array)
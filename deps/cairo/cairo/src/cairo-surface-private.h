@@ -107,6 +107,10 @@ struct _cairo_surface {
 
     cairo_pattern_t *foreground_source;
     cairo_bool_t foreground_used;
+
+    /* Precomputed extents of the glyphs being shown, if they are those
+     * of a glyph run, see _cairo_gstate_show_glyph_run() */
+    const cairo_glyph_run_extents_t *glyph_run_extents;
 };
 
 cairo_private cairo_surface_t *
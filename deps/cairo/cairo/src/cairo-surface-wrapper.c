@@ -441,7 +441,6 @@ _cairo_surface_wrapper_show_text_glyphs (cairo_surface_wrapper_t    *wrapper,
 
     if (wrapper->needs_transform || source_region_id != 0) {
 	cairo_matrix_t m;
-	int i;
 
 	_cairo_surface_wrapper_get_transform (wrapper, &m);
 
@@ -464,12 +463,7 @@ _cairo_surface_wrapper_show_text_glyphs (cairo_surface_wrapper_t    *wrapper,
 	    }
 	}
 
-	for (i = 0; i < num_glyphs; i++) {
-	    dev_glyphs[i] = glyphs[i];
-	    cairo_matrix_transform_point (&m,
-					  &dev_glyphs[i].x,
-					  &dev_glyphs[i].y);
-	}
+	_cairo_matrix_transform_glyphs (&m, glyphs, dev_glyphs, num_glyphs);
 
 	status = cairo_matrix_invert (&m);
 	assert (status == CAIRO_STATUS_SUCCESS);
@@ -137,6 +137,7 @@ const cairo_surface_t name = {					\
     },					/* font_options */		\
     NULL,                               /* foreground_source */		\
     FALSE,                              /* foreground_used */   \
+    NULL,                               /* glyph_run_extents */ \
 }
 
 /* XXX error object! */
@@ -444,6 +445,7 @@ _cairo_surface_init (cairo_surface_t			*surface,
 
     surface->foreground_source = NULL;
     surface->foreground_used = FALSE;
+    surface->glyph_run_extents = NULL;
 }
 
 static void
@@ -1378,19 +1378,19 @@ _cairo_svg_document_emit_bitmap_glyph_data (cairo_svg_document_t *document,
 	    if (command->header.type == CAIRO_COMMAND_MASK &&
 		command->header.op == CAIRO_OPERATOR_OVER &&
 		command->header.clip == NULL &&
-		command->mask.source.base.type == CAIRO_PATTERN_TYPE_SOLID &&
-		_cairo_color_equal (&command->mask.source.solid.color, _cairo_stock_color (CAIRO_STOCK_BLACK)) &&
-		command->mask.mask.base.extend == CAIRO_EXTEND_NONE &&
-		command->mask.mask.base.type == CAIRO_PATTERN_TYPE_SURFACE &&
-		command->mask.mask.surface.surface->type == CAIRO_SURFACE_TYPE_IMAGE) {
-		extracted_surface = command->mask.mask.surface.surface;
+		command->mask.source->type == CAIRO_PATTERN_TYPE_SOLID &&
+		_cairo_color_equal (&((cairo_solid_pattern_t *) command->mask.source)->color, _cairo_stock_color (CAIRO_STOCK_BLACK)) &&
+		command->mask.mask->extend == CAIRO_EXTEND_NONE &&
+		command->mask.mask->type == CAIRO_PATTERN_TYPE_SURFACE &&
+		((cairo_surface_pattern_t *) command->mask.mask)->surface->type == CAIRO_SURFACE_TYPE_IMAGE) {
+		extracted_surface = ((cairo_surface_pattern_t *) command->mask.mask)->surface;
 		if (_cairo_surface_acquire_source_image (extracted_surface,
 							 &extracted_image,
 							 &extracted_image_extra) == CAIRO_STATUS_SUCCESS) {
 		    if (extracted_image->format == CAIRO_FORMAT_A1 || extracted_image->format == CAIRO_FORMAT_A8) {
 			use_recording_surface = FALSE;
 			glyph_image_surface = extracted_image;
-			glyph_matrix = command->mask.mask.base.matrix;
+			glyph_matrix = command->mask.mask->matrix;
 			status = cairo_matrix_invert (&glyph_matrix);
 			assert (status == CAIRO_STATUS_SUCCESS);
 		    }
@@ -0,0 +1,926 @@
+/* cairo - a vector graphics library with display and print output
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it either under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ * (the "LGPL") or, at your option, under the terms of the Mozilla
+ * Public License Version 1.1 (the "MPL"). If you do not alter this
+ * notice, a recipient may use your version of this file under either
+ * the MPL or the LGPL.
+ *
+ * You should have received a copy of the LGPL along with this library
+ * in the file COPYING-LGPL-2.1; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335, USA
+ * You should have received a copy of the MPL along with this library
+ * in the file COPYING-MPL-1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY
+ * OF ANY KIND, either express or implied. See the LGPL or the MPL for
+ * the specific language governing rights and limitations.
+ *
+ * The Original Code is the cairo graphics library.
+ */
+
+/**
+ * SECTION:cairo-tiled
+ * @Title: Tiled Surfaces
+ * @Short_Description: Rendering to very large memory buffers
+ * @See_Also: #cairo_surface_t, #cairo_image_surface_t
+ *
+ * A tiled surface behaves like an image surface whose pixels are split
+ * into fixed-size square tiles, each of which is an ordinary image
+ * surface. Tiles are only allocated once something is drawn onto them,
+ * so the memory used is proportional to the drawn content rather than
+ * to the size of the surface, and the surface itself is not restricted
+ * to the 32767 pixel limit of image surfaces.
+ *
+ * Every drawing operation is forwarded to each affected tile in turn and
+ * rendered there by the image backend. The pixels are read back either
+ * tile by tile with cairo_tiled_surface_foreach_tile(), or for a
+ * rectangle of ordinary image size with cairo_surface_map_to_image().
+ *
+ * When a tiled surface is used as a source for drawing onto an image
+ * or tiled surface, only the region that is sampled is read from the
+ * tiles, so the sampled area must fit within the image size limit,
+ * rather than the whole surface. Other backends, and repeated or
+ * reflected sources that wrap around within the sample, still read
+ * the whole surface and fail beyond that limit. Groups pushed on a
+ * tiled surface are image surfaces covering the group's extents, or
+ * tiled surfaces if those extents are beyond the image size limit.
+ **/
+
+#include "cairoint.h"
+
+#include "cairo-composite-rectangles-private.h"
+#include "cairo-default-context-private.h"
+#include "cairo-error-private.h"
+#include "cairo-image-surface-private.h"
+#include "cairo-surface-backend-private.h"
+#include "cairo-surface-offset-private.h"
+#include "cairo-tiled-surface-private.h"
+
+/* Device-space coordinates beyond this do not fit in cairo_fixed_t */
+#define MAX_TILED_SIZE ((1 << (CAIRO_FIXED_BITS - CAIRO_FIXED_FRAC_BITS - 1)) - 1)
+
+/* The largest image surface, as in cairo-image-surface.c */
+#define MAX_IMAGE_SIZE 32767
+
+typedef struct _cairo_tile {
+    cairo_hash_entry_t base;
+
+    int col, row;
+    cairo_surface_t *image;
+} cairo_tile_t;
+
+typedef struct _cairo_tiled_surface {
+    cairo_surface_t base;
+
+    cairo_format_t format;
+    int width, height;
+    int tile_size;
+    int num_cols, num_rows;
+
+    cairo_hash_table_t *tiles;
+    int num_tiles;
+
+    /* bounds of the allocated tiles, in tile units */
+    cairo_rectangle_int_t allocated;
+} cairo_tiled_surface_t;
+
+static const cairo_surface_backend_t _cairo_tiled_surface_backend;
+
+static cairo_bool_t
+_cairo_surface_is_tiled (const cairo_surface_t *surface)
+{
+    return surface->backend == &_cairo_tiled_surface_backend;
+}
+
+static cairo_bool_t
+_cairo_tile_equal (const void *key_a, const void *key_b)
+{
+    const cairo_tile_t *a = key_a;
+    const cairo_tile_t *b = key_b;
+
+    return a->col == b->col && a->row == b->row;
+}
+
+static void
+_cairo_tile_init_key (cairo_tiled_surface_t *surface,
+		      cairo_tile_t *key,
+		      int col, int row)
+{
+    key->base.hash = (uintptr_t) row * surface->num_cols + col;
+    key->col = col;
+    key->row = row;
+}
+
+static void
+_cairo_tiled_surface_get_tile_extents (cairo_tiled_surface_t *surface,
+				       int col, int row,
+				       cairo_rectangle_int_t *extents)
+{
+    extents->x = col * surface->tile_size;
+    extents->y = row * surface->tile_size;
+    extents->width  = MIN (surface->tile_size, surface->width  - extents->x);
+    extents->height = MIN (surface->tile_size, surface->height - extents->y);
+}
+
+static cairo_tile_t *
+_cairo_tiled_surface_lookup (cairo_tiled_surface_t *surface,
+			     int col, int row)
+{
+    cairo_tile_t key;
+
+    _cairo_tile_init_key (surface, &key, col, row);
+    return _cairo_hash_table_lookup (surface->tiles, &key.base);
+}
+
+static cairo_status_t
+_cairo_tiled_surface_create_tile (cairo_tiled_surface_t *surface,
+				  int col, int row,
+				  cairo_tile_t **tile_out)
+{
+    cairo_rectangle_int_t extents;
+    cairo_rectangle_int_t bounds;
+    cairo_tile_t *tile;
+    cairo_status_t status;
+
+    tile = _cairo_malloc (sizeof (cairo_tile_t));
+    if (unlikely (tile == NULL))
+	return _cairo_error (CAIRO_STATUS_NO_MEMORY);
+
+    _cairo_tiled_surface_get_tile_extents (surface, col, row, &extents);
+    tile->image = cairo_image_surface_create (surface->format,
+					      extents.width,
+					      extents.height);
+    if (unlikely (tile->image->status)) {
+	status = tile->image->status;
+	free (tile);
+	return status;
+    }
+
+    _cairo_tile_init_key (surface, tile, col, row);
+    status = _cairo_hash_table_insert (surface->tiles, &tile->base);
+    if (unlikely (status)) {
+	cairo_surface_destroy (tile->image);
+	free (tile);
+	return status;
+    }
+
+    bounds.x = col;
+    bounds.y = row;
+    bounds.width = bounds.height = 1;
+    if (surface->num_tiles++)
+	_cairo_rectangle_union (&surface->allocated, &bounds);
+    else
+	surface->allocated = bounds;
+
+    *tile_out = tile;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/* Converts a rectangle in pixels to the range of tiles it touches */
+static void
+_cairo_tiled_surface_tile_range (cairo_tiled_surface_t *surface,
+				 const cairo_rectangle_int_t *rect,
+				 cairo_rectangle_int_t *range)
+{
+    int x2 = rect->x + rect->width;
+    int y2 = rect->y + rect->height;
+
+    range->x = rect->x / surface->tile_size;
+    range->y = rect->y / surface->tile_size;
+    range->width  = (x2 + surface->tile_size - 1) / surface->tile_size - range->x;
+    range->height = (y2 + surface->tile_size - 1) / surface->tile_size - range->y;
+}
+
+/* Whether drawing with @op leaves a tile that is still clear untouched,
+ * in which case there is no need to allocate it.
+ */
+static cairo_bool_t
+_cairo_tiled_surface_op_preserves_clear (cairo_tiled_surface_t *surface,
+					 cairo_operator_t op)
+{
+    switch ((int) op) {
+    case CAIRO_OPERATOR_CLEAR:
+    case CAIRO_OPERATOR_DEST:
+    case CAIRO_OPERATOR_DEST_IN:
+    case CAIRO_OPERATOR_DEST_OUT:
+	return TRUE;
+    case CAIRO_OPERATOR_IN:
+    case CAIRO_OPERATOR_ATOP:
+	return surface->base.content & CAIRO_CONTENT_ALPHA;
+    default:
+	return FALSE;
+    }
+}
+
+typedef struct _cairo_tile_iter {
+    cairo_tiled_surface_t *surface;
+
+    cairo_rectangle_int_t range;
+    cairo_rectangle_int_t alloc_range;
+    cairo_bool_t allocate;
+    int col, row;
+
+    cairo_rectangle_int_t extents;
+    cairo_status_t status;
+} cairo_tile_iter_t;
+
+/* Visits the tiles affected by a drawing operation: the tiles that
+ * are already allocated within the area it may modify, plus newly
+ * allocated ones where it may draw. Outside its bounded extents an
+ * operation can only leave a pixel as it is or clear it, so a tile
+ * that is still clear there is skipped.
+ */
+static void
+_cairo_tile_iter_init (cairo_tile_iter_t *iter,
+		       cairo_tiled_surface_t *surface,
+		       const cairo_composite_rectangles_t *extents)
+{
+    iter->surface = surface;
+    iter->status = CAIRO_STATUS_SUCCESS;
+
+    _cairo_tiled_surface_tile_range (surface,
+				     extents->is_bounded ? &extents->bounded : &extents->unbounded,
+				     &iter->range);
+    _cairo_tiled_surface_tile_range (surface, &extents->bounded, &iter->alloc_range);
+    iter->allocate = extents->bounded.width && extents->bounded.height &&
+		     ! _cairo_tiled_surface_op_preserves_clear (surface, extents->op);
+
+    /* Elsewhere only the allocated tiles need to be visited */
+    if (surface->num_tiles == 0 ||
+	! _cairo_rectangle_intersect (&iter->range, &surface->allocated))
+    {
+	iter->range.width = iter->range.height = 0;
+    }
+
+    if (iter->allocate) {
+	if (iter->range.width)
+	    _cairo_rectangle_union (&iter->range, &iter->alloc_range);
+	else
+	    iter->range = iter->alloc_range;
+    }
+
+    iter->col = iter->range.x;
+    iter->row = iter->range.y;
+}
+
+static cairo_tile_t *
+_cairo_tile_iter_next (cairo_tile_iter_t *iter)
+{
+    cairo_tiled_surface_t *surface = iter->surface;
+    cairo_tile_t *tile;
+
+    if (iter->range.width <= 0)
+	return NULL;
+
+    while (iter->row < iter->range.y + iter->range.height) {
+	int col = iter->col, row = iter->row;
+
+	if (++iter->col == iter->range.x + iter->range.width) {
+	    iter->col = iter->range.x;
+	    iter->row++;
+	}
+
+	tile = _cairo_tiled_surface_lookup (surface, col, row);
+	if (tile == NULL && iter->allocate &&
+	    col >= iter->alloc_range.x &&
+	    col <  iter->alloc_range.x + iter->alloc_range.width &&
+	    row >= iter->alloc_range.y &&
+	    row <  iter->alloc_range.y + iter->alloc_range.height)
+	{
+	    iter->status = _cairo_tiled_surface_create_tile (surface,
+							     col, row,
+							     &tile);
+	    if (unlikely (iter->status))
+		return NULL;
+	}
+
+	if (tile != NULL) {
+	    _cairo_tiled_surface_get_tile_extents (surface, col, row,
+						   &iter->extents);
+	    return tile;
+	}
+    }
+
+    return NULL;
+}
+
+static void
+_cairo_tile_destroy (void *entry, void *closure)
+{
+    cairo_tiled_surface_t *surface = closure;
+    cairo_tile_t *tile = entry;
+
+    _cairo_hash_table_remove (surface->tiles, &tile->base);
+    cairo_surface_destroy (tile->image);
+    free (tile);
+}
+
+static cairo_status_t
+_cairo_tiled_surface_finish (void *abstract_surface)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+
+    _cairo_hash_table_foreach (surface->tiles, _cairo_tile_destroy, surface);
+    _cairo_hash_table_destroy (surface->tiles);
+    surface->num_tiles = 0;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/* Similar surfaces, such as groups, cover just the extents they are
+ * asked for, so they are plain images unless those are too large.
+ */
+static cairo_surface_t *
+_cairo_tiled_surface_create_similar (void *abstract_surface,
+				     cairo_content_t content,
+				     int width, int height)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+
+    if (width <= MAX_IMAGE_SIZE && height <= MAX_IMAGE_SIZE)
+	return _cairo_image_surface_create_with_content (content,
+							 width, height);
+
+    return cairo_tiled_surface_create (_cairo_format_from_content (content),
+				       width, height,
+				       surface->tile_size);
+}
+
+/* Copies the allocated tiles within @extents into @image, whose origin
+ * lies at (@extents->x, @extents->y) and which has been cleared.
+ */
+static void
+_cairo_tiled_surface_read_tiles (cairo_tiled_surface_t *surface,
+				 const cairo_rectangle_int_t *extents,
+				 pixman_image_t *image)
+{
+    cairo_rectangle_int_t range;
+    int col, row;
+
+    if (surface->num_tiles == 0)
+	return;
+
+    _cairo_tiled_surface_tile_range (surface, extents, &range);
+    if (! _cairo_rectangle_intersect (&range, &surface->allocated))
+	return;
+
+    for (row = range.y; row < range.y + range.height; row++) {
+	for (col = range.x; col < range.x + range.width; col++) {
+	    cairo_rectangle_int_t rect;
+	    cairo_tile_t *tile;
+
+	    tile = _cairo_tiled_surface_lookup (surface, col, row);
+	    if (tile == NULL)
+		continue;
+
+	    _cairo_tiled_surface_get_tile_extents (surface, col, row, &rect);
+	    if (! _cairo_rectangle_intersect (&rect, extents))
+		continue;
+
+	    pixman_image_composite32 (PIXMAN_OP_SRC,
+				      to_image_surface (tile->image)->pixman_image,
+				      NULL,
+				      image,
+				      rect.x % surface->tile_size,
+				      rect.y % surface->tile_size,
+				      0, 0,
+				      rect.x - extents->x,
+				      rect.y - extents->y,
+				      rect.width, rect.height);
+	}
+    }
+}
+
+static cairo_image_surface_t *
+_cairo_tiled_surface_map_to_image (void *abstract_surface,
+				   const cairo_rectangle_int_t *extents)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_surface_t *image;
+
+    image = cairo_image_surface_create (surface->format,
+					extents->width,
+					extents->height);
+    if (unlikely (image->status))
+	return to_image_surface (image);
+
+    cairo_surface_set_device_offset (image, -extents->x, -extents->y);
+    _cairo_tiled_surface_read_tiles (surface, extents,
+				     to_image_surface (image)->pixman_image);
+
+    return to_image_surface (image);
+}
+
+/**
+ * _cairo_tiled_surface_read_region:
+ * @surface: a tiled surface
+ * @extents: the area to read, which must lie within @surface
+ *
+ * Reads the pixels of @surface within @extents into a new pixman image,
+ * whose origin lies at (@extents->x, @extents->y). The image backend
+ * samples tiled sources this way, so that only the area an operation
+ * needs has to fit within the image size limit.
+ *
+ * Return value: the new image, or %NULL if it cannot be allocated.
+ **/
+pixman_image_t *
+_cairo_tiled_surface_read_region (cairo_surface_t *abstract_surface,
+				  const cairo_rectangle_int_t *extents)
+{
+    cairo_tiled_surface_t *surface = (cairo_tiled_surface_t *) abstract_surface;
+    pixman_image_t *image;
+
+    assert (_cairo_surface_is_tiled (abstract_surface));
+
+    image = pixman_image_create_bits (_cairo_format_to_pixman_format_code (surface->format),
+				      extents->width, extents->height,
+				      NULL, 0);
+    if (unlikely (image == NULL))
+	return NULL;
+
+    _cairo_tiled_surface_read_tiles (surface, extents, image);
+    return image;
+}
+
+/* Reads the whole surface, for backends that cannot sample it through
+ * _cairo_tiled_surface_read_region().
+ */
+static cairo_status_t
+_cairo_tiled_surface_acquire_source_image (void                    *abstract_surface,
+					   cairo_image_surface_t  **image_out,
+					   void                   **image_extra)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_rectangle_int_t extents;
+    cairo_surface_t *image;
+
+    extents.x = extents.y = 0;
+    extents.width  = surface->width;
+    extents.height = surface->height;
+
+    /* Fails for surfaces beyond the image size limit */
+    image = cairo_image_surface_create (surface->format,
+					extents.width,
+					extents.height);
+    if (unlikely (image->status))
+	return image->status;
+
+    _cairo_tiled_surface_read_tiles (surface, &extents,
+				     to_image_surface (image)->pixman_image);
+
+    *image_out = to_image_surface (image);
+    *image_extra = NULL;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static void
+_cairo_tiled_surface_release_source_image (void                   *abstract_surface,
+					   cairo_image_surface_t  *image,
+					   void                   *image_extra)
+{
+    cairo_surface_destroy (&image->base);
+}
+
+static cairo_bool_t
+_cairo_tiled_surface_get_extents (void *abstract_surface,
+				  cairo_rectangle_int_t *extents)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+
+    extents->x = 0;
+    extents->y = 0;
+    extents->width  = surface->width;
+    extents->height = surface->height;
+
+    return TRUE;
+}
+
+static void
+_cairo_tiled_surface_get_font_options (void                  *abstract_surface,
+				       cairo_font_options_t  *options)
+{
+    _cairo_font_options_init_default (options);
+
+    cairo_font_options_set_hint_metrics (options, CAIRO_HINT_METRICS_ON);
+    _cairo_font_options_set_round_glyph_positions (options, CAIRO_ROUND_GLYPH_POS_ON);
+}
+
+static cairo_int_status_t
+_cairo_tiled_surface_paint (void			*abstract_surface,
+			    cairo_operator_t		 op,
+			    const cairo_pattern_t	*source,
+			    const cairo_clip_t		*clip)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_composite_rectangles_t extents;
+    cairo_tile_iter_t iter;
+    cairo_tile_t *tile;
+    cairo_int_status_t status;
+
+    status = _cairo_composite_rectangles_init_for_paint (&extents,
+							 &surface->base,
+							 op, source, clip);
+    if (unlikely (status))
+	return status;
+
+    _cairo_tile_iter_init (&iter, surface, &extents);
+    while ((tile = _cairo_tile_iter_next (&iter)) != NULL) {
+	status = _cairo_surface_offset_paint (tile->image,
+					      iter.extents.x, iter.extents.y,
+					      op, source, extents.clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    _cairo_composite_rectangles_fini (&extents);
+    return status ? status : iter.status;
+}
+
+static cairo_int_status_t
+_cairo_tiled_surface_mask (void			*abstract_surface,
+			   cairo_operator_t	 op,
+			   const cairo_pattern_t	*source,
+			   const cairo_pattern_t	*mask,
+			   const cairo_clip_t	*clip)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_composite_rectangles_t extents;
+    cairo_tile_iter_t iter;
+    cairo_tile_t *tile;
+    cairo_int_status_t status;
+
+    status = _cairo_composite_rectangles_init_for_mask (&extents,
+							&surface->base,
+							op, source, mask, clip);
+    if (unlikely (status))
+	return status;
+
+    _cairo_tile_iter_init (&iter, surface, &extents);
+    while ((tile = _cairo_tile_iter_next (&iter)) != NULL) {
+	status = _cairo_surface_offset_mask (tile->image,
+					     iter.extents.x, iter.extents.y,
+					     op, source, mask, extents.clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    _cairo_composite_rectangles_fini (&extents);
+    return status ? status : iter.status;
+}
+
+static cairo_int_status_t
+_cairo_tiled_surface_stroke (void			*abstract_surface,
+			     cairo_operator_t		 op,
+			     const cairo_pattern_t	*source,
+			     const cairo_path_fixed_t	*path,
+			     const cairo_stroke_style_t	*style,
+			     const cairo_matrix_t	*ctm,
+			     const cairo_matrix_t	*ctm_inverse,
+			     double			 tolerance,
+			     cairo_antialias_t		 antialias,
+			     const cairo_clip_t		*clip)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_composite_rectangles_t extents;
+    cairo_tile_iter_t iter;
+    cairo_tile_t *tile;
+    cairo_int_status_t status;
+
+    status = _cairo_composite_rectangles_init_for_stroke (&extents,
+							  &surface->base,
+							  op, source,
+							  path, style, ctm,
+							  clip);
+    if (unlikely (status))
+	return status;
+
+    _cairo_tile_iter_init (&iter, surface, &extents);
+    while ((tile = _cairo_tile_iter_next (&iter)) != NULL) {
+	status = _cairo_surface_offset_stroke (tile->image,
+					       iter.extents.x, iter.extents.y,
+					       op, source, path, style,
+					       ctm, ctm_inverse,
+					       tolerance, antialias,
+					       extents.clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    _cairo_composite_rectangles_fini (&extents);
+    return status ? status : iter.status;
+}
+
+static cairo_int_status_t
+_cairo_tiled_surface_fill (void			*abstract_surface,
+			   cairo_operator_t	 op,
+			   const cairo_pattern_t	*source,
+			   const cairo_path_fixed_t	*path,
+			   cairo_fill_rule_t	 fill_rule,
+			   double		 tolerance,
+			   cairo_antialias_t	 antialias,
+			   const cairo_clip_t	*clip)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_composite_rectangles_t extents;
+    cairo_tile_iter_t iter;
+    cairo_tile_t *tile;
+    cairo_int_status_t status;
+
+    status = _cairo_composite_rectangles_init_for_fill (&extents,
+							&surface->base,
+							op, source, path,
+							clip);
+    if (unlikely (status))
+	return status;
+
+    _cairo_tile_iter_init (&iter, surface, &extents);
+    while ((tile = _cairo_tile_iter_next (&iter)) != NULL) {
+	status = _cairo_surface_offset_fill (tile->image,
+					     iter.extents.x, iter.extents.y,
+					     op, source, path,
+					     fill_rule, tolerance, antialias,
+					     extents.clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    _cairo_composite_rectangles_fini (&extents);
+    return status ? status : iter.status;
+}
+
+static cairo_int_status_t
+_cairo_tiled_surface_glyphs (void			*abstract_surface,
+			     cairo_operator_t		 op,
+			     const cairo_pattern_t	*source,
+			     cairo_glyph_t		*glyphs,
+			     int			 num_glyphs,
+			     cairo_scaled_font_t	*scaled_font,
+			     const cairo_clip_t		*clip)
+{
+    cairo_tiled_surface_t *surface = abstract_surface;
+    cairo_composite_rectangles_t extents;
+    cairo_tile_iter_t iter;
+    cairo_tile_t *tile;
+    cairo_bool_t overlap;
+    cairo_int_status_t status;
+
+    status = _cairo_composite_rectangles_init_for_glyphs (&extents,
+							  &surface->base,
+							  op, source,
+							  scaled_font,
+							  glyphs, num_glyphs,
+							  clip,
+							  &overlap);
+    if (unlikely (status))
+	return status;
+
+    _cairo_tile_iter_init (&iter, surface, &extents);
+    while ((tile = _cairo_tile_iter_next (&iter)) != NULL) {
+	status = _cairo_surface_offset_glyphs (tile->image,
+					       iter.extents.x, iter.extents.y,
+					       op, source,
+					       scaled_font, glyphs, num_glyphs,
+					       extents.clip);
+	if (unlikely (status))
+	    break;
+    }
+
+    _cairo_composite_rectangles_fini (&extents);
+    return status ? status : iter.status;
+}
+
+static const cairo_surface_backend_t _cairo_tiled_surface_backend = {
+    CAIRO_SURFACE_TYPE_TILED,
+    _cairo_tiled_surface_finish,
+
+    _cairo_default_context_create,
+
+    _cairo_tiled_surface_create_similar,
+    NULL, /* create similar image */
+    _cairo_tiled_surface_map_to_image,
+    NULL, /* unmap image: painted back through the tiles */
+
+    _cairo_surface_default_source,
+    _cairo_tiled_surface_acquire_source_image,
+    _cairo_tiled_surface_release_source_image,
+    NULL, /* snapshot */
+
+    NULL, /* copy_page */
+    NULL, /* show_page */
+
+    _cairo_tiled_surface_get_extents,
+    _cairo_tiled_surface_get_font_options,
+
+    NULL, /* flush */
+    NULL, /* mark dirty */
+
+    _cairo_tiled_surface_paint,
+    _cairo_tiled_surface_mask,
+    _cairo_tiled_surface_stroke,
+    _cairo_tiled_surface_fill,
+    NULL, /* fill/stroke */
+    _cairo_tiled_surface_glyphs,
+};
+
+/**
+ * cairo_tiled_surface_create:
+ * @format: format of pixels in the surface to create
+ * @width: width of the surface, in pixels
+ * @height: height of the surface, in pixels
+ * @tile_size: width and height of each tile, in pixels
+ *
+ * Creates a tiled surface of the specified format and dimensions.
+ * The surface is split into square tiles of @tile_size pixels, each
+ * of which is allocated the first time something is drawn onto it.
+ * Unlike image surfaces, the dimensions may exceed 32767 pixels; they
+ * are limited only by the range of cairo's fixed-point coordinates.
+ *
+ * Initially the surface contents are set to 0, in the same way as for
+ * cairo_image_surface_create().
+ *
+ * Return value: a pointer to the newly created surface. The caller
+ * owns the surface and should call cairo_surface_destroy() when done
+ * with it.
+ *
+ * This function always returns a valid pointer, but it will return a
+ * pointer to a "nil" surface if an error such as out of memory
+ * occurs. You can use cairo_surface_status() to check for this.
+ *
+ * Since: 1.18
+ **/
+cairo_surface_t *
+cairo_tiled_surface_create (cairo_format_t	format,
+			    int			width,
+			    int			height,
+			    int			tile_size)
+{
+    cairo_tiled_surface_t *surface;
+
+    if (! CAIRO_FORMAT_VALID (format))
+	return _cairo_surface_create_in_error (_cairo_error (CAIRO_STATUS_INVALID_FORMAT));
+
+    if (width < 0 || width > MAX_TILED_SIZE ||
+	height < 0 || height > MAX_TILED_SIZE ||
+	tile_size <= 0 || tile_size > 32767)
+    {
+	return _cairo_surface_create_in_error (_cairo_error (CAIRO_STATUS_INVALID_SIZE));
+    }
+
+    surface = _cairo_malloc (sizeof (cairo_tiled_surface_t));
+    if (unlikely (surface == NULL))
+	return _cairo_surface_create_in_error (_cairo_error (CAIRO_STATUS_NO_MEMORY));
+
+    surface->tiles = _cairo_hash_table_create (_cairo_tile_equal);
+    if (unlikely (surface->tiles == NULL)) {
+	free (surface);
+	return _cairo_surface_create_in_error (_cairo_error (CAIRO_STATUS_NO_MEMORY));
+    }
+
+    _cairo_surface_init (&surface->base,
+			 &_cairo_tiled_surface_backend,
+			 NULL, /* device */
+			 _cairo_content_from_format (format),
+			 FALSE); /* is_vector */
+
+    surface->format = format;
+    surface->width = width;
+    surface->height = height;
+    surface->tile_size = tile_size;
+    surface->num_cols = (width + tile_size - 1) / tile_size;
+    surface->num_rows = (height + tile_size - 1) / tile_size;
+    surface->num_tiles = 0;
+
+    surface->base.is_clear = TRUE;
+
+    return &surface->base;
+}
+
+/**
+ * cairo_tiled_surface_get_tile_size:
+ * @surface: a tiled surface
+ *
+ * Get the width and height of the tiles of a tiled surface.
+ *
+ * Return value: the tile size, in pixels, or 0 if @surface is not
+ * a tiled surface.
+ *
+ * Since: 1.18
+ **/
+int
+cairo_tiled_surface_get_tile_size (cairo_surface_t *surface)
+{
+    if (! _cairo_surface_is_tiled (surface)) {
+	_cairo_error_throw (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+	return 0;
+    }
+
+    return ((cairo_tiled_surface_t *) surface)->tile_size;
+}
+
+/**
+ * cairo_tiled_surface_get_num_tiles:
+ * @surface: a tiled surface
+ *
+ * Get the number of tiles of a tiled surface that have been allocated
+ * so far. Multiplied by the size of a tile, this bounds the memory
+ * used by the surface's pixels.
+ *
+ * Return value: the number of allocated tiles, or 0 if @surface is not
+ * a tiled surface.
+ *
+ * Since: 1.18
+ **/
+int
+cairo_tiled_surface_get_num_tiles (cairo_surface_t *surface)
+{
+    if (! _cairo_surface_is_tiled (surface)) {
+	_cairo_error_throw (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+	return 0;
+    }
+
+    return ((cairo_tiled_surface_t *) surface)->num_tiles;
+}
+
+/**
+ * cairo_tiled_surface_foreach_tile:
+ * @surface: a tiled surface
+ * @area: the area of interest, or %NULL for the whole surface
+ * @func: the function to call for each tile
+ * @closure: user data passed to @func
+ *
+ * Calls @func for each allocated tile of @surface that intersects
+ * @area, in rows from top to bottom and from left to right within a
+ * row. Tiles that have never been drawn onto are skipped; their
+ * contents are all 0.
+ *
+ * Each tile is passed as an image surface together with the position
+ * of its top-left corner within @surface. The tile belongs to
+ * @surface and must not be destroyed, but its pixels may be read,
+ * or modified provided cairo_surface_mark_dirty() is called on the
+ * tile afterwards.
+ *
+ * If @func returns a status other than %CAIRO_STATUS_SUCCESS, the
+ * iteration stops and that status is returned.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS, the status returned by @func,
+ * or the error status of @surface.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_tiled_surface_foreach_tile (cairo_surface_t		   *surface,
+				  const cairo_rectangle_int_t	   *area,
+				  cairo_tiled_surface_tile_func_t   func,
+				  void				   *closure)
+{
+    cairo_tiled_surface_t *tiled;
+    cairo_rectangle_int_t extents, range;
+    cairo_status_t status;
+    int col, row;
+
+    if (unlikely (surface->status))
+	return surface->status;
+    if (unlikely (surface->finished))
+	return _cairo_error (CAIRO_STATUS_SURFACE_FINISHED);
+
+    if (! _cairo_surface_is_tiled (surface))
+	return _cairo_error (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+
+    tiled = (cairo_tiled_surface_t *) surface;
+    _cairo_tiled_surface_get_extents (tiled, &extents);
+    if (area != NULL && ! _cairo_rectangle_intersect (&extents, area))
+	return CAIRO_STATUS_SUCCESS;
+
+    if (tiled->num_tiles == 0)
+	return CAIRO_STATUS_SUCCESS;
+
+    _cairo_tiled_surface_tile_range (tiled, &extents, &range);
+    if (! _cairo_rectangle_intersect (&range, &tiled->allocated))
+	return CAIRO_STATUS_SUCCESS;
+
+    for (row = range.y; row < range.y + range.height; row++) {
+	for (col = range.x; col < range.x + range.width; col++) {
+	    cairo_tile_t *tile;
+
+	    tile = _cairo_tiled_surface_lookup (tiled, col, row);
+	    if (tile == NULL)
+		continue;
+
+	    status = func (closure, tile->image,
+			   col * tiled->tile_size,
+			   row * tiled->tile_size);
+	    if (status)
+		return status;
+	}
+    }
+
+    return CAIRO_STATUS_SUCCESS;
+}
@@ -302,6 +302,11 @@ struct pool {
     /* The default capacity of a chunk. */
     size_t default_capacity;
 
+    /* The most chunk memory in use at once since the pool was last
+     * trimmed, and the amount of free chunks kept by pool_trim(). */
+    size_t high_water;
+    size_t keep;
+
     /* Header for the sentinel chunk.  Directly following the pool
      * struct should be some space for embedded elements from which
      * the sentinel chunk allocates from. This is expressed as a char
@@ -361,6 +366,7 @@ struct polygon {
      * it is added to the polygon. */
     struct edge **y_buckets;
     struct edge *y_buckets_embedded[64];
+    unsigned num_y_buckets, size_y_buckets, keep_y_buckets;
 
     struct {
 	struct pool base[1];
@@ -460,6 +466,7 @@ struct glitter_scan_converter {
 
     cairo_half_open_span_t *spans;
     cairo_half_open_span_t spans_embedded[64];
+    int num_spans, size_spans, keep_spans;
 
     /* Clip box. */
     grid_scaled_x_t xmin, xmax;
@@ -500,6 +507,8 @@ pool_init(struct pool *pool,
     pool->current = (void*) pool->sentinel;
     pool->first_free = NULL;
     pool->default_capacity = default_capacity;
+    pool->high_water = 0;
+    pool->keep = 0;
     _pool_chunk_init(pool->current, NULL, embedded_capacity);
 }
 
@@ -582,17 +591,49 @@ pool_reset (struct pool *pool)
     /* Transfer all used chunks to the chunk free list. */
     struct _pool_chunk *chunk = pool->current;
     if (chunk != (void *) pool->sentinel) {
+	size_t used = chunk->capacity;
 	while (chunk->prev_chunk != (void *) pool->sentinel) {
 	    chunk = chunk->prev_chunk;
+	    used += chunk->capacity;
 	}
 	chunk->prev_chunk = pool->first_free;
 	pool->first_free = pool->current;
+	if (used > pool->high_water)
+	    pool->high_water = used;
     }
     /* Reset the sentinel as the current chunk. */
     pool->current = (void *) pool->sentinel;
     pool->current->size = 0;
 }
 
+/* Relinquish all memory back to the pool, then free the chunks beyond
+ * what recent uses needed.  The amount kept follows the high-water
+ * mark, decaying by a quarter every time the pool needed less. */
+static void
+pool_trim (struct pool *pool)
+{
+    struct _pool_chunk *chunk, **prev;
+    size_t kept = 0;
+
+    pool_reset (pool);
+
+    pool->keep -= pool->keep / 4;
+    if (pool->high_water > pool->keep)
+	pool->keep = pool->high_water;
+    pool->high_water = 0;
+
+    prev = &pool->first_free;
+    while ((chunk = *prev) != NULL) {
+	if (kept + chunk->capacity <= pool->keep) {
+	    kept += chunk->capacity;
+	    prev = &chunk->prev_chunk;
+	} else {
+	    *prev = chunk->prev_chunk;
+	    free (chunk);
+	}
+    }
+}
+
 /* Rewinds the cell list's cursor to the beginning.  After rewinding
  * we're good to cell_list_find() the cell any x coordinate. */
 inline static void
@@ -934,6 +975,9 @@ polygon_init (struct polygon *polygon, jmp_buf *jmp)
 {
     polygon->ymin = polygon->ymax = 0;
     polygon->y_buckets = polygon->y_buckets_embedded;
+    polygon->num_y_buckets = 0;
+    polygon->size_y_buckets = ARRAY_LENGTH (polygon->y_buckets_embedded);
+    polygon->keep_y_buckets = 0;
     pool_init (polygon->edge_pool.base, jmp,
 	       8192 - sizeof (struct _pool_chunk),
 	       sizeof (polygon->edge_pool.embedded));
@@ -948,6 +992,26 @@ polygon_fini (struct polygon *polygon)
     pool_fini (polygon->edge_pool.base);
 }
 
+/* Releases the memory the following fills are unlikely to need. */
+static void
+polygon_trim (struct polygon *polygon)
+{
+    polygon->keep_y_buckets -= polygon->keep_y_buckets / 4;
+    if (polygon->num_y_buckets > polygon->keep_y_buckets)
+	polygon->keep_y_buckets = polygon->num_y_buckets;
+
+    if (polygon->size_y_buckets > polygon->keep_y_buckets &&
+	polygon->y_buckets != polygon->y_buckets_embedded)
+    {
+	free (polygon->y_buckets);
+	polygon->y_buckets = polygon->y_buckets_embedded;
+	polygon->size_y_buckets = ARRAY_LENGTH (polygon->y_buckets_embedded);
+    }
+    polygon->num_y_buckets = 0;
+
+    pool_trim (polygon->edge_pool.base);
+}
+
 /* Empties the polygon of all edges. The polygon is then prepared to
  * receive new edges and clip them to the vertical range
  * [ymin,ymax). */
@@ -964,16 +1028,20 @@ polygon_reset (struct polygon *polygon,
     if (unlikely (h > 0x7FFFFFFFU - GRID_Y))
 	goto bail_no_mem; /* even if you could, you wouldn't want to. */
 
-    if (polygon->y_buckets != polygon->y_buckets_embedded)
-	free (polygon->y_buckets);
+    if (num_buckets > polygon->size_y_buckets) {
+	if (polygon->y_buckets != polygon->y_buckets_embedded)
+	    free (polygon->y_buckets);
 
-    polygon->y_buckets =  polygon->y_buckets_embedded;
-    if (num_buckets > ARRAY_LENGTH (polygon->y_buckets_embedded)) {
 	polygon->y_buckets = _cairo_malloc_ab (num_buckets,
 					       sizeof (struct edge *));
-	if (unlikely (NULL == polygon->y_buckets))
+	if (unlikely (NULL == polygon->y_buckets)) {
+	    polygon->y_buckets = polygon->y_buckets_embedded;
+	    polygon->size_y_buckets = ARRAY_LENGTH (polygon->y_buckets_embedded);
 	    goto bail_no_mem;
+	}
+	polygon->size_y_buckets = num_buckets;
     }
+    polygon->num_y_buckets = num_buckets;
     memset (polygon->y_buckets, 0, num_buckets * sizeof (struct edge *));
 
     polygon->ymin = ymin;
@@ -1357,6 +1425,10 @@ _glitter_scan_converter_init(glitter_scan_converter_t *converter, jmp_buf *jmp)
     polygon_init(converter->polygon, jmp);
     active_list_init(converter->active);
     cell_list_init(converter->coverages, jmp);
+    converter->spans = converter->spans_embedded;
+    converter->num_spans = 0;
+    converter->size_spans = ARRAY_LENGTH (converter->spans_embedded);
+    converter->keep_spans = 0;
     converter->xmin=0;
     converter->ymin=0;
     converter->xmax=0;
@@ -1378,6 +1450,28 @@ _glitter_scan_converter_fini(glitter_scan_converter_t *self)
     self->ymax=0;
 }
 
+/* Prepares a converter that has been used for reuse by a later fill,
+ * keeping the memory that recent fills needed. */
+static void
+_glitter_scan_converter_trim(glitter_scan_converter_t *self)
+{
+    self->keep_spans -= self->keep_spans / 4;
+    if (self->num_spans > self->keep_spans)
+	self->keep_spans = self->num_spans;
+
+    if (self->size_spans > self->keep_spans &&
+	self->spans != self->spans_embedded)
+    {
+	free (self->spans);
+	self->spans = self->spans_embedded;
+	self->size_spans = ARRAY_LENGTH (self->spans_embedded);
+    }
+    self->num_spans = 0;
+
+    polygon_trim(self->polygon);
+    pool_trim(self->coverages->cell_pool.base);
+}
+
 static grid_scaled_t
 int_to_grid_scaled(int i, int scale)
 {
@@ -1410,13 +1504,20 @@ glitter_scan_converter_reset(
 
     max_num_spans = xmax - xmin + 1;
 
-    if (max_num_spans > ARRAY_LENGTH(converter->spans_embedded)) {
+    if (max_num_spans > converter->size_spans) {
+	if (converter->spans != converter->spans_embedded)
+	    free (converter->spans);
+
 	converter->spans = _cairo_malloc_ab (max_num_spans,
 					     sizeof (cairo_half_open_span_t));
-	if (unlikely (converter->spans == NULL))
+	if (unlikely (converter->spans == NULL)) {
+	    converter->spans = converter->spans_embedded;
+	    converter->size_spans = ARRAY_LENGTH (converter->spans_embedded);
 	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
-    } else
-	converter->spans = converter->spans_embedded;
+	}
+	converter->size_spans = max_num_spans;
+    }
+    converter->num_spans = max_num_spans;
 
     xmin = int_to_grid_scaled_x(xmin);
     ymin = int_to_grid_scaled_y(ymin);
@@ -1814,6 +1915,8 @@ struct _cairo_tor_scan_converter {
 
 typedef struct _cairo_tor_scan_converter cairo_tor_scan_converter_t;
 
+static cairo_scan_converter_stash_t converter_stash;
+
 static void
 _cairo_tor_scan_converter_destroy (void *converter)
 {
@@ -1821,10 +1924,28 @@ _cairo_tor_scan_converter_destroy (void *converter)
     if (self == NULL) {
 	return;
     }
+
+    if (self->base.status == CAIRO_STATUS_SUCCESS) {
+	_glitter_scan_converter_trim (self->converter);
+	if (_cairo_scan_converter_stash_put (&converter_stash, self))
+	    return;
+    }
+
     _glitter_scan_converter_fini (self->converter);
     free(self);
 }
 
+void
+_cairo_tor_scan_converter_reset_static_data (void)
+{
+    cairo_tor_scan_converter_t *self;
+
+    while ((self = _cairo_scan_converter_stash_get (&converter_stash))) {
+	_glitter_scan_converter_fini (self->converter);
+	free (self);
+    }
+}
+
 cairo_status_t
 _cairo_tor_scan_converter_add_polygon (void		*converter,
 				       const cairo_polygon_t *polygon)
@@ -1872,16 +1993,22 @@ _cairo_tor_scan_converter_create (int			xmin,
     cairo_tor_scan_converter_t *self;
     cairo_status_t status;
 
-    self = _cairo_malloc (sizeof(struct _cairo_tor_scan_converter));
-    if (unlikely (self == NULL)) {
-	status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
-	goto bail_nomem;
+    /* Reuse the workspace of a previous fill when one is available */
+    self = _cairo_scan_converter_stash_get (&converter_stash);
+    if (self == NULL) {
+	self = _cairo_malloc (sizeof(struct _cairo_tor_scan_converter));
+	if (unlikely (self == NULL)) {
+	    status = _cairo_error (CAIRO_STATUS_NO_MEMORY);
+	    goto bail_nomem;
+	}
+
+	_glitter_scan_converter_init (self->converter, &self->jmp);
     }
 
     self->base.destroy = _cairo_tor_scan_converter_destroy;
     self->base.generate = _cairo_tor_scan_converter_generate;
+    self->base.status = CAIRO_STATUS_SUCCESS;
 
-    _glitter_scan_converter_init (self->converter, &self->jmp);
     status = glitter_scan_converter_reset (self->converter,
 					   xmin, ymin, xmax, ymax);
     if (unlikely (status))
@@ -1893,6 +2020,7 @@ _cairo_tor_scan_converter_create (int			xmin,
     return &self->base;
 
  bail:
+    self->base.status = status;
     self->base.destroy(&self->base);
  bail_nomem:
     return _cairo_scan_converter_create_in_error (status);
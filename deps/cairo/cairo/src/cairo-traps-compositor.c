@@ -2188,7 +2188,10 @@ _cairo_traps_compositor_stroke (const cairo_compositor_t *_compositor,
 	composite_traps_info_t info;
 	unsigned flags;
 
-	if (antialias == CAIRO_ANTIALIAS_BEST || antialias == CAIRO_ANTIALIAS_GOOD) {
+	if (antialias == CAIRO_ANTIALIAS_BEST ||
+	    antialias == CAIRO_ANTIALIAS_GOOD ||
+	    antialias == CAIRO_ANTIALIAS_ADAPTIVE)
+	{
 	    func = _cairo_path_fixed_stroke_polygon_to_traps;
 	    flags = 0;
 	} else {
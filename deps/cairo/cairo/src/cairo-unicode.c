@@ -43,6 +43,10 @@
 #include "cairoint.h"
 #include "cairo-error-private.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define UTF8_COMPUTE(Char, Mask, Len)					      \
   if (Char < 128)							      \
     {									      \
@@ -194,6 +198,81 @@ _utf8_get_char_extended (const unsigned char *p,
     return wc;
 }
 
+/* Returns the number of leading bytes of @p, up to @max_len, that
+ * are ASCII characters other than nul.  Text is overwhelmingly ASCII,
+ * so the decoders below skip over such runs a vector (or a word) at a
+ * time and only fall back to the per character code at the first
+ * multibyte sequence or nul.
+ */
+static long
+_utf8_ascii_run (const unsigned char *p,
+		 long		      max_len)
+{
+    long n = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+
+    /* A byte ends the run if its top bit is set, or if it is nul. */
+    while (max_len - n >= 32) {
+	__m128i a = _mm_loadu_si128 ((const __m128i *) (p + n));
+	__m128i b = _mm_loadu_si128 ((const __m128i *) (p + n + 16));
+	__m128i stop = _mm_or_si128 (_mm_or_si128 (a, _mm_cmpeq_epi8 (a, zero)),
+				     _mm_or_si128 (b, _mm_cmpeq_epi8 (b, zero)));
+	if (_mm_movemask_epi8 (stop))
+	    break;
+	n += 32;
+    }
+    if (max_len - n >= 16) {
+	__m128i a = _mm_loadu_si128 ((const __m128i *) (p + n));
+	if (_mm_movemask_epi8 (_mm_or_si128 (a, _mm_cmpeq_epi8 (a, zero))) == 0)
+	    n += 16;
+    }
+#else
+    /* (w | (w - 0x01..)) has the top bit of a byte set if that byte
+     * has it set, or if it is zero (a borrow only propagates past
+     * bytes that are zero or already have their top bit set). */
+    while (max_len - n >= 8) {
+	uint64_t w;
+
+	memcpy (&w, p + n, sizeof (w));
+	if ((w | (w - 0x0101010101010101ULL)) & 0x8080808080808080ULL)
+	    break;
+	n += 8;
+    }
+#endif
+
+    while (n < max_len && (unsigned char) (p[n] - 1) < 0x7f)
+	n++;
+
+    return n;
+}
+
+/* Widens @n ASCII bytes from @p into UCS-4 at @out. */
+static void
+_utf8_widen_ascii (const unsigned char *p,
+		   long			n,
+		   uint32_t	       *out)
+{
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+
+    for (; n >= 16; n -= 16, p += 16, out += 16) {
+	__m128i v = _mm_loadu_si128 ((const __m128i *) p);
+	__m128i lo = _mm_unpacklo_epi8 (v, zero);
+	__m128i hi = _mm_unpackhi_epi8 (v, zero);
+
+	_mm_storeu_si128 ((__m128i *) (out +  0), _mm_unpacklo_epi16 (lo, zero));
+	_mm_storeu_si128 ((__m128i *) (out +  4), _mm_unpackhi_epi16 (lo, zero));
+	_mm_storeu_si128 ((__m128i *) (out +  8), _mm_unpacklo_epi16 (hi, zero));
+	_mm_storeu_si128 ((__m128i *) (out + 12), _mm_unpackhi_epi16 (hi, zero));
+    }
+#endif
+
+    while (n--)
+	*out++ = *p++;
+}
+
 /**
  * _cairo_utf8_get_char_validated:
  * @p: a UTF-8 string
@@ -256,14 +335,29 @@ _cairo_utf8_to_ucs4 (const char *str,
 {
     uint32_t *str32 = NULL;
     int n_chars, i;
-    const unsigned char *in;
+    long run;
+    const unsigned char *in, *end;
     const unsigned char * const ustr = (const unsigned char *) str;
 
+    end = ustr + (len < 0 ? (long) strlen (str) : len);
+
     in = ustr;
     n_chars = 0;
-    while ((len < 0 || ustr + len - in > 0) && *in)
+    while (in < end && *in)
     {
-	uint32_t wc = _utf8_get_char_extended (in, ustr + len - in);
+	uint32_t wc;
+
+	run = _utf8_ascii_run (in, end - in);
+	if (run) {
+	    if (run >= INT_MAX - n_chars)
+		return _cairo_error (CAIRO_STATUS_INVALID_STRING);
+
+	    n_chars += run;
+	    in += run;
+	    continue;
+	}
+
+	wc = _utf8_get_char_extended (in, end - in);
 	if (wc & 0x80000000 || !UNICODE_VALID (wc))
 	    return _cairo_error (CAIRO_STATUS_INVALID_STRING);
 
@@ -280,8 +374,17 @@ _cairo_utf8_to_ucs4 (const char *str,
 	    return _cairo_error (CAIRO_STATUS_NO_MEMORY);
 
 	in = ustr;
-	for (i=0; i < n_chars; i++) {
-	    str32[i] = _utf8_get_char (in);
+	i = 0;
+	while (i < n_chars) {
+	    run = _utf8_ascii_run (in, n_chars - i);
+	    if (run) {
+		_utf8_widen_ascii (in, run, str32 + i);
+		i += run;
+		in += run;
+		continue;
+	    }
+
+	    str32[i++] = _utf8_get_char (in);
 	    in = UTF8_NEXT_CHAR (in);
 	}
 	str32[i] = 0;
@@ -400,13 +503,28 @@ _cairo_utf8_to_utf16 (const char *str,
 {
     uint16_t *str16 = NULL;
     int n16, i;
-    const unsigned char *in;
+    long run;
+    const unsigned char *in, *end;
     const unsigned char * const ustr = (const unsigned char *) str;
 
+    end = ustr + (len < 0 ? (long) strlen (str) : len);
+
     in = ustr;
     n16 = 0;
-    while ((len < 0 || ustr + len - in > 0) && *in) {
-	uint32_t wc = _utf8_get_char_extended (in, ustr + len - in);
+    while (in < end && *in) {
+	uint32_t wc;
+
+	run = _utf8_ascii_run (in, end - in);
+	if (run) {
+	    if (run >= INT_MAX - 1 - n16)
+		return _cairo_error (CAIRO_STATUS_INVALID_STRING);
+
+	    n16 += run;
+	    in += run;
+	    continue;
+	}
+
+	wc = _utf8_get_char_extended (in, end - in);
 	if (wc & 0x80000000 || !UNICODE_VALID (wc))
 	    return _cairo_error (CAIRO_STATUS_INVALID_STRING);
 
@@ -427,7 +545,16 @@ _cairo_utf8_to_utf16 (const char *str,
 
     in = ustr;
     for (i = 0; i < n16;) {
-	uint32_t wc = _utf8_get_char (in);
+	uint32_t wc;
+
+	run = _utf8_ascii_run (in, n16 - i);
+	if (run) {
+	    while (run--)
+		str16[i++] = *in++;
+	    continue;
+	}
+
+	wc = _utf8_get_char (in);
 
 	i += _cairo_ucs4_to_utf16 (wc, str16 + i);
 
@@ -308,6 +308,7 @@ _cairo_user_scaled_glyph_init_surface (cairo_user_scaled_font_t  *scaled_font,
 	    case CAIRO_ANTIALIAS_FAST:
 	    case CAIRO_ANTIALIAS_GOOD:
 	    case CAIRO_ANTIALIAS_GRAY:
+	    case CAIRO_ANTIALIAS_ADAPTIVE:
 		format = CAIRO_FORMAT_A8;
 		break;
 	    case CAIRO_ANTIALIAS_NONE:
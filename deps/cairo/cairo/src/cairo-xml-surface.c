@@ -165,6 +165,7 @@ _antialias_to_string (cairo_antialias_t antialias)
 	"FAST",         /* CAIRO_ANTIALIAS_FAST */
 	"GOOD",         /* CAIRO_ANTIALIAS_GOOD */
 	"BEST",         /* CAIRO_ANTIALIAS_BEST */
+	"ADAPTIVE",     /* CAIRO_ANTIALIAS_ADAPTIVE */
     };
     assert (antialias < ARRAY_LENGTH (names));
     return names[antialias];
@@ -43,6 +43,7 @@
 
 #include "cairo-backend-private.h"
 #include "cairo-error-private.h"
+#include "cairo-glyph-run-private.h"
 #include "cairo-path-private.h"
 #include "cairo-pattern-private.h"
 #include "cairo-surface-private.h"
@@ -602,6 +603,90 @@ cairo_get_reference_count (cairo_t *cr)
     return CAIRO_REFERENCE_COUNT_GET_VALUE (&cr->ref_count);
 }
 
+/**
+ * cairo_retarget:
+ * @cr: a #cairo_t
+ * @target: the new target surface for the context
+ *
+ * Reinitializes @cr so that it draws onto @target, as if it had just
+ * been created with cairo_create(): all saved states are discarded,
+ * the current path and clip are cleared and every other parameter is
+ * returned to its default, and any error state of @cr is cleared. The
+ * reference held on the previous target is released; user data
+ * attached to @cr is kept.
+ *
+ * Unlike destroying @cr and creating a new context, this keeps the
+ * memory allocated for the context, its saved states, its path and
+ * its solid source pattern, so a single context can be reused for
+ * many short-lived targets, such as when rasterizing glyphs one at a
+ * time.
+ *
+ * Not every context can be moved to every kind of surface. If @cr
+ * cannot be retargeted onto @target, it is left untouched and
+ * %CAIRO_STATUS_SURFACE_TYPE_MISMATCH is returned, in which case
+ * cairo_create() should be used instead. @cr is likewise left
+ * untouched if @target is in an error state or already finished.
+ *
+ * Return value: %CAIRO_STATUS_SUCCESS, the error status of @target
+ * if it cannot be drawn to, or the error status of @cr after the
+ * call.
+ *
+ * Since: 1.18
+ **/
+cairo_status_t
+cairo_retarget (cairo_t *cr, cairo_surface_t *target)
+{
+    cairo_int_status_t int_status;
+    cairo_status_t status;
+
+    if (cr == NULL || CAIRO_REFERENCE_COUNT_IS_INVALID (&cr->ref_count))
+	return cr == NULL ? CAIRO_STATUS_NULL_POINTER : cr->status;
+
+    if (unlikely (target == NULL))
+	return _cairo_error (CAIRO_STATUS_NULL_POINTER);
+    if (unlikely (target->status))
+	return target->status;
+    if (unlikely (target->finished))
+	return _cairo_error (CAIRO_STATUS_SURFACE_FINISHED);
+
+    if (cr->backend->retarget == NULL || target->backend == NULL)
+	return _cairo_error (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+
+    /* @target may be kept alive only by @cr itself (cairo_reset) */
+    cairo_surface_reference (target);
+
+    int_status = cr->backend->retarget (cr, target);
+    if (int_status == CAIRO_INT_STATUS_UNSUPPORTED) {
+	status = _cairo_error (CAIRO_STATUS_SURFACE_TYPE_MISMATCH);
+    } else {
+	status = (cairo_status_t) int_status;
+	cr->status = CAIRO_STATUS_SUCCESS;
+	if (unlikely (status))
+	    _cairo_set_error (cr, status);
+    }
+
+    cairo_surface_destroy (target);
+    return status;
+}
+
+/**
+ * cairo_reset:
+ * @cr: a #cairo_t
+ *
+ * Reinitializes @cr onto its current original target, see
+ * cairo_retarget().
+ *
+ * Since: 1.18
+ **/
+void
+cairo_reset (cairo_t *cr)
+{
+    if (cr == NULL || CAIRO_REFERENCE_COUNT_IS_INVALID (&cr->ref_count))
+	return;
+
+    cairo_retarget (cr, cr->backend->get_original_target (cr));
+}
+
 /**
  * cairo_save:
  * @cr: a #cairo_t
@@ -1837,6 +1922,46 @@ cairo_curve_to (cairo_t *cr,
 }
 slim_hidden_def (cairo_curve_to);
 
+/**
+ * cairo_quad_to:
+ * @cr: a cairo context
+ * @x1: the X coordinate of the control point
+ * @y1: the Y coordinate of the control point
+ * @x2: the X coordinate of the end of the curve
+ * @y2: the Y coordinate of the end of the curve
+ *
+ * Adds a quadratic Bézier spline to the path from the current point
+ * to position (@x2, @y2) in user-space coordinates, using (@x1, @y1)
+ * as the control point. After this call the current point will be
+ * (@x2, @y2).
+ *
+ * This describes the same curve as a cairo_curve_to() with control
+ * points two thirds of the way from each end point towards (@x1,
+ * @y1). Fills, cairo_in_fill() and cairo_copy_path_flat() flatten the
+ * quadratic directly, with no more segments than the tolerance needs;
+ * strokes and cairo_copy_path() are given the equivalent cubic.
+ *
+ * If there is no current point before the call to cairo_quad_to()
+ * this function will behave as if preceded by a call to
+ * cairo_move_to(@cr, @x1, @y1).
+ *
+ * Since: 1.18
+ **/
+void
+cairo_quad_to (cairo_t *cr,
+	       double x1, double y1,
+	       double x2, double y2)
+{
+    cairo_status_t status;
+
+    if (unlikely (cr->status))
+	return;
+
+    status = cr->backend->quad_to (cr, x1, y1, x2, y2);
+    if (unlikely (status))
+	_cairo_set_error (cr, status);
+}
+
 /**
  * cairo_arc:
  * @cr: a cairo context
@@ -3798,6 +3923,53 @@ cairo_show_text_glyphs (cairo_t			   *cr,
 	_cairo_set_error (cr, status);
 }
 
+/**
+ * cairo_show_glyph_run:
+ * @cr: a cairo context
+ * @run: a #cairo_glyph_run_t
+ * @dx: horizontal offset, in user space
+ * @dy: vertical offset, in user space
+ *
+ * A drawing operator that draws the glyphs of @run, each moved by
+ * (@dx, @dy), as cairo_show_glyphs() would.
+ *
+ * When the scaled font of @cr is the one @run was created with, and
+ * its transformation only differs from the one @run was created with
+ * by a translation, the device positions and extents cached in @run
+ * are reused. This makes redrawing the same text at different places
+ * much cheaper than calling cairo_show_glyphs() every time.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_show_glyph_run (cairo_t		*cr,
+		      cairo_glyph_run_t	*run,
+		      double		 dx,
+		      double		 dy)
+{
+    cairo_status_t status;
+
+    if (unlikely (cr->status))
+	return;
+
+    if (unlikely (run == NULL)) {
+	_cairo_set_error (cr, CAIRO_STATUS_NULL_POINTER);
+	return;
+    }
+
+    if (unlikely (run->status)) {
+	_cairo_set_error (cr, run->status);
+	return;
+    }
+
+    if (run->num_glyphs == 0)
+	return;
+
+    status = cr->backend->glyph_run (cr, run, dx, dy);
+    if (unlikely (status))
+	_cairo_set_error (cr, status);
+}
+
 /**
  * cairo_text_path:
  * @cr: a cairo context
@@ -3922,6 +4094,48 @@ cairo_glyph_path (cairo_t *cr, const cairo_glyph_t *glyphs, int num_glyphs)
 	_cairo_set_error (cr, status);
 }
 
+/**
+ * cairo_clip_glyphs:
+ * @cr: a cairo context
+ * @glyphs: array of glyphs to clip to
+ * @num_glyphs: number of glyphs to clip to
+ *
+ * Establishes a new clip region by intersecting the current clip
+ * region with the outlines of the glyphs, as cairo_show_glyphs()
+ * would draw them with the current font. The outlines are filled with
+ * %CAIRO_FILL_RULE_WINDING and the antialiasing of the font options,
+ * and the current path is left untouched.
+ *
+ * Compared to cairo_glyph_path() followed by cairo_clip(), a
+ * following cairo_paint() with a bounded operator composites the
+ * source through the cached glyph masks rather than rasterizing the
+ * outlines again.
+ *
+ * Since: 1.18
+ **/
+void
+cairo_clip_glyphs (cairo_t *cr, const cairo_glyph_t *glyphs, int num_glyphs)
+{
+    cairo_status_t status;
+
+    if (unlikely (cr->status))
+	return;
+
+    if (unlikely (num_glyphs < 0)) {
+	_cairo_set_error (cr, CAIRO_STATUS_NEGATIVE_COUNT);
+	return;
+    }
+
+    if (unlikely (glyphs == NULL && num_glyphs > 0)) {
+	_cairo_set_error (cr, CAIRO_STATUS_NULL_POINTER);
+	return;
+    }
+
+    status = cr->backend->clip_glyphs (cr, glyphs, num_glyphs);
+    if (unlikely (status))
+	_cairo_set_error (cr, status);
+}
+
 /**
  * cairo_get_operator:
  * @cr: a cairo context
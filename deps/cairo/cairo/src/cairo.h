@@ -514,6 +514,12 @@ cairo_set_user_data (cairo_t			 *cr,
 		     void			 *user_data,
 		     cairo_destroy_func_t	  destroy);
 
+cairo_public cairo_status_t
+cairo_retarget (cairo_t *cr, cairo_surface_t *target);
+
+cairo_public void
+cairo_reset (cairo_t *cr);
+
 cairo_public void
 cairo_save (cairo_t *cr);
 
@@ -690,6 +696,10 @@ cairo_set_tolerance (cairo_t *cr, double tolerance);
  * performance, since 1.12
  * @CAIRO_ANTIALIAS_BEST: Hint that the backend should render at the highest
  * quality, sacrificing speed if necessary, since 1.12
+ * @CAIRO_ANTIALIAS_ADAPTIVE: Hint that the backend should choose the
+ * quality for each shape from its size, rendering small shapes such as
+ * glyphs as with @CAIRO_ANTIALIAS_BEST and large, simple ones as with
+ * @CAIRO_ANTIALIAS_FAST, since 1.18
  *
  * Specifies the type of antialiasing to do when rendering text or shapes.
  *
@@ -704,7 +714,8 @@ cairo_set_tolerance (cairo_t *cr, double tolerance);
  * than to enable some form of antialiasing. In the case of glyph rendering,
  * @CAIRO_ANTIALIAS_FAST and @CAIRO_ANTIALIAS_GOOD will be mapped to
  * @CAIRO_ANTIALIAS_GRAY, with @CAIRO_ANTALIAS_BEST being equivalent to
- * @CAIRO_ANTIALIAS_SUBPIXEL.
+ * @CAIRO_ANTIALIAS_SUBPIXEL. @CAIRO_ANTIALIAS_ADAPTIVE only applies to
+ * shapes and is treated as @CAIRO_ANTIALIAS_GOOD for glyphs.
  *
  * The interpretation of @CAIRO_ANTIALIAS_DEFAULT is left entirely up to
  * the backend, typically this will be similar to @CAIRO_ANTIALIAS_GOOD.
@@ -722,7 +733,8 @@ typedef enum _cairo_antialias {
     /* hints */
     CAIRO_ANTIALIAS_FAST,
     CAIRO_ANTIALIAS_GOOD,
-    CAIRO_ANTIALIAS_BEST
+    CAIRO_ANTIALIAS_BEST,
+    CAIRO_ANTIALIAS_ADAPTIVE
 } cairo_antialias_t;
 
 cairo_public void
@@ -874,6 +886,11 @@ cairo_curve_to (cairo_t *cr,
 		double x2, double y2,
 		double x3, double y3);
 
+cairo_public void
+cairo_quad_to (cairo_t *cr,
+	       double x1, double y1,
+	       double x2, double y2);
+
 cairo_public void
 cairo_arc (cairo_t *cr,
 	   double xc, double yc,
@@ -1553,12 +1570,49 @@ cairo_show_text_glyphs (cairo_t			   *cr,
 			int			    num_clusters,
 			cairo_text_cluster_flags_t  cluster_flags);
 
+/**
+ * cairo_glyph_run_t:
+ *
+ * A #cairo_glyph_run_t is an immutable array of glyphs prepared for
+ * drawing with a particular scaled font and transformation, see
+ * cairo_glyph_run_create() and cairo_show_glyph_run().
+ *
+ * Memory management of #cairo_glyph_run_t is done with
+ * cairo_glyph_run_reference() and cairo_glyph_run_destroy().
+ *
+ * Since: 1.18
+ **/
+typedef struct _cairo_glyph_run cairo_glyph_run_t;
+
+cairo_public cairo_glyph_run_t *
+cairo_glyph_run_create (cairo_t			*cr,
+			const cairo_glyph_t	*glyphs,
+			int			 num_glyphs);
+
+cairo_public cairo_glyph_run_t *
+cairo_glyph_run_reference (cairo_glyph_run_t *run);
+
+cairo_public void
+cairo_glyph_run_destroy (cairo_glyph_run_t *run);
+
+cairo_public cairo_status_t
+cairo_glyph_run_status (cairo_glyph_run_t *run);
+
+cairo_public void
+cairo_show_glyph_run (cairo_t		*cr,
+		      cairo_glyph_run_t	*run,
+		      double		 dx,
+		      double		 dy);
+
 cairo_public void
 cairo_text_path  (cairo_t *cr, const char *utf8);
 
 cairo_public void
 cairo_glyph_path (cairo_t *cr, const cairo_glyph_t *glyphs, int num_glyphs);
 
+cairo_public void
+cairo_clip_glyphs (cairo_t *cr, const cairo_glyph_t *glyphs, int num_glyphs);
+
 cairo_public void
 cairo_text_extents (cairo_t              *cr,
 		    const char    	 *utf8,
@@ -2468,6 +2522,8 @@ cairo_surface_status (cairo_surface_t *surface);
  * @CAIRO_SURFACE_TYPE_SUBSURFACE: The surface is a subsurface created with
  *   cairo_surface_create_for_rectangle(), since 1.10
  * @CAIRO_SURFACE_TYPE_COGL: This surface is of type Cogl, since 1.12
+ * @CAIRO_SURFACE_TYPE_TILED: The surface is a tiled surface created with
+ *   cairo_tiled_surface_create(), since 1.18
  *
  * #cairo_surface_type_t is used to describe the type of a given
  * surface. The surface types are also known as "backends" or "surface
@@ -2518,7 +2574,8 @@ typedef enum _cairo_surface_type {
     CAIRO_SURFACE_TYPE_XML,
     CAIRO_SURFACE_TYPE_SKIA,
     CAIRO_SURFACE_TYPE_SUBSURFACE,
-    CAIRO_SURFACE_TYPE_COGL
+    CAIRO_SURFACE_TYPE_COGL,
+    CAIRO_SURFACE_TYPE_TILED
 } cairo_surface_type_t;
 
 cairo_public cairo_surface_type_t
@@ -2538,6 +2595,38 @@ cairo_surface_write_to_png_stream (cairo_surface_t	*surface,
 				   cairo_write_func_t	write_func,
 				   void			*closure);
 
+/**
+ * cairo_png_encoder_t:
+ *
+ * A #cairo_png_encoder_t holds a copy of the contents of a surface
+ * and encodes it as a PNG image, possibly from other threads, see
+ * cairo_png_encoder_create().
+ *
+ * Since: 1.18
+ **/
+typedef struct _cairo_png_encoder cairo_png_encoder_t;
+
+cairo_public cairo_png_encoder_t *
+cairo_png_encoder_create (cairo_surface_t *surface);
+
+cairo_public cairo_status_t
+cairo_png_encoder_status (cairo_png_encoder_t *encoder);
+
+cairo_public int
+cairo_png_encoder_get_num_segments (cairo_png_encoder_t *encoder);
+
+cairo_public cairo_status_t
+cairo_png_encoder_encode_segment (cairo_png_encoder_t	*encoder,
+				  int			 segment);
+
+cairo_public cairo_status_t
+cairo_png_encoder_write_to_stream (cairo_png_encoder_t	*encoder,
+				   cairo_write_func_t	 write_func,
+				   void			*closure);
+
+cairo_public void
+cairo_png_encoder_destroy (cairo_png_encoder_t *encoder);
+
 #endif
 
 cairo_public void *
@@ -2698,6 +2787,14 @@ cairo_public cairo_bool_t
 cairo_recording_surface_get_extents (cairo_surface_t *surface,
 				     cairo_rectangle_t *extents);
 
+cairo_public unsigned int
+cairo_recording_surface_get_num_commands (cairo_surface_t *surface);
+
+cairo_public cairo_bool_t
+cairo_recording_surface_get_command_extents (cairo_surface_t       *surface,
+					     unsigned int           index,
+					     cairo_rectangle_int_t *extents);
+
 /* raster-source pattern (callback) functions */
 
 /**
@@ -2843,6 +2940,14 @@ cairo_raster_source_pattern_set_finish (cairo_pattern_t *pattern,
 cairo_public cairo_raster_source_finish_func_t
 cairo_raster_source_pattern_get_finish (cairo_pattern_t *pattern);
 
+cairo_public void
+cairo_raster_source_pattern_set_tile_size (cairo_pattern_t *pattern,
+					   int width, int height);
+
+cairo_public void
+cairo_raster_source_pattern_get_tile_size (cairo_pattern_t *pattern,
+					   int *width, int *height);
+
 /* Pattern creation functions */
 
 cairo_public cairo_pattern_t *
@@ -3271,6 +3376,63 @@ cairo_public cairo_status_t
 cairo_region_xor_rectangle (cairo_region_t *dst,
 			    const cairo_rectangle_int_t *rectangle);
 
+/* Recording-surface functions that depend on regions */
+
+cairo_public cairo_status_t
+cairo_recording_surface_replay_damage (cairo_surface_t      *surface,
+				       cairo_surface_t      *target,
+				       const cairo_region_t *damage);
+
+/* Tiled-surface functions */
+
+/**
+ * cairo_tiled_surface_tile_func_t:
+ * @closure: the user data passed to cairo_tiled_surface_foreach_tile()
+ * @tile: an image surface holding the pixels of the tile
+ * @x: the X position of the tile within the tiled surface
+ * @y: the Y position of the tile within the tiled surface
+ *
+ * #cairo_tiled_surface_tile_func_t is the type of function called by
+ * cairo_tiled_surface_foreach_tile() for each allocated tile.
+ *
+ * Returns: %CAIRO_STATUS_SUCCESS to continue with the next tile, or
+ * any other status to stop the iteration.
+ *
+ * Since: 1.18
+ **/
+typedef cairo_status_t (*cairo_tiled_surface_tile_func_t) (void		   *closure,
+							    cairo_surface_t *tile,
+							    int		    x,
+							    int		    y);
+
+cairo_public cairo_surface_t *
+cairo_tiled_surface_create (cairo_format_t	format,
+			    int			width,
+			    int			height,
+			    int			tile_size);
+
+cairo_public int
+cairo_tiled_surface_get_tile_size (cairo_surface_t *surface);
+
+cairo_public int
+cairo_tiled_surface_get_num_tiles (cairo_surface_t *surface);
+
+cairo_public cairo_status_t
+cairo_tiled_surface_foreach_tile (cairo_surface_t		   *surface,
+				  const cairo_rectangle_int_t	   *area,
+				  cairo_tiled_surface_tile_func_t   func,
+				  void				   *closure);
+
+/* Memory budget for cairo's global caches */
+cairo_public void
+cairo_cache_set_memory_budget (unsigned long bytes);
+
+cairo_public unsigned long
+cairo_cache_get_memory_budget (void);
+
+cairo_public unsigned long
+cairo_cache_get_memory_usage (void);
+
 /* Functions to be used while debugging (not intended for use in production code) */
 cairo_public void
 cairo_debug_reset_static_data (void);
@@ -303,6 +303,12 @@ _cairo_box_add_curve_to (cairo_box_t         *extents,
 			 const cairo_point_t *c,
 			 const cairo_point_t *d);
 
+cairo_private void
+_cairo_box_add_quad_to (cairo_box_t         *extents,
+			const cairo_point_t *a,
+			const cairo_point_t *b,
+			const cairo_point_t *c);
+
 cairo_private void
 _cairo_boxes_get_extents (const cairo_box_t *boxes,
 			  int num_boxes,
@@ -957,6 +963,9 @@ _cairo_path_fixed_create (void);
 cairo_private void
 _cairo_path_fixed_init (cairo_path_fixed_t *path);
 
+cairo_private void
+_cairo_path_fixed_reset (cairo_path_fixed_t *path);
+
 cairo_private cairo_status_t
 _cairo_path_fixed_init_copy (cairo_path_fixed_t *path,
 			     const cairo_path_fixed_t *other);
@@ -1002,6 +1011,11 @@ _cairo_path_fixed_rel_curve_to (cairo_path_fixed_t *path,
 				cairo_fixed_t dx1, cairo_fixed_t dy1,
 				cairo_fixed_t dx2, cairo_fixed_t dy2);
 
+cairo_private cairo_status_t
+_cairo_path_fixed_quad_to (cairo_path_fixed_t *path,
+			   cairo_fixed_t x1, cairo_fixed_t y1,
+			   cairo_fixed_t x2, cairo_fixed_t y2);
+
 cairo_private cairo_status_t
 _cairo_path_fixed_close_path (cairo_path_fixed_t *path);
 
@@ -1024,6 +1038,11 @@ typedef cairo_status_t
 				    const cairo_point_t *p1,
 				    const cairo_point_t *p2);
 
+typedef cairo_status_t
+(cairo_path_fixed_quad_to_func_t) (void		 *closure,
+				   const cairo_point_t *p1,
+				   const cairo_point_t *p2);
+
 typedef cairo_status_t
 (cairo_path_fixed_close_path_func_t) (void *closure);
 
@@ -1035,6 +1054,15 @@ _cairo_path_fixed_interpret (const cairo_path_fixed_t	  *path,
 		       cairo_path_fixed_close_path_func_t *close_path,
 		       void				  *closure);
 
+cairo_private cairo_status_t
+_cairo_path_fixed_interpret_quads (const cairo_path_fixed_t	  *path,
+		       cairo_path_fixed_move_to_func_t	  *move_to,
+		       cairo_path_fixed_line_to_func_t	  *line_to,
+		       cairo_path_fixed_curve_to_func_t	  *curve_to,
+		       cairo_path_fixed_quad_to_func_t	  *quad_to,
+		       cairo_path_fixed_close_path_func_t *close_path,
+		       void				  *closure);
+
 cairo_private cairo_status_t
 _cairo_path_fixed_interpret_flat (const cairo_path_fixed_t *path,
 		       cairo_path_fixed_move_to_func_t	  *move_to,
@@ -1146,14 +1174,6 @@ _cairo_path_fixed_stroke_to_tristrip (const cairo_path_fixed_t	*path,
 				      double			 tolerance,
 				      cairo_tristrip_t		 *strip);
 
-cairo_private cairo_status_t
-_cairo_path_fixed_stroke_dashed_to_polygon (const cairo_path_fixed_t	*path,
-					    const cairo_stroke_style_t	*stroke_style,
-					    const cairo_matrix_t	*ctm,
-					    const cairo_matrix_t	*ctm_inverse,
-					    double		 tolerance,
-					    cairo_polygon_t	*polygon);
-
 cairo_private cairo_int_status_t
 _cairo_path_fixed_stroke_rectilinear_to_boxes (const cairo_path_fixed_t	*path,
 					       const cairo_stroke_style_t	*stroke_style,
@@ -1240,6 +1260,13 @@ cairo_private cairo_status_t
 _cairo_scaled_font_font_extents (cairo_scaled_font_t  *scaled_font,
 				 cairo_font_extents_t *extents);
 
+cairo_private cairo_status_t
+_cairo_scaled_font_glyph_device_box (cairo_scaled_font_t	 *scaled_font,
+				     const cairo_glyph_t	 *glyphs,
+				     int			  num_glyphs,
+				     cairo_box_t		 *box,
+				     cairo_bool_t		 *overlap);
+
 cairo_private cairo_status_t
 _cairo_scaled_font_glyph_device_extents (cairo_scaled_font_t	 *scaled_font,
 					 const cairo_glyph_t	 *glyphs,
@@ -1597,16 +1624,9 @@ cairo_private cairo_bool_t
 _pixman_format_to_masks (pixman_format_code_t	 pixman_format,
 			 cairo_format_masks_t	*masks);
 
-cairo_private void
-_cairo_image_scaled_glyph_fini (cairo_scaled_font_t *scaled_font,
-				cairo_scaled_glyph_t *scaled_glyph);
-
 cairo_private void
 _cairo_image_reset_static_data (void);
 
-cairo_private void
-_cairo_image_compositor_reset_static_data (void);
-
 cairo_private cairo_surface_t *
 _cairo_image_surface_create_with_pixman_format (unsigned char		*data,
 						pixman_format_code_t	 pixman_format,
@@ -1763,6 +1783,14 @@ _cairo_spline_init (cairo_spline_t *spline,
 cairo_private cairo_status_t
 _cairo_spline_decompose (cairo_spline_t *spline, double tolerance);
 
+cairo_private cairo_status_t
+_cairo_spline_decompose_quad (cairo_spline_add_point_func_t add_point_func,
+			      void *closure,
+			      const cairo_point_t *p0,
+			      const cairo_point_t *p1,
+			      const cairo_point_t *p2,
+			      double tolerance);
+
 cairo_private cairo_status_t
 _cairo_spline_bound (cairo_spline_add_point_func_t add_point_func,
 		     void *closure,
@@ -1776,6 +1804,23 @@ _cairo_matrix_get_affine (const cairo_matrix_t *matrix,
 			  double *xy, double *yy,
 			  double *x0, double *y0);
 
+cairo_private void
+_cairo_matrix_transform_points (const cairo_matrix_t *matrix,
+				const cairo_point_double_t *src,
+				cairo_point_double_t *dst,
+				int num_points);
+
+cairo_private void
+_cairo_matrix_transform_glyphs (const cairo_matrix_t *matrix,
+				const cairo_glyph_t *src,
+				cairo_glyph_t *dst,
+				int num_glyphs);
+
+cairo_private void
+_cairo_matrix_transform_points_fixed (const cairo_matrix_t *matrix,
+				      cairo_point_t *points,
+				      int num_points);
+
 cairo_private void
 _cairo_matrix_transform_bounding_box (const cairo_matrix_t *matrix,
 				      double *x1, double *y1,
@@ -2182,6 +2227,9 @@ _cairo_debug_print_path (FILE *stream, const cairo_path_fixed_t *path);
 cairo_private void
 _cairo_debug_print_polygon (FILE *stream, cairo_polygon_t *polygon);
 
+cairo_private int
+_cairo_debug_count_fill_edges (cairo_t *cr);
+
 cairo_private void
 _cairo_debug_print_traps (FILE *file, const cairo_traps_t *traps);
 
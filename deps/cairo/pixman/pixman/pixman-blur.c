@@ -0,0 +1,232 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "pixman-private.h"
+
+/* Blurs are computed with running sums, so each pass costs the same
+ * per pixel whatever the radius.  A gaussian blur is approximated by
+ * three successive box blurs whose widths are chosen so that their
+ * combined variance matches that of the gaussian.
+ */
+
+/* Bytes of each column strip copied out by the vertical pass */
+#define BLUR_STRIP_BYTES 64
+
+static void
+blur_line (uint8_t       *dst,
+	   int            dst_step,
+	   const uint8_t *src,
+	   int            src_step,
+	   int            n,
+	   int            radius,
+	   uint32_t       mul)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < radius && i < n; ++i)
+	sum += src[i * src_step];
+
+    for (i = 0; i < n; ++i)
+    {
+	if (i + radius < n)
+	    sum += src[(i + radius) * src_step];
+
+	dst[i * dst_step] = ((uint64_t) sum * mul + (1 << 23)) >> 24;
+
+	if (i >= radius)
+	    sum -= src[(i - radius) * src_step];
+    }
+}
+
+static pixman_bool_t
+general_blur (pixman_implementation_t *imp,
+	      uint32_t *               bits,
+	      int                      stride,
+	      int                      bpp,
+	      int                      width,
+	      int                      height,
+	      int                      radius,
+	      pixman_bool_t            vertical)
+{
+    uint8_t *line = (uint8_t *) bits;
+    int byte_stride = stride * (int) sizeof (uint32_t);
+    int cpp = bpp / 8;
+    uint32_t mul = _pixman_blur_multiplier (radius);
+    uint8_t *scratch;
+    int x, y, i;
+
+    if (bpp != 8 && bpp != 32)
+	return FALSE;
+
+    if (!vertical)
+    {
+	scratch = pixman_malloc_ab (width, cpp);
+	if (!scratch)
+	    return FALSE;
+
+	for (y = 0; y < height; ++y)
+	{
+	    uint8_t *row = line + y * byte_stride;
+
+	    memcpy (scratch, row, width * cpp);
+	    for (i = 0; i < cpp; ++i)
+		blur_line (row + i, cpp, scratch + i, cpp, width, radius, mul);
+	}
+    }
+    else
+    {
+	scratch = pixman_malloc_ab (height, BLUR_STRIP_BYTES);
+	if (!scratch)
+	    return FALSE;
+
+	for (x = 0; x < width * cpp; x += BLUR_STRIP_BYTES)
+	{
+	    int w = MIN (BLUR_STRIP_BYTES, width * cpp - x);
+
+	    for (y = 0; y < height; ++y)
+		memcpy (scratch + y * BLUR_STRIP_BYTES, line + y * byte_stride + x, w);
+
+	    for (i = 0; i < w; ++i)
+	    {
+		blur_line (line + x + i, byte_stride,
+			   scratch + i, BLUR_STRIP_BYTES,
+			   height, radius, mul);
+	    }
+	}
+    }
+
+    free (scratch);
+
+    return TRUE;
+}
+
+void
+_pixman_setup_blur_functions (pixman_implementation_t *imp)
+{
+    imp->blur = general_blur;
+}
+
+/* Computes the radii of the n_boxes box blurs that approximate a
+ * gaussian with the given standard deviation.
+ */
+static void
+gaussian_box_radii (double sigma, int n_boxes, int *radii)
+{
+    double ideal = sqrt (12 * sigma * sigma / n_boxes + 1);
+    int lower = floor (ideal);
+    int m, i;
+
+    if (lower % 2 == 0)
+	lower--;
+
+    m = floor ((12 * sigma * sigma
+		- n_boxes * lower * lower - 4 * n_boxes * lower - 3 * n_boxes)
+	       / (-4 * lower - 4) + 0.5);
+
+    for (i = 0; i < n_boxes; ++i)
+	radii[i] = ((i < m ? lower : lower + 2) - 1) / 2;
+}
+
+/*
+ * Blurs a bits image in place.  Pixels outside the image are treated
+ * as transparent, so callers blurring shadows should leave a margin
+ * of the blur radius around the content.
+ *
+ * With PIXMAN_BLUR_BOX each pixel becomes the average of the
+ * (2 * radius + 1) wide box around it.  With PIXMAN_BLUR_GAUSSIAN the
+ * radius is that of a CSS blur, that is twice the standard deviation.
+ *
+ * Only 8 and 32 bpp images without accessors are supported; each
+ * channel is blurred independently, so colors should be premultiplied.
+ */
+PIXMAN_EXPORT pixman_bool_t
+pixman_image_blur (pixman_image_t *image,
+		   int             radius_x,
+		   int             radius_y,
+		   pixman_blur_t   method)
+{
+    pixman_implementation_t *imp = get_implementation ();
+    int radii_x[3], radii_y[3];
+    int n_passes, i, bpp;
+    bits_image_t *bits;
+
+    if (image->type != BITS || image->common.alpha_map)
+	return FALSE;
+
+    bits = &image->bits;
+    bpp = PIXMAN_FORMAT_BPP (bits->format);
+    if (bits->read_func || (bpp != 8 && bpp != 32))
+	return FALSE;
+
+    if (radius_x < 0 || radius_y < 0)
+	return FALSE;
+
+    radius_x = MIN (radius_x, PIXMAN_MAX_BLUR_RADIUS);
+    radius_y = MIN (radius_y, PIXMAN_MAX_BLUR_RADIUS);
+
+    switch (method)
+    {
+    case PIXMAN_BLUR_BOX:
+	n_passes = 1;
+	radii_x[0] = radius_x;
+	radii_y[0] = radius_y;
+	break;
+
+    case PIXMAN_BLUR_GAUSSIAN:
+	n_passes = 3;
+	gaussian_box_radii (radius_x / 2., n_passes, radii_x);
+	gaussian_box_radii (radius_y / 2., n_passes, radii_y);
+	break;
+
+    default:
+	return FALSE;
+    }
+
+    for (i = 0; i < n_passes; ++i)
+    {
+	if (radii_x[i] > 0 &&
+	    !_pixman_implementation_blur (imp, bits->bits, bits->rowstride, bpp,
+					  bits->width, bits->height,
+					  radii_x[i], FALSE))
+	{
+	    return FALSE;
+	}
+    }
+
+    for (i = 0; i < n_passes; ++i)
+    {
+	if (radii_y[i] > 0 &&
+	    !_pixman_implementation_blur (imp, bits->bits, bits->rowstride, bpp,
+					  bits->width, bits->height,
+					  radii_y[i], TRUE))
+	{
+	    return FALSE;
+	}
+    }
+
+    return TRUE;
+}
@@ -243,6 +243,31 @@ general_composite_rect  (pixman_implementation_t *imp,
 	free (scanline_buffer);
 }
 
+static pixman_bool_t
+general_lcd_filter (pixman_implementation_t *imp,
+		    uint8_t *                dst,
+		    const uint8_t * const *  src,
+		    int                      width,
+		    const uint8_t *          weights)
+{
+    int i;
+
+    for (i = 0; i < width; ++i)
+    {
+	uint32_t v =
+	    weights[0] * src[0][i] +
+	    weights[1] * src[1][i] +
+	    weights[2] * src[2][i] +
+	    weights[3] * src[3][i] +
+	    weights[4] * src[4][i];
+
+	v >>= 8;
+	dst[i] = v > 0xff ? 0xff : v;
+    }
+
+    return TRUE;
+}
+
 static const pixman_fast_path_t general_fast_path[] =
 {
     { PIXMAN_OP_any, PIXMAN_any, 0, PIXMAN_any,	0, PIXMAN_any, 0, general_composite_rect },
@@ -256,8 +281,10 @@ _pixman_implementation_create_general (void)
 
     _pixman_setup_combiner_functions_32 (imp);
     _pixman_setup_combiner_functions_float (imp);
+    _pixman_setup_blur_functions (imp);
 
     imp->iter_info = general_iters;
+    imp->lcd_filter = general_lcd_filter;
 
     return imp;
 }
@@ -70,6 +70,15 @@ free_glyph (glyph_t *glyph)
     free (glyph);
 }
 
+/* Glyphs made by pixman_glyph_create() are not on any MRU list */
+static void
+touch_glyph (pixman_glyph_cache_t *cache,
+	     glyph_t              *glyph)
+{
+    if (cache && glyph->mru_link.next)
+	pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
+}
+
 static unsigned int
 hash (const void *font_key, const void *glyph_key)
 {
@@ -316,6 +325,54 @@ pixman_glyph_cache_remove (pixman_glyph_cache_t  *cache,
     }
 }
 
+/* A glyph that is owned by the caller rather than by a cache.  Unlike
+ * pixman_glyph_cache_insert(), the image is referenced, not copied, so
+ * it must not be modified while the glyph exists.  Such glyphs can be
+ * composited together with cached ones, and are never evicted; they
+ * live until pixman_glyph_destroy() is called.
+ */
+PIXMAN_EXPORT const void *
+pixman_glyph_create (int             origin_x,
+		     int             origin_y,
+		     pixman_image_t *image)
+{
+    glyph_t *glyph;
+
+    return_val_if_fail (image->type == BITS, NULL);
+
+    if (!(glyph = malloc (sizeof *glyph)))
+	return NULL;
+
+    glyph->font_key = NULL;
+    glyph->glyph_key = NULL;
+    glyph->origin_x = origin_x;
+    glyph->origin_y = origin_y;
+    glyph->image = pixman_image_ref (image);
+    glyph->mru_link.next = NULL;
+    glyph->mru_link.prev = NULL;
+
+    if (PIXMAN_FORMAT_A   (glyph->image->bits.format) != 0	&&
+	PIXMAN_FORMAT_RGB (glyph->image->bits.format) != 0)
+    {
+	pixman_image_set_component_alpha (glyph->image, TRUE);
+    }
+
+    _pixman_image_validate (glyph->image);
+
+    return glyph;
+}
+
+PIXMAN_EXPORT void
+pixman_glyph_destroy (const void *glyph)
+{
+    glyph_t *g = (glyph_t *)glyph;
+
+    return_if_fail (g->mru_link.next == NULL);
+
+    pixman_image_unref (g->image);
+    free (g);
+}
+
 PIXMAN_EXPORT void
 pixman_glyph_get_extents (pixman_glyph_cache_t *cache,
 			  int                   n_glyphs,
@@ -491,7 +548,7 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 
 	    pbox++;
 	}
-	pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
+	touch_glyph (cache, glyph);
     }
 
 out:
@@ -608,7 +665,7 @@ add_glyphs (pixman_glyph_cache_t *cache,
 
 	    func (implementation, &info);
 
-	    pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
+	    touch_glyph (cache, glyph);
 	}
     }
 
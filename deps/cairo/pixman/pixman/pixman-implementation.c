@@ -285,6 +285,51 @@ _pixman_implementation_fill (pixman_implementation_t *imp,
     return FALSE;
 }
 
+pixman_bool_t
+_pixman_implementation_lcd_filter (pixman_implementation_t *imp,
+                                   uint8_t *                dst,
+                                   const uint8_t * const *  src,
+                                   int                      width,
+                                   const uint8_t *          weights)
+{
+    while (imp)
+    {
+	if (imp->lcd_filter &&
+	    ((*imp->lcd_filter) (imp, dst, src, width, weights)))
+	{
+	    return TRUE;
+	}
+
+	imp = imp->fallback;
+    }
+
+    return FALSE;
+}
+
+pixman_bool_t
+_pixman_implementation_blur (pixman_implementation_t *imp,
+                             uint32_t *               bits,
+                             int                      stride,
+                             int                      bpp,
+                             int                      width,
+                             int                      height,
+                             int                      radius,
+                             pixman_bool_t            vertical)
+{
+    while (imp)
+    {
+	if (imp->blur &&
+	    ((*imp->blur) (imp, bits, stride, bpp, width, height, radius, vertical)))
+	{
+	    return TRUE;
+	}
+
+	imp = imp->fallback;
+    }
+
+    return FALSE;
+}
+
 static uint32_t *
 get_scanline_null (pixman_iter_t *iter, const uint32_t *mask)
 {
@@ -508,9 +508,38 @@ typedef pixman_bool_t (*pixman_fill_func_t) (pixman_implementation_t *imp,
 					     int                      width,
 					     int                      height,
 					     uint32_t                 filler);
+typedef pixman_bool_t (*pixman_lcd_filter_func_t) (pixman_implementation_t *imp,
+						   uint8_t *                dst,
+						   const uint8_t * const *  src,
+						   int                      width,
+						   const uint8_t *          weights);
+
+typedef pixman_bool_t (*pixman_blur_func_t) (pixman_implementation_t *imp,
+					     uint32_t *               bits,
+					     int                      stride,
+					     int                      bpp,
+					     int                      width,
+					     int                      height,
+					     int                      radius,
+					     pixman_bool_t            vertical);
 
 void _pixman_setup_combiner_functions_32 (pixman_implementation_t *imp);
 void _pixman_setup_combiner_functions_float (pixman_implementation_t *imp);
+void _pixman_setup_blur_functions (pixman_implementation_t *imp);
+
+/* Box blurs divide by the window size by multiplying with this 8.24
+ * fixed point reciprocal; radii are clamped so that the results of
+ * (sum * multiplier + (1 << 23)) >> 24 never exceed 255.
+ */
+#define PIXMAN_MAX_BLUR_RADIUS 16383
+
+static inline uint32_t
+_pixman_blur_multiplier (int radius)
+{
+    uint32_t size = 2 * radius + 1;
+
+    return ((1 << 24) + size / 2) / size;
+}
 
 typedef struct
 {
@@ -533,6 +562,8 @@ struct pixman_implementation_t
 
     pixman_blt_func_t		blt;
     pixman_fill_func_t		fill;
+    pixman_lcd_filter_func_t	lcd_filter;
+    pixman_blur_func_t		blur;
 
     pixman_combine_32_func_t	combine_32[PIXMAN_N_OPERATORS];
     pixman_combine_32_func_t	combine_32_ca[PIXMAN_N_OPERATORS];
@@ -593,6 +624,23 @@ _pixman_implementation_fill (pixman_implementation_t *imp,
                              int                      height,
                              uint32_t                 filler);
 
+pixman_bool_t
+_pixman_implementation_lcd_filter (pixman_implementation_t *imp,
+                                   uint8_t *                dst,
+                                   const uint8_t * const *  src,
+                                   int                      width,
+                                   const uint8_t *          weights);
+
+pixman_bool_t
+_pixman_implementation_blur (pixman_implementation_t *imp,
+                             uint32_t *               bits,
+                             int                      stride,
+                             int                      bpp,
+                             int                      width,
+                             int                      height,
+                             int                      radius,
+                             pixman_bool_t            vertical);
+
 void
 _pixman_implementation_iter_init (pixman_implementation_t       *imp,
                                   pixman_iter_t                 *iter,
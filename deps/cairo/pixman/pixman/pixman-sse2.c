@@ -4690,6 +4690,220 @@ sse2_composite_add_n_8_8888 (pixman_implementation_t *imp,
     }
 }
 
+static pixman_bool_t
+sse2_lcd_filter (pixman_implementation_t *imp,
+		 uint8_t *                dst,
+		 const uint8_t * const *  src,
+		 int                      width,
+		 const uint8_t *          weights)
+{
+    __m128i xmm_weights[5];
+    __m128i xmm_zero = _mm_setzero_si128 ();
+    int i, k;
+
+    /* The sums are accumulated in 16 bits, which cannot overflow as
+     * long as the weights add up to no more than 256.  That is true of
+     * all the usual LCD filters; let the fallback handle the rest.
+     */
+    if (weights[0] + weights[1] + weights[2] + weights[3] + weights[4] > 256)
+	return FALSE;
+
+    for (k = 0; k < 5; ++k)
+	xmm_weights[k] = _mm_set1_epi16 (weights[k]);
+
+    for (i = 0; i + 16 <= width; i += 16)
+    {
+	__m128i xmm_lo = xmm_zero;
+	__m128i xmm_hi = xmm_zero;
+
+	for (k = 0; k < 5; ++k)
+	{
+	    __m128i xmm_src = load_128_unaligned ((__m128i*)(src[k] + i));
+
+	    xmm_lo = _mm_add_epi16 (
+		xmm_lo, _mm_mullo_epi16 (
+		    _mm_unpacklo_epi8 (xmm_src, xmm_zero), xmm_weights[k]));
+	    xmm_hi = _mm_add_epi16 (
+		xmm_hi, _mm_mullo_epi16 (
+		    _mm_unpackhi_epi8 (xmm_src, xmm_zero), xmm_weights[k]));
+	}
+
+	save_128_unaligned ((__m128i*)(dst + i),
+			    _mm_packus_epi16 (_mm_srli_epi16 (xmm_lo, 8),
+					      _mm_srli_epi16 (xmm_hi, 8)));
+    }
+
+    for (; i < width; ++i)
+    {
+	dst[i] = (weights[0] * src[0][i] +
+		  weights[1] * src[1][i] +
+		  weights[2] * src[2][i] +
+		  weights[3] * src[3][i] +
+		  weights[4] * src[4][i]) >> 8;
+    }
+
+    return TRUE;
+}
+
+static force_inline __m128i
+unpack_32_4x32 (uint32_t data)
+{
+    __m128i zero = _mm_setzero_si128 ();
+
+    return _mm_unpacklo_epi16 (
+	_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (data), zero), zero);
+}
+
+static force_inline uint32_t
+pack_4x32_32 (__m128i data)
+{
+    __m128i zero = _mm_setzero_si128 ();
+
+    return _mm_cvtsi128_si32 (
+	_mm_packus_epi16 (_mm_packs_epi32 (data, zero), zero));
+}
+
+/* (sum * mul + round) >> 24 on each of the four 32 bit lanes, where
+ * round holds 1 << 23 in each 64 bit lane
+ */
+static force_inline __m128i
+blur_divide_4x32 (__m128i sum, __m128i mul, __m128i round)
+{
+    __m128i even, odd;
+
+    even = _mm_add_epi64 (_mm_mul_epu32 (sum, mul), round);
+    odd = _mm_add_epi64 (_mm_mul_epu32 (_mm_srli_epi64 (sum, 32), mul), round);
+
+    return _mm_or_si128 (_mm_srli_epi64 (even, 24),
+			 _mm_slli_epi64 (_mm_srli_epi64 (odd, 24), 32));
+}
+
+#define BLUR_STRIP_PIXELS 16
+
+static pixman_bool_t
+sse2_blur (pixman_implementation_t *imp,
+	   uint32_t *               bits,
+	   int                      stride,
+	   int                      bpp,
+	   int                      width,
+	   int                      height,
+	   int                      radius,
+	   pixman_bool_t            vertical)
+{
+    __m128i xmm_mul = _mm_set1_epi32 (_pixman_blur_multiplier (radius));
+    __m128i xmm_round = _mm_set_epi32 (0, 1 << 23, 0, 1 << 23);
+    uint32_t *scratch;
+    int x, y, i;
+
+    if (bpp != 32)
+	return FALSE;
+
+    if (!vertical)
+    {
+	scratch = pixman_malloc_ab (width, sizeof (uint32_t));
+	if (!scratch)
+	    return FALSE;
+
+	for (y = 0; y < height; ++y)
+	{
+	    uint32_t *row = bits + y * stride;
+	    __m128i xmm_sum = _mm_setzero_si128 ();
+
+	    memcpy (scratch, row, width * sizeof (uint32_t));
+
+	    for (i = 0; i < radius && i < width; ++i)
+		xmm_sum = _mm_add_epi32 (xmm_sum, unpack_32_4x32 (scratch[i]));
+
+	    for (i = 0; i < width; ++i)
+	    {
+		if (i + radius < width)
+		{
+		    xmm_sum = _mm_add_epi32 (
+			xmm_sum, unpack_32_4x32 (scratch[i + radius]));
+		}
+
+		row[i] = pack_4x32_32 (
+		    blur_divide_4x32 (xmm_sum, xmm_mul, xmm_round));
+
+		if (i >= radius)
+		{
+		    xmm_sum = _mm_sub_epi32 (
+			xmm_sum, unpack_32_4x32 (scratch[i - radius]));
+		}
+	    }
+	}
+    }
+    else
+    {
+	/* Work on strips of columns so that each row of the strip fills
+	 * one cache line and all the running sums stay in registers.
+	 */
+	scratch = pixman_malloc_abc (height, BLUR_STRIP_PIXELS, sizeof (uint32_t));
+	if (!scratch)
+	    return FALSE;
+
+	for (x = 0; x < width; x += BLUR_STRIP_PIXELS)
+	{
+	    __m128i xmm_sum[BLUR_STRIP_PIXELS];
+	    int w = MIN (BLUR_STRIP_PIXELS, width - x);
+
+	    for (y = 0; y < height; ++y)
+	    {
+		memcpy (scratch + y * BLUR_STRIP_PIXELS,
+			bits + y * stride + x, w * sizeof (uint32_t));
+	    }
+
+	    for (i = 0; i < w; ++i)
+		xmm_sum[i] = _mm_setzero_si128 ();
+
+	    for (y = 0; y < radius && y < height; ++y)
+	    {
+		uint32_t *s = scratch + y * BLUR_STRIP_PIXELS;
+
+		for (i = 0; i < w; ++i)
+		    xmm_sum[i] = _mm_add_epi32 (xmm_sum[i], unpack_32_4x32 (s[i]));
+	    }
+
+	    for (y = 0; y < height; ++y)
+	    {
+		uint32_t *d = bits + y * stride + x;
+
+		if (y + radius < height)
+		{
+		    uint32_t *s = scratch + (y + radius) * BLUR_STRIP_PIXELS;
+
+		    for (i = 0; i < w; ++i)
+		    {
+			xmm_sum[i] = _mm_add_epi32 (
+			    xmm_sum[i], unpack_32_4x32 (s[i]));
+		    }
+		}
+
+		for (i = 0; i < w; ++i)
+		{
+		    d[i] = pack_4x32_32 (
+			blur_divide_4x32 (xmm_sum[i], xmm_mul, xmm_round));
+		}
+
+		if (y >= radius)
+		{
+		    uint32_t *s = scratch + (y - radius) * BLUR_STRIP_PIXELS;
+
+		    for (i = 0; i < w; ++i)
+		    {
+			xmm_sum[i] = _mm_sub_epi32 (
+			    xmm_sum[i], unpack_32_4x32 (s[i]));
+		    }
+		}
+	    }
+	}
+    }
+
+    free (scratch);
+
+    return TRUE;
+}
+
 static pixman_bool_t
 sse2_blt (pixman_implementation_t *imp,
           uint32_t *               src_bits,
@@ -6239,6 +6453,9 @@ static const pixman_fast_path_t sse2_fast_paths[] =
 
     /* PIXMAN_OP_ADD */
     PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8r8g8b8, a8r8g8b8, sse2_composite_add_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8r8g8b8, x8r8g8b8, sse2_composite_add_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8b8g8r8, a8b8g8r8, sse2_composite_add_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8b8g8r8, x8b8g8r8, sse2_composite_add_n_8888_8888_ca),
     PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, sse2_composite_add_8_8),
     PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, sse2_composite_add_8888_8888),
     PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, sse2_composite_add_8888_8888),
@@ -6521,6 +6738,8 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
 
     imp->blt = sse2_blt;
     imp->fill = sse2_fill;
+    imp->lcd_filter = sse2_lcd_filter;
+    imp->blur = sse2_blur;
 
     imp->iter_info = sse2_iters;
 
@@ -760,6 +760,103 @@ pixman_fill (uint32_t *bits,
 	get_implementation(), bits, stride, bpp, x, y, width, height, filler);
 }
 
+#define LCD_FILTER_STACK_BUFFER_LENGTH 4096
+
+/*
+ * Filters a mask with a 5-tap FIR filter, either along the rows
+ * (horizontal LCD layouts, where each pixel has been oversampled
+ * three times horizontally) or along the columns (vertical layouts).
+ *
+ * Each output sample is the weighted sum of the five samples centered
+ * on it, divided by 256 and clamped to 255, matching FreeType's LCD
+ * filters.  Samples outside the mask are treated as zero.  src_bits
+ * and dst_bits must either be identical or not overlap at all.
+ */
+PIXMAN_EXPORT pixman_bool_t
+pixman_lcd_filter (uint8_t       *dst_bits,
+		   int            dst_stride,
+		   const uint8_t *src_bits,
+		   int            src_stride,
+		   int            width,
+		   int            height,
+		   pixman_bool_t  vertical,
+		   const uint8_t  weights[5])
+{
+    pixman_implementation_t *imp = get_implementation ();
+    uint8_t stack_buffer[LCD_FILTER_STACK_BUFFER_LENGTH];
+    uint8_t *buffer = stack_buffer;
+    const uint8_t *taps[5];
+    pixman_bool_t result = TRUE;
+    int n_lines, line_length;
+    int y, k;
+
+    if (width <= 0 || height <= 0)
+	return TRUE;
+
+    /* Horizontal filtering copies each row into one zero-padded line,
+     * which takes care of the edges and of filtering in place.
+     * Vertical filtering needs a line of zeroes plus copies of the
+     * current row and the two above it, since those have already been
+     * overwritten by the time they are read when filtering in place.
+     */
+    n_lines = vertical ? 4 : 1;
+    line_length = vertical ? width : width + 4;
+    if (line_length < width)
+	return FALSE;
+
+    if (n_lines * line_length > LCD_FILTER_STACK_BUFFER_LENGTH)
+    {
+	buffer = pixman_malloc_ab (n_lines, line_length);
+	if (!buffer)
+	    return FALSE;
+    }
+
+    if (!vertical)
+    {
+	buffer[0] = buffer[1] = 0;
+	buffer[width + 2] = buffer[width + 3] = 0;
+
+	for (k = 0; k < 5; ++k)
+	    taps[k] = buffer + k;
+
+	for (y = 0; y < height && result; ++y)
+	{
+	    memcpy (buffer + 2, src_bits + y * src_stride, width);
+
+	    result = _pixman_implementation_lcd_filter (
+		imp, dst_bits + y * dst_stride, taps, width, weights);
+	}
+    }
+    else
+    {
+	const uint8_t *zero = buffer;
+	uint8_t *ring[3];
+
+	memset (buffer, 0, width);
+	for (k = 0; k < 3; ++k)
+	    ring[k] = buffer + (k + 1) * width;
+
+	for (y = 0; y < height && result; ++y)
+	{
+	    memcpy (ring[y % 3], src_bits + y * src_stride, width);
+
+	    taps[0] = y >= 2 ? ring[(y - 2) % 3] : zero;
+	    taps[1] = y >= 1 ? ring[(y - 1) % 3] : zero;
+	    taps[2] = ring[y % 3];
+	    taps[3] = y + 1 < height ? src_bits + (y + 1) * src_stride : zero;
+	    taps[4] = y + 2 < height ? src_bits + (y + 2) * src_stride : zero;
+
+	    result = _pixman_implementation_lcd_filter (
+		imp, dst_bits + y * dst_stride, taps, width, weights);
+	}
+    }
+
+    if (buffer != stack_buffer)
+	free (buffer);
+
+    return result;
+}
+
 static uint32_t
 color_to_uint32 (const pixman_color_t *color)
 {
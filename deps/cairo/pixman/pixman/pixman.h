@@ -775,6 +775,19 @@ pixman_bool_t pixman_fill               (uint32_t           *bits,
 					 int                 height,
 					 uint32_t            _xor);
 
+/* Apply a 5-tap FIR filter to an 8-bit coverage mask, such as the
+ * three-times-oversampled A8 bitmaps used for subpixel (LCD) text.
+ * Strides are in bytes; src and dst may be the same buffer.
+ */
+PIXMAN_API
+pixman_bool_t pixman_lcd_filter         (uint8_t            *dst_bits,
+					 int                 dst_stride,
+					 const uint8_t      *src_bits,
+					 int                 src_stride,
+					 int                 width,
+					 int                 height,
+					 pixman_bool_t       vertical,
+					 const uint8_t       weights[5]);
 
 PIXMAN_API
 int           pixman_version            (void);
@@ -1127,6 +1140,19 @@ pixman_bool_t   pixman_image_fill_boxes              (pixman_op_t
                                                       int                           n_boxes,
                                                       const pixman_box32_t         *boxes);
 
+typedef enum
+{
+    PIXMAN_BLUR_BOX,
+    PIXMAN_BLUR_GAUSSIAN
+} pixman_blur_t;
+
+/* Blur an 8 or 32 bpp image in place, in time independent of the radius */
+PIXMAN_API
+pixman_bool_t   pixman_image_blur                    (pixman_image_t               *image,
+                                                      int                           radius_x,
+                                                      int                           radius_y,
+                                                      pixman_blur_t                 method);
+
 /* Composite */
 PIXMAN_API
 pixman_bool_t pixman_compute_composite_region (pixman_region16_t *region,
@@ -1231,6 +1257,14 @@ void                  pixman_glyph_cache_remove       (pixman_glyph_cache_t *cac
 						       void                 *font_key,
 						       void                 *glyph_key);
 
+PIXMAN_API
+const void *          pixman_glyph_create             (int		     origin_x,
+						       int                   origin_y,
+						       pixman_image_t       *glyph_image);
+
+PIXMAN_API
+void                  pixman_glyph_destroy            (const void           *glyph);
+
 PIXMAN_API
 void                  pixman_glyph_get_extents        (pixman_glyph_cache_t *cache,
 						       int                   n_glyphs,
@@ -11,6 +11,10 @@ extern crate libc;
 #[cfg(feature = "xlib")]
 extern crate x11;
 
+// Links the libpng and zlib that cairo-png.c is built against
+#[cfg(feature = "png")]
+extern crate freetype as _;
+
 #[cfg(all(windows, feature = "win32-surface"))]
 extern crate winapi as winapi_orig;
 
@@ -109,6 +113,12 @@ opaque!(cairo_surface_t);
 opaque!(cairo_device_t);
 opaque!(cairo_pattern_t);
 
+opaque!(
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    cairo_png_encoder_t
+);
+
 opaque!(
     #[cfg(feature = "xcb")]
     #[cfg_attr(docsrs, doc(cfg(feature = "xcb")))]
@@ -187,6 +197,7 @@ pub union cairo_path_data {
 opaque!(cairo_region_t);
 opaque!(cairo_font_face_t);
 opaque!(cairo_scaled_font_t);
+opaque!(cairo_glyph_run_t);
 opaque!(cairo_font_options_t);
 
 #[repr(C)]
@@ -271,6 +282,8 @@ pub type cairo_read_func_t =
     Option<unsafe extern "C" fn(*mut c_void, *mut c_uchar, c_uint) -> cairo_status_t>;
 pub type cairo_write_func_t =
     Option<unsafe extern "C" fn(*mut c_void, *mut c_uchar, c_uint) -> cairo_status_t>;
+pub type cairo_tiled_surface_tile_func_t =
+    Option<unsafe extern "C" fn(*mut c_void, *mut cairo_surface_t, c_int, c_int) -> cairo_status_t>;
 
 #[cfg(feature = "freetype")]
 #[cfg_attr(docsrs, doc(cfg(feature = "freetype")))]
@@ -319,6 +332,8 @@ extern "C" {
     pub fn cairo_reference(cr: *mut cairo_t) -> *mut cairo_t;
     pub fn cairo_destroy(cr: *mut cairo_t);
     pub fn cairo_status(cr: *mut cairo_t) -> cairo_status_t;
+    pub fn cairo_retarget(cr: *mut cairo_t, target: *mut cairo_surface_t) -> cairo_status_t;
+    pub fn cairo_reset(cr: *mut cairo_t);
     pub fn cairo_save(cr: *mut cairo_t);
     pub fn cairo_restore(cr: *mut cairo_t);
     pub fn cairo_get_target(cr: *mut cairo_t) -> *mut cairo_surface_t;
@@ -427,6 +442,9 @@ extern "C" {
 
     // CAIRO UTILS
     pub fn cairo_status_to_string(status: cairo_status_t) -> *const c_char;
+    pub fn cairo_cache_set_memory_budget(bytes: c_ulong);
+    pub fn cairo_cache_get_memory_budget() -> c_ulong;
+    pub fn cairo_cache_get_memory_usage() -> c_ulong;
     pub fn cairo_debug_reset_static_data();
     pub fn cairo_version() -> c_int;
     pub fn cairo_version_string() -> *const c_char;
@@ -467,6 +485,7 @@ extern "C" {
         y3: c_double,
     );
     pub fn cairo_line_to(cr: *mut cairo_t, x: c_double, y: c_double);
+    pub fn cairo_quad_to(cr: *mut cairo_t, x1: c_double, y1: c_double, x2: c_double, y2: c_double);
     pub fn cairo_move_to(cr: *mut cairo_t, x: c_double, y: c_double);
     pub fn cairo_rectangle(
         cr: *mut cairo_t,
@@ -476,6 +495,7 @@ extern "C" {
         height: c_double,
     );
     pub fn cairo_glyph_path(cr: *mut cairo_t, glyphs: *const cairo_glyph_t, num_glyphs: c_int);
+    pub fn cairo_clip_glyphs(cr: *mut cairo_t, glyphs: *const cairo_glyph_t, num_glyphs: c_int);
     pub fn cairo_text_path(cr: *mut cairo_t, utf8: *const c_char);
     pub fn cairo_rel_curve_to(
         cr: *mut cairo_t,
@@ -766,6 +786,20 @@ extern "C" {
         num_clusters: c_int,
         cluster_flags: cairo_text_cluster_flags_t,
     );
+    pub fn cairo_glyph_run_create(
+        cr: *mut cairo_t,
+        glyphs: *const cairo_glyph_t,
+        num_glyphs: c_int,
+    ) -> *mut cairo_glyph_run_t;
+    pub fn cairo_glyph_run_reference(run: *mut cairo_glyph_run_t) -> *mut cairo_glyph_run_t;
+    pub fn cairo_glyph_run_destroy(run: *mut cairo_glyph_run_t);
+    pub fn cairo_glyph_run_status(run: *mut cairo_glyph_run_t) -> cairo_status_t;
+    pub fn cairo_show_glyph_run(
+        cr: *mut cairo_t,
+        run: *mut cairo_glyph_run_t,
+        dx: c_double,
+        dy: c_double,
+    );
     pub fn cairo_font_extents(cr: *mut cairo_t, extents: *mut cairo_font_extents_t);
     pub fn cairo_text_extents(
         cr: *mut cairo_t,
@@ -1130,6 +1164,31 @@ extern "C" {
         width: *mut c_double,
         height: *mut c_double,
     );
+    pub fn cairo_recording_surface_replay_damage(
+        surface: *mut cairo_surface_t,
+        target: *mut cairo_surface_t,
+        damage: *const cairo_region_t,
+    ) -> cairo_status_t;
+    pub fn cairo_recording_surface_get_num_commands(surface: *mut cairo_surface_t) -> c_uint;
+    pub fn cairo_recording_surface_get_command_extents(
+        surface: *mut cairo_surface_t,
+        index: c_uint,
+        extents: *mut cairo_rectangle_int_t,
+    ) -> cairo_bool_t;
+    pub fn cairo_tiled_surface_create(
+        format: cairo_format_t,
+        width: c_int,
+        height: c_int,
+        tile_size: c_int,
+    ) -> *mut cairo_surface_t;
+    pub fn cairo_tiled_surface_get_tile_size(surface: *mut cairo_surface_t) -> c_int;
+    pub fn cairo_tiled_surface_get_num_tiles(surface: *mut cairo_surface_t) -> c_int;
+    pub fn cairo_tiled_surface_foreach_tile(
+        surface: *mut cairo_surface_t,
+        area: *const cairo_rectangle_int_t,
+        func: cairo_tiled_surface_tile_func_t,
+        closure: *mut c_void,
+    ) -> cairo_status_t;
     pub fn cairo_surface_create_similar_image(
         other: *mut cairo_surface_t,
         format: cairo_format_t,
@@ -1174,6 +1233,31 @@ extern "C" {
         write_func: cairo_write_func_t,
         closure: *mut c_void,
     ) -> cairo_status_t;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_create(surface: *mut cairo_surface_t) -> *mut cairo_png_encoder_t;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_status(encoder: *mut cairo_png_encoder_t) -> cairo_status_t;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_get_num_segments(encoder: *mut cairo_png_encoder_t) -> c_int;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_encode_segment(
+        encoder: *mut cairo_png_encoder_t,
+        segment: c_int,
+    ) -> cairo_status_t;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_write_to_stream(
+        encoder: *mut cairo_png_encoder_t,
+        write_func: cairo_write_func_t,
+        closure: *mut c_void,
+    ) -> cairo_status_t;
+    #[cfg(feature = "png")]
+    #[cfg_attr(docsrs, doc(cfg(feature = "png")))]
+    pub fn cairo_png_encoder_destroy(encoder: *mut cairo_png_encoder_t);
 
     // CAIRO PDF
     #[cfg(feature = "pdf")]
@@ -1690,6 +1774,7 @@ pub const ANTIALIAS_SUBPIXEL: i32 = 3;
 pub const ANTIALIAS_FAST: i32 = 4;
 pub const ANTIALIAS_GOOD: i32 = 5;
 pub const ANTIALIAS_BEST: i32 = 6;
+pub const ANTIALIAS_ADAPTIVE: i32 = 7;
 pub const FILL_RULE_WINDING: i32 = 0;
 pub const FILL_RULE_EVEN_ODD: i32 = 1;
 pub const LINE_CAP_BUTT: i32 = 0;
@@ -1801,6 +1886,7 @@ pub const SURFACE_TYPE_XML: i32 = 21;
 pub const SURFACE_TYPE_SKIA: i32 = 22;
 pub const SURFACE_TYPE_SUBSURFACE: i32 = 23;
 pub const SURFACE_TYPE_COGL: i32 = 24;
+pub const SURFACE_TYPE_TILED: i32 = 25;
 pub const SVG_UNIT_USER: i32 = 0;
 pub const SVG_UNIT_EM: i32 = 1;
 pub const SVG_UNIT_EX: i32 = 2;
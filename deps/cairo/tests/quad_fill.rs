@@ -0,0 +1,78 @@
+//! Checks that fills flatten quadratic segments directly, with the
+//! number of segments the tolerance calls for, instead of elevating
+//! them to cubics and subdividing those.
+
+use cairo_sys::*;
+use std::os::raw::c_int;
+
+extern "C" {
+    fn _cairo_debug_count_fill_edges(cr: *mut cairo_t) -> c_int;
+}
+
+/// The number of line segments a quadratic needs for `tolerance`: the
+/// distance between the curve and n uniform chords is at most
+/// |p0 - 2 p1 + p2| / (4 n^2).
+fn quad_segments(p0: (f64, f64), p1: (f64, f64), p2: (f64, f64), tolerance: f64) -> c_int {
+    let ddx = p0.0 - 2. * p1.0 + p2.0;
+    let ddy = p0.1 - 2. * p1.1 + p2.1;
+    (ddx.hypot(ddy) / (4. * tolerance)).sqrt().ceil().max(1.) as c_int
+}
+
+unsafe fn count_flat_lines(cr: *mut cairo_t) -> c_int {
+    let path = cairo_copy_path_flat(cr);
+    let mut lines = 0;
+    let mut i = 0;
+    while i < (*path).num_data {
+        let header = (*(*path).data.offset(i as isize)).header;
+        if header.data_type == PATH_DATA_TYPE_LINE_TO {
+            lines += 1;
+        }
+        i += header.length;
+    }
+    cairo_path_destroy(path);
+    lines
+}
+
+#[test]
+fn quad_fill_edges() {
+    unsafe {
+        let surface = cairo_image_surface_create(FORMAT_A8, 200, 200);
+        let cr = cairo_create(surface);
+
+        for &tolerance in &[0.1, 0.25, 1.] {
+            cairo_set_tolerance(cr, tolerance);
+
+            // A lopsided arch, so that none of its segments is
+            // horizontal and dropped from the polygon
+            cairo_new_path(cr);
+            cairo_move_to(cr, 0., 10.);
+            cairo_quad_to(cr, 50., 190., 100., 40.);
+            cairo_close_path(cr);
+
+            let expected = quad_segments((0., 10.), (50., 190.), (100., 40.), tolerance);
+            // one more edge closes the arch
+            assert_eq!(_cairo_debug_count_fill_edges(cr), expected + 1);
+            // copy_path_flat() uses the same flattener
+            assert_eq!(count_flat_lines(cr), expected);
+
+            // The same curve as a cubic is subdivided into at least as
+            // many segments
+            cairo_new_path(cr);
+            cairo_move_to(cr, 0., 10.);
+            cairo_curve_to(
+                cr,
+                100. / 3.,
+                130.,
+                200. / 3.,
+                140.,
+                100.,
+                40.,
+            );
+            cairo_close_path(cr);
+            assert!(_cairo_debug_count_fill_edges(cr) >= expected + 1);
+        }
+
+        cairo_destroy(cr);
+        cairo_surface_destroy(surface);
+    }
+}
@@ -0,0 +1,98 @@
+//! Checks that tiled surfaces taller than the image size limit can be
+//! used as sources and can have groups pushed onto them, which both
+//! used to need an image of the whole surface.
+
+use cairo_sys::*;
+use std::os::raw::c_int;
+
+const WIDTH: c_int = 64;
+const HEIGHT: c_int = 40000;
+const TILE_SIZE: c_int = 256;
+
+/// Reads the pixel at (x, y) of a tiled surface
+unsafe fn tiled_pixel(surface: *mut cairo_surface_t, x: c_int, y: c_int) -> u32 {
+    let area = cairo_rectangle_int_t {
+        x,
+        y,
+        width: 1,
+        height: 1,
+    };
+    let image = cairo_surface_map_to_image(surface, &area);
+    assert_eq!(cairo_surface_status(image), STATUS_SUCCESS);
+    let pixel = *(cairo_image_surface_get_data(image) as *const u32);
+    // Unmapping paints the image back; that leaves the pixel as it is
+    cairo_surface_unmap_image(surface, image);
+    pixel
+}
+
+#[test]
+fn tiled_surface_as_source() {
+    unsafe {
+        let tiled = cairo_tiled_surface_create(FORMAT_A_RGB32, WIDTH, HEIGHT, TILE_SIZE);
+        let cr = cairo_create(tiled);
+        cairo_set_source_rgb(cr, 1., 0., 0.);
+        cairo_rectangle(cr, 0., 39000., 64., 10.);
+        cairo_fill(cr);
+        cairo_destroy(cr);
+
+        // Only the sampled rows near the bottom are read from the tiles
+        let image = cairo_image_surface_create(FORMAT_A_RGB32, WIDTH, 100);
+        let cr = cairo_create(image);
+        cairo_set_source_surface(cr, tiled, 0., -38950.);
+        cairo_paint(cr);
+        assert_eq!(cairo_status(cr), STATUS_SUCCESS);
+        cairo_destroy(cr);
+
+        cairo_surface_flush(image);
+        let data = cairo_image_surface_get_data(image) as *const u32;
+        let stride = cairo_image_surface_get_stride(image) / 4;
+        assert_eq!(*data.offset((55 * stride + 10) as isize), 0xffff0000);
+        assert_eq!(*data.offset((45 * stride + 10) as isize), 0);
+
+        cairo_surface_destroy(image);
+        cairo_surface_destroy(tiled);
+    }
+}
+
+#[test]
+fn tiled_surface_groups() {
+    unsafe {
+        let tiled = cairo_tiled_surface_create(FORMAT_A_RGB32, WIDTH, HEIGHT, TILE_SIZE);
+        let cr = cairo_create(tiled);
+
+        // A clipped group is an image covering just the clip
+        cairo_rectangle(cr, 0., 100., 64., 50.);
+        cairo_clip(cr);
+        cairo_push_group(cr);
+        let group = cairo_get_group_target(cr);
+        assert_eq!(cairo_surface_get_type(group), SURFACE_TYPE_IMAGE);
+        assert_eq!(cairo_image_surface_get_height(group), 50);
+        cairo_set_source_rgb(cr, 0., 1., 0.);
+        cairo_paint(cr);
+        cairo_pop_group_to_source(cr);
+        cairo_paint(cr);
+        cairo_reset_clip(cr);
+        assert_eq!(cairo_status(cr), STATUS_SUCCESS);
+
+        // A group covering the whole canvas is too tall for an image,
+        // so it is tiled itself and painted back a region at a time
+        cairo_push_group(cr);
+        assert_eq!(
+            cairo_surface_get_type(cairo_get_group_target(cr)),
+            SURFACE_TYPE_TILED
+        );
+        cairo_set_source_rgb(cr, 0., 0., 1.);
+        cairo_rectangle(cr, 0., 39000., 64., 10.);
+        cairo_fill(cr);
+        cairo_pop_group_to_source(cr);
+        cairo_paint(cr);
+        assert_eq!(cairo_status(cr), STATUS_SUCCESS);
+        cairo_destroy(cr);
+
+        assert_eq!(tiled_pixel(tiled, 10, 120), 0xff00ff00);
+        assert_eq!(tiled_pixel(tiled, 10, 39005), 0xff0000ff);
+        assert_eq!(tiled_pixel(tiled, 10, 20000), 0);
+
+        cairo_surface_destroy(tiled);
+    }
+}
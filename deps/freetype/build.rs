@@ -107,6 +107,16 @@ fn libpng() {
     .unwrap();
 
     cfg.compile("png");
+
+    // This causes DEP_FREETYPE_PNG_INCLUDE to be defined in the
+    // cairo/build.rs, which builds cairo-png.c against this libpng
+    let cwd = env::current_dir().unwrap();
+    println!(
+        "cargo:png_include={};{};{}",
+        cwd.join("libpng").display(),
+        cwd.join("zlib").display(),
+        build_dir.display()
+    );
 }
 
 fn freetype() {
@@ -27,11 +27,15 @@ fn harfbuzz() {
     let target = env::var("TARGET").unwrap();
 
     cfg.file("harfbuzz/src/harfbuzz.cc");
-    cfg.define("HB_NO_MT", None);
 
+    // Build with thread-safe reference counting and locking, so that
+    // fonts, faces, shape plans and buffers can be used from more than
+    // one thread.  Atomics come from C++11 <atomic>; windows has its
+    // own mutex implementation.
     if !target.contains("windows") {
         cfg.define("HAVE_UNISTD_H", None);
         cfg.define("HAVE_SYS_MMAN_H", None);
+        cfg.define("HAVE_PTHREAD", None);
     }
 
     // We know that these are present in our vendored freetype
@@ -358,7 +358,10 @@ impl Font {
     }
 
     /// Perform shaping.  On entry, Buffer holds the text to shape.
-    /// Once done, Buffer holds the output glyph and position info
+    /// Once done, Buffer holds the output glyph and position info.
+    /// The shape plan comes from the cache harfbuzz keeps on the face,
+    /// keyed by segment properties, features and variation coords, so
+    /// it is only built once per combination and shared across threads.
     pub fn shape(&mut self, buf: &mut Buffer, features: &[hb_feature_t]) {
         unsafe { hb_shape(self.font, buf.buf, features.as_ptr(), features.len() as u32) }
     }
@@ -946,6 +949,10 @@ pub struct Buffer {
     buf: *mut hb_buffer_t,
 }
 
+// Buffers are not shared, but may be handed over to another thread
+// now that harfbuzz is built with its thread-safe reference counting.
+unsafe impl Send for Buffer {}
+
 impl Drop for Buffer {
     fn drop(&mut self) {
         unsafe {
@@ -991,7 +998,6 @@ impl Buffer {
     }
 
     /// Reset the buffer back to its initial post-creation state
-    #[allow(dead_code)]
     pub fn reset(&mut self) {
         unsafe {
             hb_buffer_reset(self.buf);
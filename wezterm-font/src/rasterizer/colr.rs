@@ -589,19 +589,21 @@ pub fn apply_draw_ops_to_context(ops: &[DrawOp], context: &Context) -> anyhow::R
                 to_x,
                 to_y,
             } => {
-                let (x, y) =
-                    current.ok_or_else(|| anyhow::anyhow!("QuadTo has no current position"))?;
-                // Express quadratic as a cubic
-                // <https://stackoverflow.com/a/55034115/149111>
-
-                context.curve_to(
-                    (x + (2. / 3.) * (control_x - x)).into(),
-                    (y + (2. / 3.) * (control_y - y)).into(),
-                    (to_x + (2. / 3.) * (control_x - to_x)).into(),
-                    (to_y + (2. / 3.) * (control_y - to_y)).into(),
-                    (*to_x).into(),
-                    (*to_y).into(),
-                );
+                if current.is_none() {
+                    anyhow::bail!("QuadTo has no current position");
+                }
+                // Our vendored cairo has a native quadratic segment,
+                // which fills flatten directly rather than elevating
+                // it to a cubic and subdividing that
+                unsafe {
+                    cairo::ffi::cairo_quad_to(
+                        context.to_raw_none(),
+                        (*control_x).into(),
+                        (*control_y).into(),
+                        (*to_x).into(),
+                        (*to_y).into(),
+                    );
+                }
                 current.replace((to_x, to_y));
             }
             DrawOp::CubicTo {
@@ -9,7 +9,7 @@ use crate::rasterizer::colr::{
     ColorLine, ColorStop, PaintOp,
 };
 use crate::rasterizer::harfbuzz::{argb_to_rgba, HarfbuzzRasterizer};
-use crate::rasterizer::{FontRasterizer, FAKE_ITALIC_SKEW};
+use crate::rasterizer::{FontRasterizer, ADAPTIVE_ANTIALIAS, FAKE_ITALIC_SKEW};
 use crate::units::*;
 use crate::{ftwrap, FontRasterizerSelection, RasterizedGlyph};
 use ::freetype::{
@@ -489,7 +489,7 @@ fn rasterize_from_ops(
     {
         let context = Context::new(&target)?;
         context.transform(bounds_adjust);
-        context.set_antialias(cairo::Antialias::Best);
+        context.set_antialias(ADAPTIVE_ANTIALIAS);
         context.set_source_surface(surface, 0., 0.)?;
         context.paint()?;
     }
@@ -807,7 +807,7 @@ fn record_to_cairo_surface(
     let surface = RecordingSurface::create(Content::ColorAlpha, None)?;
     let context = Context::new(&surface)?;
     context.scale(scale_x, scale_y);
-    context.set_antialias(cairo::Antialias::Best);
+    context.set_antialias(ADAPTIVE_ANTIALIAS);
 
     for pop in paint_ops {
         match pop {
@@ -5,7 +5,7 @@ use crate::hbwrap::{
 use crate::rasterizer::colr::{
     apply_draw_ops_to_context, paint_linear_gradient, paint_radial_gradient, paint_sweep_gradient,
 };
-use crate::rasterizer::FAKE_ITALIC_SKEW;
+use crate::rasterizer::{ADAPTIVE_ANTIALIAS, FAKE_ITALIC_SKEW};
 use crate::units::PixelLength;
 use crate::{FontRasterizer, ParsedFont, RasterizedGlyph};
 use cairo::{Content, Context, Format, ImageSurface, Matrix, Operator, RecordingSurface};
@@ -81,7 +81,7 @@ impl FontRasterizer for HarfbuzzRasterizer {
         {
             let context = Context::new(&target)?;
             context.transform(bounds_adjust);
-            context.set_antialias(cairo::Antialias::Best);
+            context.set_antialias(ADAPTIVE_ANTIALIAS);
             context.set_source_surface(surface, 0., 0.)?;
             context.paint()?;
         }
@@ -106,7 +106,7 @@ fn record_to_cairo_surface(paint_ops: Vec<PaintOp>) -> anyhow::Result<(Recording
     let surface = RecordingSurface::create(Content::ColorAlpha, None)?;
     let context = Context::new(&surface)?;
     context.scale(1. / 64., -1. / 64.);
-    context.set_antialias(cairo::Antialias::Best);
+    context.set_antialias(ADAPTIVE_ANTIALIAS);
 
     for pop in paint_ops {
         match pop {
@@ -7,6 +7,12 @@ use image::{ImageBuffer, Rgba};
 /// italics
 pub(crate) const FAKE_ITALIC_SKEW: f64 = 0.2;
 
+/// Lets cairo pick the antialiasing quality from the size of each shape,
+/// so glyph outlines keep the best quality while large color glyph fills
+/// use a coarser grid.  cairo-rs has no variant for this mode yet.
+pub(crate) const ADAPTIVE_ANTIALIAS: cairo::Antialias =
+    cairo::Antialias::__Unknown(cairo::ffi::ANTIALIAS_ADAPTIVE);
+
 pub mod colr;
 pub mod freetype;
 pub mod harfbuzz;
@@ -9,7 +9,8 @@ use log::error;
 use ordered_float::NotNan;
 use std::cell::{RefCell, RefMut};
 use std::collections::HashMap;
-use std::ops::Range;
+use std::ops::{Deref, DerefMut, Range};
+use std::sync::Mutex;
 use termwiz::cell::{unicode_column_width, Presentation};
 use wezterm_bidi::Direction;
 
@@ -72,6 +73,51 @@ struct FontPair {
     last_size_and_dpi: RefCell<Option<(f64, u32)>>,
 }
 
+/// Buffers that have been used for shaping, kept for reuse so that
+/// their allocations survive from one shape call to the next.
+/// This is shared by all shapers, which may live on different threads.
+static BUFFER_POOL: Mutex<Vec<harfbuzz::Buffer>> = Mutex::new(Vec::new());
+const MAX_POOLED_BUFFERS: usize = 8;
+
+/// A buffer taken from BUFFER_POOL, which is reset and returned
+/// to the pool when dropped
+struct PooledBuffer(Option<harfbuzz::Buffer>);
+
+impl PooledBuffer {
+    fn new() -> anyhow::Result<Self> {
+        let buf = BUFFER_POOL.lock().unwrap().pop();
+        match buf {
+            Some(buf) => Ok(Self(Some(buf))),
+            None => Ok(Self(Some(harfbuzz::Buffer::new()?))),
+        }
+    }
+}
+
+impl Deref for PooledBuffer {
+    type Target = harfbuzz::Buffer;
+    fn deref(&self) -> &harfbuzz::Buffer {
+        self.0.as_ref().unwrap()
+    }
+}
+
+impl DerefMut for PooledBuffer {
+    fn deref_mut(&mut self) -> &mut harfbuzz::Buffer {
+        self.0.as_mut().unwrap()
+    }
+}
+
+impl Drop for PooledBuffer {
+    fn drop(&mut self) {
+        if let Some(mut buf) = self.0.take() {
+            buf.reset();
+            let mut pool = BUFFER_POOL.lock().unwrap();
+            if pool.len() < MAX_POOLED_BUFFERS {
+                pool.push(buf);
+            }
+        }
+    }
+}
+
 #[derive(Debug, Hash, PartialEq, Eq, Clone)]
 struct MetricsKey {
     font_idx: usize,
@@ -214,7 +260,7 @@ impl HarfbuzzShaper {
         range: Range<usize>,
         presentation_width: Option<&PresentationWidth>,
     ) -> anyhow::Result<Vec<GlyphInfo>> {
-        let mut buf = harfbuzz::Buffer::new()?;
+        let mut buf = PooledBuffer::new()?;
         // We deliberately omit setting the script and leave it to harfbuzz
         // to infer from the buffer contents so that it can correctly
         // enable appropriate preprocessing for eg: Hangul.